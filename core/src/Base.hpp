@@ -217,12 +217,12 @@ namespace ngrt4n {
 
   const std::string CHILD_SEP = ",";
   const QString CHILD_Q_SEP = QString::fromStdString(CHILD_SEP);
-  const std::string TAG_ZABBIX_HOSTNAME  = "\\{HOSTNAME\\}";
-  const std::string TAG_ZABBIX_HOSTNAME2 = "\\{HOST.NAME\\}";
-  const std::string TAG_HOSTNAME   = "\\{hostname\\}";
-  const std::string TAG_CHECK      = "\\{check_name\\}";
-  const std::string TAG_THERESHOLD = "\\{threshold\\}";
-  const std::string TAG_PLUGIN_OUTPUT = "\\{plugin_output\\}";
+  const QString TAG_ZABBIX_HOSTNAME  = "{HOSTNAME}";
+  const QString TAG_ZABBIX_HOSTNAME2 = "{HOST.NAME}";
+  const QString TAG_HOSTNAME   = "{hostname}";
+  const QString TAG_CHECK      = "{check_name}";
+  const QString TAG_THERESHOLD = "{threshold}";
+  const QString TAG_PLUGIN_OUTPUT = "{plugin_output}";
   const double WEIGHT_UNIT = 1.0;
   const double WEIGHT_MIN  = 0;
   const double WEIGHT_MAX  = 10;
@@ -314,6 +314,26 @@ struct ThresholdLessthanFnt {
 };
 
 
+/** holds a message split into literal text and tags, so that it can be rendered without regular expressions */
+struct MessageTemplateT {
+  enum TagT {
+    Literal = 0,
+    Hostname = 1,
+    CheckName = 2,
+    Threshold = 3,
+    ZabbixHostname = 4,
+    TagCount = 5
+  };
+  struct SegmentT {
+    int tag;
+    QString text;
+  };
+  QString source;
+  QVector<SegmentT> segments;
+  bool compiled = false;
+};
+
+
 struct NodeT {
   QString id;
   QString name;
@@ -328,6 +348,10 @@ struct NodeT {
   QString alarm_msg;
   QString notification_msg;
   QString actual_msg;
+  MessageTemplateT alarm_msg_tpl;
+  MessageTemplateT notification_msg_tpl;
+  CheckT rendered_check;
+  bool rendered_msg = false;
   double weight;
   QString child_nodes;
   CheckT check;
@@ -346,6 +370,7 @@ struct NodeT {
 typedef QHash<QString, NodeT> NodeListT;
 typedef QMap<qint32, qint32> CheckStatusCountT;
 typedef QHash<QString, QStringList> HostListT;
+typedef QHash<QString, QStringList> SourceNodeListT;
 
 struct CoreDataT {
   qint8 graph_mode;
@@ -358,6 +383,7 @@ struct CoreDataT {
   CheckStatusCountT check_status_count;
   HostListT hosts;
   QSet<QString> sources;
+  SourceNodeListT source_cnodes;
   QMultiMap<QString, QString>  edges;
   double map_height;
   double map_width;
@@ -367,6 +393,7 @@ struct CoreDataT {
     cnodes.clear();
     bpnodes.clear();
     edges.clear();
+    source_cnodes.clear();
   }
 };
 
@@ -0,0 +1,94 @@
+/*
+ * CircuitBreaker.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "CircuitBreaker.hpp"
+#include "utilsCore.hpp"
+#include <QDateTime>
+#include <QMutexLocker>
+
+
+CircuitBreaker::CircuitBreaker(int failureThreshold, qint64 retryDelay, qint64 maxRetryDelay)
+  : m_failureThreshold(failureThreshold),
+    m_retryDelay(retryDelay),
+    m_maxRetryDelay(maxRetryDelay)
+{
+}
+
+
+CircuitBreaker& CircuitBreaker::sources(void)
+{
+  static CircuitBreaker breaker(ngrt4n::SourceFailureThreshold, ngrt4n::SourceRetryDelay, ngrt4n::SourceMaxRetryDelay);
+  return breaker;
+}
+
+
+bool CircuitBreaker::allowRequest(const QString& key, qint64* retryTime)
+{
+  QMutexLocker locker(&m_mutex);
+  auto state = m_states.find(key);
+  if (state == m_states.end() || state->failureCount < m_failureThreshold) {
+    return true;
+  }
+
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if (now < state->retryTime) {
+    if (retryTime) {
+      *retryTime = state->retryTime;
+    }
+    return false;
+  }
+
+  // let one probe through, the others keep waiting until its outcome is known
+  state->retryTime = now + state->retryDelay;
+  return true;
+}
+
+
+void CircuitBreaker::recordSuccess(const QString& key)
+{
+  QMutexLocker locker(&m_mutex);
+  m_states.remove(key);
+}
+
+
+void CircuitBreaker::recordFailure(const QString& key)
+{
+  QMutexLocker locker(&m_mutex);
+  auto state = m_states.find(key);
+  if (state == m_states.end()) {
+    state = m_states.insert(key, StateT{0, 0, 0});
+  }
+
+  ++state->failureCount;
+  if (state->failureCount < m_failureThreshold) {
+    return;
+  }
+
+  if (state->failureCount == m_failureThreshold) {
+    state->retryDelay = m_retryDelay;
+  } else {
+    state->retryDelay = qMin(2 * state->retryDelay, m_maxRetryDelay);
+  }
+  state->retryTime = QDateTime::currentMSecsSinceEpoch() + state->retryDelay;
+}
@@ -0,0 +1,64 @@
+/*
+ * CircuitBreaker.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef CIRCUITBREAKER_HPP
+#define CIRCUITBREAKER_HPP
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/**
+ * Tracks the failures of the monitoring sources across the refresh cycles. After a number of
+ * consecutive failures a source is skipped for a back-off delay, then a single probe request
+ * is let through per delay; the delay doubles on each failed probe up to a maximum, and the
+ * source is reset on the first success. The breaker is shared by all the dashboards and
+ * collectors of the process.
+ */
+class CircuitBreaker
+{
+public:
+  CircuitBreaker(int failureThreshold, qint64 retryDelay, qint64 maxRetryDelay);
+
+  static CircuitBreaker& sources(void);
+
+  bool allowRequest(const QString& key, qint64* retryTime = nullptr);
+  void recordSuccess(const QString& key);
+  void recordFailure(const QString& key);
+
+private:
+  struct StateT {
+    int failureCount;
+    qint64 retryDelay;
+    qint64 retryTime;
+  };
+
+  int m_failureThreshold;
+  qint64 m_retryDelay;
+  qint64 m_maxRetryDelay;
+  QMutex m_mutex;
+  QHash<QString, StateT> m_states;
+};
+
+#endif // CIRCUITBREAKER_HPP
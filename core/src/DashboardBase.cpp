@@ -30,16 +30,19 @@
 #include "PandoraHelper.hpp"
 #include "OpManagerHelper.hpp"
 #include "StatusAggregator.hpp"
-#include "K8sHelper.hpp"
+#include "SourceCollector.hpp"
+#include "CircuitBreaker.hpp"
 #include <QScriptValueIterator>
+#include <QtConcurrentMap>
+#include <QVarLengthArray>
 #include <QNetworkCookieJar>
 #include <sstream>
 #include <QObject>
 #include <QNetworkCookie>
+#include <QDateTime>
 #include <iostream>
 #include <algorithm>
 #include <cassert>
-#include <regex>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
 #   include <QUrlQuery>
@@ -77,7 +80,8 @@ StringMapT DashboardBase::calcRules() {
 
 DashboardBase::DashboardBase(DbSession* dbSession)
   : m_dbSession(dbSession),
-    m_timerId(-1)
+    m_timerId(-1),
+    m_appliedSnapshotTime(0)
 {
   resetStatData();
 }
@@ -109,6 +113,7 @@ std::pair<int, QString> DashboardBase::initialize(BaseSettings* p_settings, cons
   if (parseOut.first != ngrt4n::RcSuccess) {
     return std::make_pair(parseOut.first, parseOut.second);
   }
+  buildBpNodeLevels();
 
   auto loadDsOut = loadDataSources();
   if (loadDsOut.first != ngrt4n::RcSuccess) {
@@ -132,24 +137,48 @@ std::pair<int, QString> DashboardBase::updateAllNodesStatus(void)
   }
 
   resetStatData();
+  m_appliedSnapshotTime = 0;
+
+  // all the sources are requested before any result is waited for, so they are loaded in parallel;
+  // a source failing repeatedly is skipped for a while so that it does not hold the refresh
+  bool dynamicView = (m_cdata.monitor != MonitorT::Any);
+  std::map<QString, std::future<SourceCollector::ResultT> > pendingUpdates;
+  QMap<QString, qint64> skippedSources;
   for (const auto& sid: m_cdata.sources) {
     auto src = m_sources.constFind(sid);
-    if (src != std::cend(m_sources)) {
-      signalUpdateProcessing(*src);
-      if (m_cdata.monitor != MonitorT::Any) {
-        runDynamicViewByGroupUpdate(*src);
-      } else {
-        runGenericViewUpdate(*src);
-      }
-      finalizeUpdate(*src);
+    if (src == std::cend(m_sources)) {
+      continue;
+    }
+    qint64 retryTime = 0;
+    if (! CircuitBreaker::sources().allowRequest(ngrt4n::sourceKey(*src), &retryTime)) {
+      skippedSources.insert(sid, retryTime);
+      continue;
+    }
+    signalUpdateProcessing(*src);
+    QStringList filters = dynamicView ? QStringList(rootNode().name) : sourceHostFilters(*src);
+    pendingUpdates[sid] = fetchSourceData(*src, dynamicView, filters);
+  }
+
+  // the results are applied in the order of the sources, from the dashboard thread
+  for (const auto& sid: m_cdata.sources) {
+    auto src = m_sources.constFind(sid);
+    if (src == std::cend(m_sources)) {
+      SourceT unknownSrc;
+      unknownSrc.id = sid;
+      updateDashboardOnError(unknownSrc, QObject::tr("source not set %1").arg(sid));
+      continue;
+    }
+    auto pendingUpdate = pendingUpdates.find(sid);
+    if (pendingUpdate != pendingUpdates.end()) {
+      applySourceUpdate(*src, pendingUpdate->second.get());
     } else {
-       SourceT unknownSrc;
-       unknownSrc.id = sid;
-       updateDashboardOnError(unknownSrc, QObject::tr("source not set %1").arg(sid));
+      updateDashboardOnStaleData(*src, QObject::tr("%1: skipped after repeated failures, next attempt at %2")
+                                 .arg(src->id, QDateTime::fromMSecsSinceEpoch(skippedSources.value(sid)).toString("hh:mm:ss")));
     }
+    finalizeUpdate(*src);
   }
 
-  computeBpNodeStatus(ngrt4n::ROOT_ID, m_dbSession);
+  computeAllBpNodesStatus(m_dbSession);
 
   updateChart();
 
@@ -157,6 +186,128 @@ std::pair<int, QString> DashboardBase::updateAllNodesStatus(void)
 }
 
 
+bool DashboardBase::applyStatusSnapshot(void)
+{
+  StatusSnapshot::ViewStatusT view;
+  if (! StatusSnapshot::shared().findView(rootNode().name, view)) {
+    return false;
+  }
+
+  // the items get their last collected check, so that the next update only renders what changed
+  for (auto sourceCNodes = m_cdata.source_cnodes.cbegin(); sourceCNodes != m_cdata.source_cnodes.cend(); ++sourceCNodes) {
+    auto src = m_sources.constFind(sourceCNodes.key());
+    for (const auto& cnodeId: sourceCNodes.value()) {
+      auto cnode = m_cdata.cnodes.find(cnodeId);
+      auto savedNode = view.nodes.constFind(cnodeId);
+      if (cnode == m_cdata.cnodes.end() || savedNode == view.nodes.cend() || ! savedNode->hasCheck) {
+        continue;
+      }
+      cnode->check = savedNode->check;
+      if (src != std::cend(m_sources)) {
+        updateNodeStatusInfo(*cnode, *src);
+      } else {
+        cnode->sev = savedNode->sev;
+        cnode->sev_prop = savedNode->sevProp;
+        cnode->actual_msg = savedNode->message;
+      }
+      updateDashboard(*cnode);
+    }
+  }
+
+  // the bpnodes are restored as they were, they are aggregated again on the next update
+  for (auto bpnode = m_cdata.bpnodes.begin(); bpnode != m_cdata.bpnodes.end(); ++bpnode) {
+    auto savedNode = view.nodes.constFind(bpnode->id);
+    if (savedNode == view.nodes.cend()) {
+      continue;
+    }
+    bpnode->sev = savedNode->sev;
+    bpnode->sev_prop = savedNode->sevProp;
+    bpnode->actual_msg = savedNode->message;
+    QString tooltip = bpnode->toString();
+    updateMap(*bpnode, tooltip);
+    updateTree(*bpnode, tooltip);
+  }
+
+  updateChart();
+  m_appliedSnapshotTime = view.timestamp;
+  return true;
+}
+
+
+bool DashboardBase::updateFromStatusSnapshot(qint64 defaultPeriod, qint64 grace)
+{
+  StatusSnapshot::ViewStatusT view;
+  if (! StatusSnapshot::shared().findView(rootNode().name, view)) {
+    return false;
+  }
+
+  // the record is fresh while its collector is expected to have run again, periods are in seconds
+  qint64 period = (view.period > 0) ? view.period : defaultPeriod;
+  if (view.timestamp < QDateTime::currentMSecsSinceEpoch() / 1000 - period - grace) {
+    return false;
+  }
+  if (view.timestamp == m_appliedSnapshotTime) {
+    return true;
+  }
+
+  // same processing as updateAllNodesStatus, only the items whose check changed are rendered again
+  resetStatData();
+  for (auto sourceCNodes = m_cdata.source_cnodes.cbegin(); sourceCNodes != m_cdata.source_cnodes.cend(); ++sourceCNodes) {
+    auto src = m_sources.constFind(sourceCNodes.key());
+    for (const auto& cnodeId: sourceCNodes.value()) {
+      auto cnode = m_cdata.cnodes.find(cnodeId);
+      auto savedNode = view.nodes.constFind(cnodeId);
+      if (cnode == m_cdata.cnodes.end() || savedNode == view.nodes.cend() || ! savedNode->hasCheck) {
+        continue;
+      }
+      if (ngrt4n::isSameCheck(cnode->check, savedNode->check) && cnode->sev == savedNode->sev) {
+        continue;
+      }
+      cnode->check = savedNode->check;
+      if (src != std::cend(m_sources)) {
+        updateNodeStatusInfo(*cnode, *src);
+      } else {
+        cnode->sev = savedNode->sev;
+        cnode->sev_prop = savedNode->sevProp;
+        cnode->actual_msg = savedNode->message;
+      }
+      updateDashboard(*cnode);
+    }
+  }
+
+  computeAllBpNodesStatus(m_dbSession);
+
+  updateChart();
+  m_appliedSnapshotTime = view.timestamp;
+  return true;
+}
+
+
+StatusSnapshot::ViewStatusT DashboardBase::statusSnapshot(void) const
+{
+  StatusSnapshot::ViewStatusT view;
+  view.timestamp = QDateTime::currentMSecsSinceEpoch() / 1000;
+  for (const auto& cnode: m_cdata.cnodes) {
+    StatusSnapshot::NodeStatusT node;
+    node.sev = cnode.sev;
+    node.sevProp = cnode.sev_prop;
+    node.message = cnode.actual_msg;
+    node.hasCheck = true;
+    node.check = cnode.check;
+    view.nodes.insert(cnode.id, node);
+  }
+  for (const auto& bpnode: m_cdata.bpnodes) {
+    StatusSnapshot::NodeStatusT node;
+    node.sev = bpnode.sev;
+    node.sevProp = bpnode.sev_prop;
+    node.message = bpnode.actual_msg;
+    node.hasCheck = false;
+    view.nodes.insert(bpnode.id, node);
+  }
+  return view;
+}
+
+
 void DashboardBase::signalUpdateProcessing(const SourceT& src)
 {
   QString monitorName = MonitorT::toString(src.mon_type);
@@ -167,56 +318,65 @@ void DashboardBase::signalUpdateProcessing(const SourceT& src)
   }
 }
 
-void DashboardBase::runDynamicViewByGroupUpdate(const SourceT& sinfo)
+QStringList DashboardBase::sourceHostFilters(const SourceT& src) const
 {
-  if (sinfo.mon_type == MonitorT::Kubernetes) {
-    CoreDataT newCData;
-    auto loadNsViewOut = K8sHelper(sinfo.mon_url, sinfo.verify_ssl_peer).loadNamespaceView(rootNode().name, newCData);
-    if (loadNsViewOut.second != ngrt4n::RcSuccess) {
-      updateDashboardOnError(sinfo, loadNsViewOut.first);
-      return ;
+  // all the hosts of the source are fetched with a single request
+  QStringList hostOrGroupNames;
+  for (const auto& hitem: m_cdata.hosts.keys()) {
+    StringPairT info = ngrt4n::splitSourceDataPointInfo(hitem);
+    if (info.first == src.id && ! hostOrGroupNames.contains(info.second)) {
+      hostOrGroupNames.push_back(info.second);
     }
+  }
+  return hostOrGroupNames;
+}
+
+
+std::future<SourceCollector::ResultT> DashboardBase::fetchSourceData(const SourceT& src, bool dynamicView, const QStringList& filters)
+{
+  // the source is loaded by the collector, the result must not touch the dashboard until applied
+  if (dynamicView && src.mon_type == MonitorT::Kubernetes) {
+    return SourceCollector::shared().loadNamespaceView(src, filters.value(0));
+  }
+  if (dynamicView || ! filters.isEmpty()) {
+    return SourceCollector::shared().loadDataItems(src, filters);
+  }
 
-    for (const auto& newCNode: newCData.cnodes) {
+  // none of the items of the view comes from the source
+  std::promise<SourceCollector::ResultT> noUpdate;
+  SourceCollector::ResultT update;
+  update.rc = ngrt4n::RcSuccess;
+  noUpdate.set_value(update);
+  return noUpdate.get_future();
+}
+
+
+void DashboardBase::applySourceUpdate(const SourceT& src, const SourceCollector::ResultT& update)
+{
+  QString sourceKey = ngrt4n::sourceKey(src);
+  if (update.rc != ngrt4n::RcSuccess) {
+    CircuitBreaker::sources().recordFailure(sourceKey);
+    updateDashboardOnStaleData(src, update.error);
+    return;
+  }
+  CircuitBreaker::sources().recordSuccess(sourceKey);
+  m_sourceLastUpdates[src.id] = QDateTime::currentMSecsSinceEpoch();
+
+  if (m_cdata.monitor != MonitorT::Any && src.mon_type == MonitorT::Kubernetes) {
+    for (const auto& newCNode: update.cdata.cnodes) {
       auto cnode = m_cdata.cnodes.find(newCNode.id);
       if (cnode != m_cdata.cnodes.end()) { // pod may disappear due to restart, but a notification should be displayed in event feed.
         cnode->check = newCNode.check;
-        updateNodeStatusInfo(*cnode, sinfo);
+        updateNodeStatusInfo(*cnode, src);
         updateDashboard(*cnode);
         cnode->monitored = true;
       }
     }
   } else {
-    ChecksT checks;
-    auto importResult = ngrt4n::loadDataItems(sinfo, rootNode().name, checks);
-    if (importResult.first != ngrt4n::RcSuccess) {
-      updateDashboardOnError(sinfo, importResult.second);
-    } else {
-      updateCNodesWithChecks(checks, sinfo);
-    }
-  }
-}
-
-
-void DashboardBase::runGenericViewUpdate(const SourceT& srcInfo)
-{
-  for (const auto& hitem: m_cdata.hosts.keys()) { //FIXME: avoid iteration for Pandora FMS => all modules are fetched once
-    StringPairT info = ngrt4n::splitSourceDataPointInfo(hitem);
-    if (info.first != srcInfo.id) {
-      continue;
-    }
-    ChecksT checks;
-    auto importResult = ngrt4n::loadDataItems(srcInfo, info.second, checks);
-    if (importResult.first != ngrt4n::RcSuccess) {
-      updateDashboardOnError(srcInfo, importResult.second);
-    } else {
-      updateCNodesWithChecks(checks, srcInfo);
-      break;
-    }
+    updateCNodesWithChecks(update.checks, src);
   }
 }
 
-
 void DashboardBase::resetStatData(void)
 {
   m_cdata.check_status_count[ngrt4n::Normal] = 0;
@@ -238,14 +398,21 @@ void DashboardBase::updateDashboard(const NodeT& _node)
 
 void DashboardBase::updateCNodesWithCheck(const CheckT& check, const SourceT& src)
 {
-  for (auto& cnode: m_cdata.cnodes) {
-    if (cnode.child_nodes.toLower() != ngrt4n::realCheckId(src.id, QString::fromStdString(check.id)).toLower()) {
+  auto sourceCNodes = m_cdata.source_cnodes.constFind(src.id);
+  if (sourceCNodes == m_cdata.source_cnodes.cend()) {
+    return;
+  }
+
+  QString checkId = ngrt4n::realCheckId(src.id, QString::fromStdString(check.id)).toLower();
+  for (const auto& cnodeId: *sourceCNodes) {
+    auto cnode = m_cdata.cnodes.find(cnodeId);
+    if (cnode == m_cdata.cnodes.end() || cnode->child_nodes.toLower() != checkId) {
       continue;
     }
-    cnode.check = check;
-    updateNodeStatusInfo(cnode, src);
-    updateDashboard(cnode);
-    cnode.monitored = true;
+    cnode->check = check;
+    updateNodeStatusInfo(*cnode, src);
+    updateDashboard(*cnode);
+    cnode->monitored = true;
   }
 }
 
@@ -258,146 +425,287 @@ void DashboardBase::updateCNodesWithChecks(const ChecksT& checks, const SourceT&
 
 void DashboardBase::updateNodeStatusInfo(NodeT& _node, const SourceT& src)
 {
-  QRegExp regexp;
   _node.sev = ngrt4n::severityFromProbeStatus(src.mon_type, _node.check.status);
   _node.sev_prop = StatusAggregator::propagate(_node.sev, _node.sev_prule);
+
+  // the message only depends on the check data and on the node's messages
+  if (_node.rendered_msg
+      && ngrt4n::hasSameMessageInputs(_node.rendered_check, _node.check)
+      && _node.alarm_msg_tpl.source == _node.alarm_msg
+      && _node.notification_msg_tpl.source == _node.notification_msg) {
+    return;
+  }
+  _node.rendered_check = _node.check;
+  _node.rendered_msg = true;
   _node.actual_msg = QString::fromStdString(_node.check.alarm_msg);
   
   if (_node.check.host == "-") {
     return;
   }
-  
-  if (m_cdata.monitor == MonitorT::Zabbix) {
-    regexp.setPattern(ngrt4n::TAG_ZABBIX_HOSTNAME.c_str());
-    _node.actual_msg.replace(regexp, _node.check.host.c_str());
-    regexp.setPattern(ngrt4n::TAG_ZABBIX_HOSTNAME2.c_str());
-    _node.actual_msg.replace(regexp, _node.check.host.c_str());
-  }
-  
+
+  QString tagValues[MessageTemplateT::TagCount];
+  QString hostname = QString::fromStdString(_node.check.host);
+
+  const MessageTemplateT* msgTemplate = nullptr;
   if (_node.sev == ngrt4n::Normal) {
-    if (_node.notification_msg.isEmpty()) {
-      return ;
-    } else {
-      _node.actual_msg = _node.notification_msg;
+    if (! _node.notification_msg.isEmpty()) {
+      msgTemplate = &ngrt4n::upToDateMessageTemplate(_node.notification_msg_tpl, _node.notification_msg);
+    }
+  } else if (! _node.alarm_msg.isEmpty())  {
+    msgTemplate = &ngrt4n::upToDateMessageTemplate(_node.alarm_msg_tpl, _node.alarm_msg);
+  }
+
+  if (! msgTemplate) {
+    if (m_cdata.monitor == MonitorT::Zabbix) {
+      MessageTemplateT checkMsgTemplate;
+      ngrt4n::compileMessageTemplate(checkMsgTemplate, _node.actual_msg);
+      tagValues[MessageTemplateT::ZabbixHostname] = hostname;
+      _node.actual_msg = ngrt4n::renderMessageTemplate(checkMsgTemplate, tagValues);
     }
-  } else if (_node.alarm_msg.isEmpty())  {
     return ;
-  } else {
-    _node.actual_msg = _node.alarm_msg;
   }
-  
-  regexp.setPattern(ngrt4n::TAG_HOSTNAME.c_str());
-  _node.actual_msg.replace(regexp, _node.check.host.c_str());
-  auto info = QString(_node.check.id.c_str()).split("/");
-  
-  if (info.length() > 1) {
-    regexp.setPattern(ngrt4n::TAG_CHECK.c_str());
-    _node.actual_msg.replace(regexp, info[1]);
+
+  QString checkId = QString::fromStdString(_node.check.id);
+  tagValues[MessageTemplateT::Hostname] = hostname;
+  if (checkId.contains('/')) {
+    tagValues[MessageTemplateT::CheckName] = checkId.section('/', 1, 1);
   }
-  
+
   if (m_cdata.monitor == MonitorT::Nagios) {
-    info = QString(_node.check.check_command.c_str()).split("!");
-    if (info.length() >= 3) {
-      regexp.setPattern(ngrt4n::TAG_THERESHOLD.c_str());
-      _node.actual_msg.replace(regexp, info[1]);
-      if (_node.sev == ngrt4n::Major)
-        _node.actual_msg.replace(regexp, info[2]);
+    QString checkCommand = QString::fromStdString(_node.check.check_command);
+    if (checkCommand.count('!') >= 2) {
+      tagValues[MessageTemplateT::Threshold] = checkCommand.section('!', 1, 1);
     }
   }
+
+  _node.actual_msg = ngrt4n::renderMessageTemplate(*msgTemplate, tagValues);
 }
 
-ngrt4n::AggregatedSeverityT DashboardBase::computeBpNodeStatus(const QString& _nodeId, DbSession* p_dbSession)
+void DashboardBase::buildBpNodeLevels(void)
 {
-  ngrt4n::AggregatedSeverityT status2Propagate;
+  m_bpnodeLevels.clear();
+  m_externalServiceNodes.clear();
 
-  NodeListT::iterator node;
-  if (! ngrt4n::findNode(&m_cdata, _nodeId, node)) {
-    status2Propagate.sev = ngrt4n::Unknown;
-    status2Propagate.weight = ngrt4n::WEIGHT_UNIT;
-    return status2Propagate;
-  }
-  
-  status2Propagate.weight = node->weight;
-  
-  if (node->child_nodes.isEmpty()) {
-    status2Propagate.sev = ngrt4n::Unknown;
+  QHash<QString, int> levelCache;
+  QSet<QString> visiting;
+  computeBpNodeLevel(ngrt4n::ROOT_ID, levelCache, visiting);
+}
 
-    return status2Propagate;
+
+int DashboardBase::computeBpNodeLevel(const QString& nodeId, QHash<QString, int>& levelCache, QSet<QString>& visiting)
+{
+  auto cachedLevel = levelCache.constFind(nodeId);
+  if (cachedLevel != levelCache.cend()) {
+    return *cachedLevel;
   }
-  
-  // if IT service handle it directly
-  if (node->type == NodeType::ITService) {
-    status2Propagate.sev = node->sev_prop;
 
-    return status2Propagate;
+  // IT services, unknown nodes and nodes on a dependency cycle are not aggregated
+  auto node = m_cdata.bpnodes.constFind(nodeId);
+  if (node == m_cdata.bpnodes.cend() || visiting.contains(nodeId)) {
+    return -1;
   }
 
-  // if external service handle it through last status fetched from database
+  int level = -1;
   if (node->type == NodeType::ExternalService) {
-    constexpr long intervalDurationSec = 10 * 60;
-    long toDate = std::time(nullptr);
-    long fromDate = toDate - intervalDurationSec;
-    QosDataListMapT qosMap;
-
-    node->check.host = "-";
-    node->check.host_groups = "-";
-    node->check.check_command = "-";
-    node->check.last_state_change = std::to_string(toDate);
-
-    auto externalServiceName = node->child_nodes.toStdString();
-    int rc = p_dbSession->listQosData(qosMap, externalServiceName, fromDate, toDate);
-    if (rc > 0) {
-      node->sev = qosMap[externalServiceName].back().status;
-      node->actual_msg = QObject::tr("external service - %1").arg(node->child_nodes);
+    if (! node->child_nodes.isEmpty()) {
+      m_externalServiceNodes.push_back(nodeId);
+    }
+  } else if (node->type != NodeType::ITService && ! node->child_nodes.isEmpty()) {
+    visiting.insert(nodeId);
+    BpNodeAggregationT item;
+    item.id = nodeId;
+    item.children = node->child_nodes.split(ngrt4n::CHILD_Q_SEP);
+    for (const auto& childId: item.children) {
+      level = qMax(level, computeBpNodeLevel(childId, levelCache, visiting));
+    }
+    visiting.remove(nodeId);
+
+    ++level;
+    if (m_bpnodeLevels.size() <= level) {
+      m_bpnodeLevels.resize(level + 1);
+    }
+    m_bpnodeLevels[level].push_back(item);
+  }
+
+  levelCache.insert(nodeId, level);
+  return level;
+}
+
+
+void DashboardBase::computeAllBpNodesStatus(DbSession* p_dbSession)
+{
+  if (m_bpnodeLevels.isEmpty()) {
+    buildBpNodeLevels();
+  }
+
+  // external services are resolved first since they require database access
+  updateExternalServicesStatus(p_dbSession);
+
+  // each level only depends on lower ones, so its nodes can be aggregated concurrently;
+  // results are then applied in the level order to keep the dashboard updates deterministic
+  for (auto& level: m_bpnodeLevels) {
+    for (auto& item: level) {
+      item.node = &(*m_cdata.bpnodes.constFind(item.id));
+    }
+
+    if (level.size() >= ngrt4n::MinParallelAggregationLevelSize) {
+      QtConcurrent::blockingMap(level, [this](BpNodeAggregationT& item) { aggregateBpNodeStatus(item); });
     } else {
-      node->sev = ngrt4n::Unknown;
-      status2Propagate.sev = ngrt4n::Unknown;
-      node->actual_msg = QObject::tr("external service - %1 - no status found in last %2 minute(s)")
-                         .arg(node->child_nodes
-                              .arg(intervalDurationSec / 60));
+      for (auto& item: level) {
+        aggregateBpNodeStatus(item);
+      }
     }
 
-    status2Propagate.sev = StatusAggregator::propagate(node->sev, node->sev_prule);
-    updateDashboard(*node);
+    for (const auto& item: level) {
+      auto node = m_cdata.bpnodes.find(item.id);
+      node->sev = item.sev;
+      node->sev_prop = item.sev_prop;
+      node->actual_msg = item.details;
 
-    return status2Propagate;
+      QString tooltip = node->toString();
+      updateMap(*node, tooltip);
+      updateTree(*node, tooltip);
+    }
   }
+}
+
 
+void DashboardBase::aggregateBpNodeStatus(BpNodeAggregationT& item) const
+{
+  QVarLengthArray<ngrt4n::AggregatedSeverityT, 64> childStatuses;
+  for (const auto& childId: item.children) {
+    childStatuses.append(aggregatedNodeStatus(childId));
+  }
 
   StatusAggregator severityAggregator;
-  for (auto&& childId: node->child_nodes.split(ngrt4n::CHILD_Q_SEP)) {
-    status2Propagate = computeBpNodeStatus(childId, p_dbSession);
-    severityAggregator.addSeverity(status2Propagate.sev, status2Propagate.weight);
+  severityAggregator.addSeverities(childStatuses.constData(), childStatuses.size());
+
+  item.sev = severityAggregator.aggregate(item.node->sev_crule, item.node->thresholdLimits);
+  item.sev_prop = StatusAggregator::propagate(item.sev, item.node->sev_prule);
+  item.details = severityAggregator.toDetailsString();
+}
+
+
+ngrt4n::AggregatedSeverityT DashboardBase::aggregatedNodeStatus(const QString& nodeId) const
+{
+  ngrt4n::AggregatedSeverityT status2Propagate;
+
+  NodeListT::const_iterator node;
+  if (! ngrt4n::findNode(m_cdata.bpnodes, m_cdata.cnodes, nodeId, node)) {
+    status2Propagate.sev = ngrt4n::Unknown;
+    status2Propagate.weight = ngrt4n::WEIGHT_UNIT;
+    return status2Propagate;
   }
-  
-  node->sev = severityAggregator.aggregate(node->sev_crule, node->thresholdLimits);
-  node->sev_prop = severityAggregator.propagate(node->sev, node->sev_prule);
-  node->actual_msg = severityAggregator.toDetailsString();
-  
-  status2Propagate.sev = node->sev_prop;
+
   status2Propagate.weight = node->weight;
+  status2Propagate.sev = node->child_nodes.isEmpty() ? static_cast<int>(ngrt4n::Unknown) : node->sev_prop;
 
-  QString tooltip = node->toString();
-  updateMap(*node, tooltip);
-  updateTree(*node, tooltip);
-  
   return status2Propagate;
 }
 
 
+void DashboardBase::updateExternalServicesStatus(DbSession* p_dbSession)
+{
+  if (m_externalServiceNodes.isEmpty()) {
+    return;
+  }
+
+  std::set<std::string> externalServiceNames;
+  for (const auto& nodeId: m_externalServiceNodes) {
+    auto node = m_cdata.bpnodes.constFind(nodeId);
+    if (node != m_cdata.bpnodes.cend()) {
+      externalServiceNames.insert(node->child_nodes.toStdString());
+    }
+  }
+
+  QosDataMapT lastQosDataMap;
+  p_dbSession->listLastQosData(lastQosDataMap, externalServiceNames);
+
+  for (const auto& nodeId: m_externalServiceNodes) {
+    auto node = m_cdata.bpnodes.find(nodeId);
+    if (node != m_cdata.bpnodes.end()) {
+      updateExternalServiceStatus(*node, lastQosDataMap);
+    }
+  }
+}
+
+
+void DashboardBase::updateExternalServiceStatus(NodeT& node, const QosDataMapT& lastQosDataMap)
+{
+  constexpr long intervalDurationSec = 10 * 60;
+  long toDate = std::time(nullptr);
+  long fromDate = toDate - intervalDurationSec;
+
+  node.check.host = "-";
+  node.check.host_groups = "-";
+  node.check.check_command = "-";
+  node.check.last_state_change = std::to_string(toDate);
+
+  auto lastQosData = lastQosDataMap.constFind(node.child_nodes.toStdString());
+  if (lastQosData != lastQosDataMap.cend() && lastQosData->timestamp >= fromDate) {
+    node.sev = lastQosData->status;
+    node.actual_msg = QObject::tr("external service - %1").arg(node.child_nodes);
+  } else {
+    node.sev = ngrt4n::Unknown;
+    node.actual_msg = QObject::tr("external service - %1 - no status found in last %2 minute(s)")
+                      .arg(node.child_nodes)
+                      .arg(intervalDurationSec / 60);
+  }
+
+  node.sev_prop = StatusAggregator::propagate(node.sev, node.sev_prule);
+  updateDashboard(node);
+}
+
+
 void DashboardBase::updateDashboardOnError(const SourceT& src, const QString& msg)
 {
   if (! msg.isEmpty()) {
     Q_EMIT updateMessageChanged(msg.toStdString());
   }
 
-  for (auto& cnode: m_cdata.cnodes) {
-    StringPairT info = ngrt4n::splitSourceDataPointInfo(cnode.child_nodes);
-    if (info.first != src.id) continue;
-    ngrt4n::setCheckOnError(-1, msg, cnode.check);
-    updateNodeStatusInfo(cnode, src);
-    cnode.monitored = true;
-    updateDashboard(cnode);
+  auto sourceCNodes = m_cdata.source_cnodes.constFind(src.id);
+  if (sourceCNodes == m_cdata.source_cnodes.cend()) {
+    return;
+  }
+
+  for (const auto& cnodeId: *sourceCNodes) {
+    auto cnode = m_cdata.cnodes.find(cnodeId);
+    if (cnode == m_cdata.cnodes.end()) continue;
+    ngrt4n::setCheckOnError(-1, msg, cnode->check);
+    updateNodeStatusInfo(*cnode, src);
+    cnode->monitored = true;
+    updateDashboard(*cnode);
+  }
+}
+
+void DashboardBase::updateDashboardOnStaleData(const SourceT& src, const QString& msg)
+{
+  // without a previous snapshot there is nothing to show but the error
+  auto lastUpdate = m_sourceLastUpdates.constFind(src.id);
+  if (lastUpdate == m_sourceLastUpdates.cend()) {
+    updateDashboardOnError(src, msg);
+    return;
+  }
+
+  if (! msg.isEmpty()) {
+    Q_EMIT updateMessageChanged(msg.toStdString());
+  }
+
+  auto sourceCNodes = m_cdata.source_cnodes.constFind(src.id);
+  if (sourceCNodes == m_cdata.source_cnodes.cend()) {
+    return;
+  }
+
+  QString staleNote = QObject::tr("stale data from %1: %2")
+                      .arg(QDateTime::fromMSecsSinceEpoch(*lastUpdate).toString("yyyy-MM-dd hh:mm:ss"), msg);
+  for (const auto& cnodeId: *sourceCNodes) {
+    auto cnode = m_cdata.cnodes.find(cnodeId);
+    if (cnode == m_cdata.cnodes.end()) continue;
+    updateNodeStatusInfo(*cnode, src);
+    cnode->actual_msg = QString("%1 [%2]").arg(cnode->actual_msg, staleNote);
+    cnode->rendered_msg = false; // the note is dropped on the next fresh update
+    cnode->monitored = true;
+    updateDashboard(*cnode);
   }
 }
 
@@ -412,8 +720,18 @@ std::pair<int, QString> DashboardBase::loadDataSources(void)
 
 void DashboardBase::finalizeUpdate(const SourceT& src)
 {
-  for (auto& cnode: m_cdata.cnodes) {
+  auto sourceCNodes = m_cdata.source_cnodes.constFind(src.id);
+  if (sourceCNodes == m_cdata.source_cnodes.cend()) {
+    return;
+  }
+
+  for (const auto& cnodeId: *sourceCNodes) {
+    auto cnodeRef = m_cdata.cnodes.find(cnodeId);
+    if (cnodeRef == m_cdata.cnodes.end()) {
+      continue;
+    }
 
+    NodeT& cnode = *cnodeRef;
     if (cnode.monitored) {
       cnode.monitored = false;
       continue;
@@ -421,11 +739,9 @@ void DashboardBase::finalizeUpdate(const SourceT& src)
 
     switch (src.mon_type) {
       case MonitorT::Any:
-        if (std::regex_match(cnode.child_nodes.toStdString(), std::regex(QString("%1:.+").arg(src.id).toStdString()))) {
-          ngrt4n::setCheckOnError(ngrt4n::Unset, tr("Undefined service (%1)").arg(cnode.child_nodes), cnode.check);
-          updateNodeStatusInfo(cnode, src);
-          updateDashboard(cnode);
-        }
+        ngrt4n::setCheckOnError(ngrt4n::Unset, tr("Undefined service (%1)").arg(cnode.child_nodes), cnode.check);
+        updateNodeStatusInfo(cnode, src);
+        updateDashboard(cnode);
         break;
       case MonitorT::Kubernetes:
         cnode.sev = ngrt4n::Critical;
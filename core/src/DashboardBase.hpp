@@ -30,6 +30,8 @@
 #include "BaseSettings.hpp"
 #include "ZbxHelper.hpp"
 #include "ZnsHelper.hpp"
+#include "StatusSnapshot.hpp"
+#include "SourceCollector.hpp"
 #include "dbo/src/DbSession.hpp"
 #include <QString>
 
@@ -57,12 +59,13 @@ public:
 
   std::pair<int, QString> loadDataSources(void);
   std::pair<int, QString> updateAllNodesStatus(void);
+  bool applyStatusSnapshot(void);
+  bool updateFromStatusSnapshot(qint64 defaultPeriod, qint64 grace);
+  StatusSnapshot::ViewStatusT statusSnapshot(void) const;
 
 public Q_SLOTS:
-  void runGenericViewUpdate(const SourceT& srcInfo);
-  void runDynamicViewByGroupUpdate(const SourceT& srcInfo);
   void resetStatData(void);
-  ngrt4n::AggregatedSeverityT computeBpNodeStatus(const QString& _node, DbSession* p_dbSession);
+  void computeAllBpNodesStatus(DbSession* p_dbSession);
   virtual std::pair<int, QString> initialize(BaseSettings* p_settings, const QString& viewFile);
   qint32 userRole(void) const {return m_userRole;}
   SourceListT sources(void) {return m_sources;}
@@ -90,6 +93,17 @@ protected:
   virtual void updateEventFeeds(const NodeT& node) = 0;
 
 private:
+  /** holds the input and the result of the status aggregation of a single bpnode */
+  struct BpNodeAggregationT {
+    QString id;
+    QStringList children;
+    const NodeT* node;
+    int sev;
+    int sev_prop;
+    QString details;
+  };
+  typedef QVector<BpNodeAggregationT> BpNodeLevelT;
+
   DbSession* m_dbSession;
   qint32 m_timerId;
   QString m_selectedNode;
@@ -97,11 +111,27 @@ private:
   qint32 m_interval;
   QSize m_msgConsoleSize;
   SourceListT m_sources;
+  QMap<QString, qint64> m_sourceLastUpdates; // time of the last successful update of each source
+  qint64 m_appliedSnapshotTime; // collection time of the snapshot record the items were last updated from
   void signalUpdateProcessing(const SourceT& src);
+  QStringList sourceHostFilters(const SourceT& src) const;
+  static std::future<SourceCollector::ResultT> fetchSourceData(const SourceT& src, bool dynamicView, const QStringList& filters);
+  void applySourceUpdate(const SourceT& src, const SourceCollector::ResultT& update);
   void updateCNodesWithCheck(const CheckT & check, const SourceT& src);
   void updateCNodesWithChecks(const ChecksT& checks, const SourceT& src);
   void computeFirstSrcIndex(void);
   void updateDashboardOnError(const SourceT& src, const QString& msg);
+  void updateDashboardOnStaleData(const SourceT& src, const QString& msg);
+  void buildBpNodeLevels(void);
+  int computeBpNodeLevel(const QString& nodeId, QHash<QString, int>& levelCache, QSet<QString>& visiting);
+  void updateExternalServicesStatus(DbSession* p_dbSession);
+  void updateExternalServiceStatus(NodeT& node, const QosDataMapT& lastQosDataMap);
+  ngrt4n::AggregatedSeverityT aggregatedNodeStatus(const QString& nodeId) const;
+  void aggregateBpNodeStatus(BpNodeAggregationT& item) const;
+
+  /** bpnodes grouped by height in the service tree, so that all the children of a level are in lower levels */
+  QVector<BpNodeLevelT> m_bpnodeLevels;
+  QStringList m_externalServiceNodes;
 };
 
 #endif /* SVNAVIGATOR_HPP */
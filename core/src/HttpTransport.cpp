@@ -0,0 +1,155 @@
+/*
+ * HttpTransport.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "HttpTransport.hpp"
+#include "utilsCore.hpp"
+#include <QThreadStorage>
+#include <QVariant>
+#include <atomic>
+
+namespace {
+  std::atomic<qint64> requestCount(0);
+  std::atomic<qint64> encryptedRequestCount(0);
+  std::atomic<qint64> handshakeCount(0);
+  std::atomic<qint64> http2RequestCount(0);
+  std::atomic<qint64> receivedByteCount(0);
+  std::atomic<qint64> savedByteCount(0);
+}
+
+
+HttpTransport::HttpTransport(void)
+  : QNetworkAccessManager()
+{
+  connect(this, SIGNAL(encrypted(QNetworkReply*)), this, SLOT(handleEncrypted(QNetworkReply*)));
+  connect(this, SIGNAL(finished(QNetworkReply*)), this, SLOT(handleFinished(QNetworkReply*)));
+}
+
+
+HttpTransport* HttpTransport::local(void)
+{
+  // deleted with the thread, together with its pooled connections
+  static QThreadStorage<HttpTransport*> transports;
+  if (! transports.hasLocalData()) {
+    transports.setLocalData(new HttpTransport());
+  }
+  return transports.localData();
+}
+
+
+HttpTransport::MetricsT HttpTransport::metrics(void)
+{
+  MetricsT result;
+  result.requests = requestCount.load();
+  result.encryptedRequests = encryptedRequestCount.load();
+  result.handshakes = handshakeCount.load();
+  result.http2Requests = http2RequestCount.load();
+  result.bytesReceived = receivedByteCount.load();
+  result.bytesSavedByCompression = savedByteCount.load();
+  return result;
+}
+
+
+QString HttpTransport::metricsSummary(void)
+{
+  MetricsT current = metrics();
+  return QObject::tr("%1 HTTP request(s), %2 over HTTP/2, %3 TLS handshake(s) for %4 encrypted request(s), %5 byte(s) received, %6 byte(s) saved by compression")
+      .arg(current.requests)
+      .arg(current.http2Requests)
+      .arg(current.handshakes)
+      .arg(current.encryptedRequests)
+      .arg(current.bytesReceived)
+      .arg(current.bytesSavedByCompression);
+}
+
+
+void HttpTransport::setSslConfiguration(QNetworkReply* reply, const QSslConfiguration& sslConfig)
+{
+  // the session tickets are kept by the transport to resume the TLS sessions on new connections
+  QSslConfiguration config = sslConfig;
+  config.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+  reply->setSslConfiguration(config);
+}
+
+
+void HttpTransport::whenFinished(QNetworkReply* reply, QObject* context, const ReplyHandlerT& handler)
+{
+  // the handler is dropped along with the context; a reply timing out is aborted, which finishes it too
+  QObject::connect(reply, &QNetworkReply::finished, context, [reply, handler]() { handler(reply); });
+  ngrt4n::setRequestTimeout(reply);
+}
+
+
+QNetworkReply* HttpTransport::get(QNetworkRequest request)
+{
+  prepareRequest(request);
+  ++requestCount;
+  return QNetworkAccessManager::get(request);
+}
+
+
+QNetworkReply* HttpTransport::post(QNetworkRequest request, const QByteArray& data)
+{
+  prepareRequest(request);
+  ++requestCount;
+  return QNetworkAccessManager::post(request, data);
+}
+
+
+void HttpTransport::prepareRequest(QNetworkRequest& request)
+{
+  // Accept-Encoding is left to Qt, which then decompresses gzip and deflate bodies while reading;
+  // setting it here would disable the decompression
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+  request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+}
+
+
+void HttpTransport::handleEncrypted(QNetworkReply* reply)
+{
+  // only emitted for new connections, requests over a pooled connection do not trigger it
+  Q_UNUSED(reply);
+  ++handshakeCount;
+}
+
+
+void HttpTransport::handleFinished(QNetworkReply* reply)
+{
+  if (reply->attribute(QNetworkRequest::ConnectionEncryptedAttribute).toBool()) {
+    ++encryptedRequestCount;
+  }
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+  if (reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool()) {
+    ++http2RequestCount;
+  }
+#endif
+
+  // the body is not read yet, what is available is the decoded size
+  qint64 decodedSize = reply->bytesAvailable();
+  receivedByteCount += decodedSize;
+  QVariant encodedSize = reply->header(QNetworkRequest::ContentLengthHeader);
+  if (reply->hasRawHeader("Content-Encoding") && encodedSize.isValid() && encodedSize.toLongLong() < decodedSize) {
+    savedByteCount += decodedSize - encodedSize.toLongLong();
+  }
+}
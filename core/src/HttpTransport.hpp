@@ -0,0 +1,81 @@
+/*
+ * HttpTransport.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef HTTPTRANSPORT_HPP
+#define HTTPTRANSPORT_HPP
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSslConfiguration>
+#include <functional>
+
+/**
+ * HTTP transport shared by the monitoring helpers. A network manager can only be used from
+ * the thread it belongs to, so there is one transport per thread, kept for the lifetime of
+ * the thread: the connections it pools per origin, the DNS results and the TLS sessions are
+ * thus reused from one poll to the next. Responses are requested compressed and decoded on
+ * the fly, and HTTP/2 is used when the server offers it.
+ *
+ * Requests are never waited for: the helpers chain them through continuations run from the
+ * event loop of the thread once each reply is finished.
+ */
+class HttpTransport : public QNetworkAccessManager
+{
+  Q_OBJECT
+
+public:
+  struct MetricsT {
+    qint64 requests;
+    qint64 encryptedRequests;
+    qint64 handshakes;
+    qint64 http2Requests;
+    qint64 bytesReceived;
+    qint64 bytesSavedByCompression;
+  };
+
+  /** continuation of a request, called with the finished reply */
+  typedef std::function<void(QNetworkReply*)> ReplyHandlerT;
+  /** continuation of a chain of requests, called with its return code */
+  typedef std::function<void(int)> DoneHandlerT;
+
+  static HttpTransport* local(void);
+  static MetricsT metrics(void);
+  static QString metricsSummary(void);
+  static void setSslConfiguration(QNetworkReply* reply, const QSslConfiguration& sslConfig);
+  static void whenFinished(QNetworkReply* reply, QObject* context, const ReplyHandlerT& handler);
+
+  QNetworkReply* get(QNetworkRequest request);
+  QNetworkReply* post(QNetworkRequest request, const QByteArray& data);
+
+private Q_SLOTS:
+  void handleEncrypted(QNetworkReply* reply);
+  void handleFinished(QNetworkReply* reply);
+
+private:
+  HttpTransport(void);
+  static void prepareRequest(QNetworkRequest& request);
+};
+
+#endif // HTTPTRANSPORT_HPP
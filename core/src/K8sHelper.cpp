@@ -42,63 +42,74 @@ K8sHelper::K8sHelper(const QString& apiUrl, bool verifySslPeer)
 }
 
 
-std::pair<QString, int> K8sHelper::loadNamespaceView(const QString& in_namespace, CoreDataT& out_cdata)
+void K8sHelper::loadNamespaceView(const QString& in_namespace, const HttpTransport::DoneHandlerT& done)
 {
-  // process services
-  auto resultRequestServicesData = requestNamespacedItemsData(in_namespace, "services");
-  if (resultRequestServicesData.second != ngrt4n::RcSuccess) {
-    return resultRequestServicesData;
-  }
-
-  QMap<QString, QMap<QString, QString>> serviceSelectorMaps;
-  NodeListT serviceBpnodes;
-  auto resultParseServices = parseNamespacedServices(resultRequestServicesData.first, in_namespace, serviceSelectorMaps, serviceBpnodes);
-  if (resultParseServices.second != ngrt4n::RcSuccess) {
-    return resultParseServices;
-  }
+  m_cdata.clear();
+
+  // process services, then pods
+  requestNamespacedItemsData(in_namespace, "services", [this, in_namespace, done](const std::pair<QByteArray, int>& resultRequestServicesData) {
+    if (resultRequestServicesData.second != ngrt4n::RcSuccess) {
+      m_lastError = resultRequestServicesData.first;
+      done(resultRequestServicesData.second);
+      return;
+    }
 
-  // process pods
-  auto resultRequestPodsData = requestNamespacedItemsData(in_namespace, "pods");
-  if (resultRequestPodsData.second != ngrt4n::RcSuccess) {
-    return resultRequestPodsData;
-  }
+    QMap<QString, QMap<QString, QString>> serviceSelectorMaps;
+    NodeListT serviceBpnodes;
+    auto resultParseServices = parseNamespacedServices(resultRequestServicesData.first, in_namespace, serviceSelectorMaps, serviceBpnodes);
+    if (resultParseServices.second != ngrt4n::RcSuccess) {
+      m_lastError = resultParseServices.first;
+      done(resultParseServices.second);
+      return;
+    }
 
-  auto resultParsePods = parseNamespacedPods(resultRequestPodsData.first, in_namespace, serviceSelectorMaps, out_cdata.bpnodes, out_cdata.cnodes);
-  if (resultParsePods.second != ngrt4n::RcSuccess) {
-    out_cdata.clear();
-    return resultParsePods;
-  }
+    requestNamespacedItemsData(in_namespace, "pods", [this, in_namespace, serviceSelectorMaps, serviceBpnodes, done](const std::pair<QByteArray, int>& resultRequestPodsData) {
+      if (resultRequestPodsData.second != ngrt4n::RcSuccess) {
+        m_lastError = resultRequestPodsData.first;
+        done(resultRequestPodsData.second);
+        return;
+      }
 
-  // append service nodes
-  for(auto&& snode: serviceBpnodes) {
-    out_cdata.bpnodes.insert(snode.id, snode);
-  }
+      auto resultParsePods = parseNamespacedPods(resultRequestPodsData.first, in_namespace, serviceSelectorMaps, m_cdata.bpnodes, m_cdata.cnodes);
+      if (resultParsePods.second != ngrt4n::RcSuccess) {
+        m_cdata.clear();
+        m_lastError = resultParsePods.first;
+        done(resultParsePods.second);
+        return;
+      }
 
-  // add namespace as root service node
-  NodeT rootNode;
-  rootNode.id = ngrt4n::ROOT_ID;
-  rootNode.parents.clear();
-  rootNode.name = in_namespace;
-  rootNode.parents = QSet<QString>{""};
-  rootNode.type = NodeType::BusinessService;
-  rootNode.sev = ngrt4n::Unknown;
-  rootNode.sev_prule = PropRules::Unchanged;
-  rootNode.sev_crule = CalcRules::Average;
-  rootNode.weight = ngrt4n::WEIGHT_UNIT;
-  rootNode.icon = ngrt4n::K8S_NS;
-  rootNode.description = "Namespace node";
-
-  out_cdata.bpnodes.insert(rootNode.id, rootNode);
-  out_cdata.hosts.insert(in_namespace, QStringList{in_namespace});
-  out_cdata.monitor = MonitorT::Kubernetes;
-
-  ngrt4n::fixupDependencies(out_cdata);
+      // append service nodes
+      for(auto&& snode: serviceBpnodes) {
+        m_cdata.bpnodes.insert(snode.id, snode);
+      }
 
-  return std::make_pair("", ngrt4n::RcSuccess);
+      // add namespace as root service node
+      NodeT rootNode;
+      rootNode.id = ngrt4n::ROOT_ID;
+      rootNode.parents.clear();
+      rootNode.name = in_namespace;
+      rootNode.parents = QSet<QString>{""};
+      rootNode.type = NodeType::BusinessService;
+      rootNode.sev = ngrt4n::Unknown;
+      rootNode.sev_prule = PropRules::Unchanged;
+      rootNode.sev_crule = CalcRules::Average;
+      rootNode.weight = ngrt4n::WEIGHT_UNIT;
+      rootNode.icon = ngrt4n::K8S_NS;
+      rootNode.description = "Namespace node";
+
+      m_cdata.bpnodes.insert(rootNode.id, rootNode);
+      m_cdata.hosts.insert(in_namespace, QStringList{in_namespace});
+      m_cdata.monitor = MonitorT::Kubernetes;
+
+      ngrt4n::fixupDependencies(m_cdata);
+
+      done(ngrt4n::RcSuccess);
+    });
+  });
 }
 
 
-std::pair<QStringList, int> K8sHelper::listNamespaces(void)
+void K8sHelper::listNamespaces(const HttpTransport::DoneHandlerT& done)
 {
   //prepare http request
   QNetworkRequest networkRequest;
@@ -106,32 +117,33 @@ std::pair<QStringList, int> K8sHelper::listNamespaces(void)
 
   networkRequest.setUrl( QUrl(QString("%1/namespaces").arg(m_apiUrl)) );
 
-  // make request and conncet to the processing handlers
-  QNetworkReply* reply = QNetworkAccessManager::get(networkRequest);
-  connect(reply, SIGNAL(finished()), &m_eventLoop, SLOT(quit()));
-  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(exitEventLoop(QNetworkReply::NetworkError)));
-
+  // make request and continue once it is finished
+  QNetworkReply* reply = HttpTransport::local()->get(networkRequest);
   setNetworkReplySslOptions(reply, m_verifySslPeer);
 
-  // wait synchronously before continuing
-  m_eventLoop.exec();
+  HttpTransport::whenFinished(reply, this, [this, done](QNetworkReply* finishedReply) {
+    finishedReply->deleteLater();
 
-  if (! reply) {
-    auto&& errorMsg = QObject::tr("Unexpected NULL QNetworkReply");
-    return std::make_pair(QStringList{errorMsg}, ngrt4n::RcRpcError);
-  }
-
-  reply->deleteLater();
+    if (finishedReply->error() != QNetworkReply::NoError) {
+      m_lastError = finishedReply->errorString();
+      done(ngrt4n::RcRpcError);
+      return;
+    }
 
-  if (reply->error() != QNetworkReply::NoError) {
-    return std::make_pair(QStringList{reply->errorString()}, ngrt4n::RcRpcError);
-  }
+    auto&& outParseNamespaces = parseNamespaces(finishedReply->readAll());
+    if (outParseNamespaces.second != ngrt4n::RcSuccess) {
+      m_lastError = outParseNamespaces.first.value(0);
+      done(outParseNamespaces.second);
+      return;
+    }
 
-  return parseNamespaces(reply->readAll());
+    m_namespaces = outParseNamespaces.first;
+    done(ngrt4n::RcSuccess);
+  });
 }
 
 
-std::pair<QByteArray, int> K8sHelper::requestNamespacedItemsData(const QString& in_namespace, const QString& in_itemType)
+void K8sHelper::requestNamespacedItemsData(const QString& in_namespace, const QString& in_itemType, const ItemsDataHandlerT& handler)
 {
   //prepare http request
   QNetworkRequest networkRequest;
@@ -139,33 +151,24 @@ std::pair<QByteArray, int> K8sHelper::requestNamespacedItemsData(const QString&
 
   networkRequest.setUrl( QUrl(QString("%1/namespaces/%2/%3").arg(m_apiUrl, in_namespace, in_itemType)));
 
-  // make request and conncet to the processing handlers
-  QNetworkReply* reply = QNetworkAccessManager::get(networkRequest);
-  connect(reply, SIGNAL(finished()), &m_eventLoop, SLOT(quit()));
-  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(exitEventLoop(QNetworkReply::NetworkError)));
-
+  // make request and continue once it is finished
+  QNetworkReply* reply = HttpTransport::local()->get(networkRequest);
   setNetworkReplySslOptions(reply, m_verifySslPeer);
 
-  // wait synchronously before continuing
-  m_eventLoop.exec();
+  HttpTransport::whenFinished(reply, this, [handler](QNetworkReply* finishedReply) {
+    finishedReply->deleteLater();
 
-  if (! reply) {
-    auto&& errorMsg = QByteArray("Unexpected NULL QNetworkReply");
-    return std::make_pair(errorMsg, ngrt4n::RcRpcError);
-  }
-
-  reply->deleteLater();
-
-  if (reply->error() != QNetworkReply::NoError) {
-    return std::make_pair(reply->errorString().toLatin1(), ngrt4n::RcRpcError);
-  }
+    if (finishedReply->error() != QNetworkReply::NoError) {
+      handler(std::make_pair(finishedReply->errorString().toLatin1(), static_cast<int>(ngrt4n::RcRpcError)));
+      return;
+    }
 
-  return std::make_pair(reply->readAll(), ngrt4n::RcSuccess);
+    handler(std::make_pair(finishedReply->readAll(), static_cast<int>(ngrt4n::RcSuccess)));
+  });
 }
 
 
 
-
 std::pair<QStringList, int> K8sHelper::parseNamespaces(const QByteArray& data)
 {
   QJsonParseError parserError;
@@ -469,7 +472,7 @@ void K8sHelper::setNetworkReplySslOptions(QNetworkReply* reply, bool verifyPeerO
     reply->ignoreSslErrors();
   }
 
-  reply->setSslConfiguration(sslConfig);
+  HttpTransport::setSslConfiguration(reply, sslConfig);
 }
 
 
@@ -27,19 +27,24 @@
 #include "core/src/Base.hpp"
 #include <QStringList>
 #include <QString>
-#include <QNetworkAccessManager>
+#include "HttpTransport.hpp"
 #include <QNetworkReply>
 
 
-class K8sHelper : public QNetworkAccessManager
+class K8sHelper : public QObject
 {
   Q_OBJECT
 
 public:
+  typedef std::function<void(const std::pair<QByteArray, int>&)> ItemsDataHandlerT;
+
   K8sHelper(const QString& apiUrl, bool verifySslPeer);
-  std::pair<QString, int> loadNamespaceView(const QString& in_namespace, CoreDataT& out_cdata);
-  std::pair<QStringList, int> listNamespaces();
-  std::pair<QByteArray, int> requestNamespacedItemsData(const QString& in_namespace, const QString& in_itemType);
+  void loadNamespaceView(const QString& in_namespace, const HttpTransport::DoneHandlerT& done);
+  void listNamespaces(const HttpTransport::DoneHandlerT& done);
+  void requestNamespacedItemsData(const QString& in_namespace, const QString& in_itemType, const ItemsDataHandlerT& handler);
+  const CoreDataT& cdata(void) const {return m_cdata;}
+  const QStringList& namespaces(void) const {return m_namespaces;}
+  QString lastError(void) const {return m_lastError;}
   std::tuple<int,  std::string, std::string> extractStateInfo(const QJsonObject& state);
   std::pair<QStringList, int> parseNamespaces(const QByteArray& data);
 
@@ -54,14 +59,12 @@ public:
                                               NodeListT& out_bpnodes,
                                               NodeListT& out_cnodes);
 
-
-public Q_SLOTS:
-  void exitEventLoop(const QNetworkReply::NetworkError& code) { m_eventLoop.exit(code);}
-
 private:
   QString m_apiUrl;
   bool m_verifySslPeer;
-  QEventLoop m_eventLoop;
+  CoreDataT m_cdata;
+  QStringList m_namespaces;
+  QString m_lastError;
   void setNetworkReplySslOptions(QNetworkReply* reply, bool verifyPeerOption);
   QSet<QString> findMatchingService(const QMap<QString, QMap<QString, QString>>& allServicesSelectors, const QMap<QString, QVariant>& podLabels);
   int convertToPodPhaseStatusEnum(const QString& podPhaseStatusText);
@@ -50,34 +50,62 @@ int LsHelper::setupSocket(void)
   return ngrt4n::RcSuccess;
 }
 
-QByteArray LsHelper::prepareRequestData(ReqTypeT requestType)
+QByteArray LsHelper::prepareRequestData(ReqTypeT requestType, const QStringList& hostOrGroupFilters)
 {
   QString request = "";
+  QString hostColumn = "";
+  QString groupsColumn = "";
   switch(requestType) {
     case LsHelper::Host:
       request = "GET hosts\n"
                 "Columns: name state last_state_change check_command plugin_output groups\n"
                 "OutputFormat: json\n";
+      hostColumn = "name";
+      groupsColumn = "groups";
       break;
     case LsHelper::Service:
       request = "GET services\n"
                 "Columns: host_name service_description state last_state_change check_command plugin_output host_groups\n"
                 "OutputFormat: json\n";
+      hostColumn = "host_name";
+      groupsColumn = "host_groups";
       break;
     default:
       break;
   }
+
+  // let livestatus select the entries matching any of the hosts or groups
+  if (! hostOrGroupFilters.isEmpty() && ! hostColumn.isEmpty()) {
+    for (const auto& filter : hostOrGroupFilters) {
+      request.append(QString("Filter: %1 = %2\n").arg(hostColumn, filter));
+      request.append(QString("Filter: %1 >= %2\n").arg(groupsColumn, filter));
+    }
+    request.append(QString("Or: %1\n").arg(2 * hostOrGroupFilters.size()));
+  }
+
   return ngrt4n::toByteArray(request.append("\n"));
 }
 
 int LsHelper::loadChecks(const QString& hostgroupFilter, ChecksT& checks)
 {
-  m_hostOrGroupFilter = hostgroupFilter.toStdString();
+  QStringList hostOrGroupFilters;
+  if (! hostgroupFilter.isEmpty()) {
+    hostOrGroupFilters.push_back(hostgroupFilter);
+  }
+  return loadChecks(hostOrGroupFilters, checks);
+}
+
+int LsHelper::loadChecks(const QStringList& hostOrGroupFilters, ChecksT& checks)
+{
+  m_hostOrGroupFilters.clear();
+  for (const auto& filter : hostOrGroupFilters) {
+    m_hostOrGroupFilters.insert(filter.toStdString());
+  }
   checks.clear();
-  if (makeRequest(prepareRequestData(LsHelper::Host), checks) != 0) {
+  if (makeRequest(prepareRequestData(LsHelper::Host, hostOrGroupFilters), checks) != 0) {
     return ngrt4n::RcRpcError;
   }
-  return makeRequest(prepareRequestData(LsHelper::Service), checks);
+  return makeRequest(prepareRequestData(LsHelper::Service, hostOrGroupFilters), checks);
 }
 
 
@@ -91,6 +119,20 @@ int LsHelper::makeRequest(const QByteArray& data, ChecksT& checks)
 }
 
 
+bool LsHelper::matchesFilters(const CheckT& check) const
+{
+  if (m_hostOrGroupFilters.empty() || m_hostOrGroupFilters.count(check.host) > 0) {
+    return true;
+  }
+  for (const auto& group : QString::fromStdString(check.host_groups).split(",")) {
+    if (m_hostOrGroupFilters.count(group.toStdString()) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
 void LsHelper::parseResult(ChecksT& checks)
 {
   JsonHelper json(m_socketHandler->lastResult());
@@ -139,9 +181,7 @@ void LsHelper::parseResult(ChecksT& checks)
         break;
     }
 
-    if (m_hostOrGroupFilter.empty() ||
-        (! m_hostOrGroupFilter.empty() && m_hostOrGroupFilter == check.host ) ||
-        (! m_hostOrGroupFilter.empty() && m_hostOrGroupFilter == check.host_groups )) {
+    if (matchesFilters(check)) {
       checks.insert(check.id, check);
     }
 
@@ -27,6 +27,7 @@
 
 #include "Base.hpp"
 #include "RawSocket.hpp"
+#include <set>
 
 class LsHelper
 {
@@ -41,15 +42,18 @@ public:
 
   int makeRequest(const QByteArray& data, ChecksT& checks);
   int loadChecks(const QString& hostgroupFilter, ChecksT& checks);
+  int loadChecks(const QStringList& hostOrGroupFilters, ChecksT& checks);
   QString lastError(void) const {return m_socketHandler->lastError();}
   int setupSocket(void);
 
   void parseResult(ChecksT& checks);
-  static QByteArray prepareRequestData(ReqTypeT requestType);
+  static QByteArray prepareRequestData(ReqTypeT requestType, const QStringList& hostOrGroupFilters = QStringList());
 
 private:
   RawSocket* m_socketHandler;
-  std::string m_hostOrGroupFilter;
+  std::set<std::string> m_hostOrGroupFilters;
+
+  bool matchesFilters(const CheckT& check) const;
 };
 
 #endif // MKLSHELPER_HPP
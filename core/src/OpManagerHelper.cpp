@@ -29,13 +29,15 @@
 #include <QtScript/QScriptEngine>
 #include <QDebug>
 #include <QSslConfiguration>
+#include <QSet>
 
 
 const RequestListT OpManagerHelper::ReqPatterns = OpManagerHelper::requestsPatterns();
 
 
 OpManagerHelper::OpManagerHelper(const QString& baseUrl)
-  : QNetworkAccessManager()
+  : QObject(),
+    m_pendingReplies(0)
 {
   setBaseUrl(baseUrl);
   m_reqHandler.setUrl(QUrl(m_apiUri));
@@ -57,20 +59,17 @@ OpManagerHelper::setBaseUrl(const QString& url)
   m_reqHandler.setUrl(QUrl(m_apiUri));
 }
 
-QNetworkReply*
-OpManagerHelper::postRequest(int reqId, const QStringList& params)
+void
+OpManagerHelper::postRequest(int reqId, const QStringList& params, const HttpTransport::ReplyHandlerT& handler)
 {
   QString requestContext = ReqPatterns[reqId];
   Q_FOREACH(const QString& param, params) { requestContext = requestContext.arg(param); }
   QString reqUrl = QString("%1%2").arg(m_apiUri, requestContext);
   m_reqHandler.setUrl(QUrl(reqUrl));
 
-  QNetworkReply* reply = QNetworkAccessManager::get(m_reqHandler);
+  QNetworkReply* reply = HttpTransport::local()->get(m_reqHandler);
   setSslReplyErrorHandlingOptions(reply);
-  connect(reply, SIGNAL(finished()), &m_evlHandler, SLOT(quit()));
-  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(processError(QNetworkReply::NetworkError)));
-  m_evlHandler.exec();
-  return reply;
+  HttpTransport::whenFinished(reply, this, handler);
 }
 
 RequestListT
@@ -105,49 +104,88 @@ OpManagerHelper::setSslPeerVerification(bool verifyPeer)
 }
 
 
-int
-OpManagerHelper::loadChecks(const SourceT& srcInfo, int filterType, const QString& filter, ChecksT& checks)
+void
+OpManagerHelper::loadChecks(const SourceT& srcInfo, const QStringList& deviceNamesOrGroups, const HttpTransport::DoneHandlerT& done)
 {
-  checks.clear();
+  m_checks.clear();
 
   setBaseUrl(srcInfo.mon_url);
   setApiKey(srcInfo.auth);
 
-  QStringList params(m_apiKey);
-  if (filterType != ListAllDevices) params.push_back(filter);
-  QNetworkReply* reply = postRequest(filterType, params);
+  // the API has no multi-device filter: the device list is fetched once and filtered here
+  postRequest(ListAllDevices, QStringList(m_apiKey), [this, deviceNamesOrGroups, done](QNetworkReply* reply) {
+    processDevicesReply(reply, deviceNamesOrGroups, done);
+  });
+}
 
+
+void
+OpManagerHelper::processDevicesReply(QNetworkReply* reply, const QStringList& deviceNamesOrGroups, const HttpTransport::DoneHandlerT& done)
+{
   reply->deleteLater();
   QString data = reply->readAll();
   if (reply->error() != QNetworkReply::NoError) {
     m_lastError = reply->errorString();
-    return ngrt4n::RcGenericFailure;
+    done(ngrt4n::RcGenericFailure);
+    return;
   }
 
   if (checkJsonData(data)) {
-    return ngrt4n::RcGenericFailure;
+    done(ngrt4n::RcGenericFailure);
+    return;
   }
 
-  processDevicesJsonData(JsonHelper(data).data(), checks);
-  Q_FOREACH(const CheckT& check, checks) { fetchAndAppendDeviceMonitors(check.host, check.host_groups, checks); }
+  ChecksT devices;
+  processDevicesJsonData(JsonHelper(data).data(), devices);
+
+  QSet<QString> filterSet = deviceNamesOrGroups.toSet();
+  Q_FOREACH(const CheckT& device, devices) {
+    bool selected = filterSet.isEmpty() || filterSet.contains(QString::fromStdString(device.host));
+    if (! selected) {
+      Q_FOREACH(const QString& group, QString::fromStdString(device.host_groups).split(",")) {
+        if (filterSet.contains(group)) {
+          selected = true;
+          break;
+        }
+      }
+    }
+    if (selected) {
+      m_checks.insert(device.id, device);
+    }
+  }
 
-  return ngrt4n::RcSuccess;
+  // monitors can only be retrieved per device, the devices are all requested at once
+  ChecksT selectedDevices = m_checks;
+  m_pendingReplies = selectedDevices.size();
+  if (m_pendingReplies == 0) {
+    done(ngrt4n::RcSuccess);
+    return;
+  }
+  Q_FOREACH(const CheckT& device, selectedDevices) {
+    std::string deviceName = device.host;
+    std::string deviceGroups = device.host_groups;
+    QStringList params = (QStringList() << m_apiKey << deviceName.c_str());
+    postRequest(ListDeviceAssociatedMonitors, params, [this, deviceName, deviceGroups, done](QNetworkReply* monitorsReply) {
+      // a device whose monitors can't be read keeps its ping status
+      processDeviceMonitorsReply(monitorsReply, deviceName, deviceGroups);
+      if (--m_pendingReplies == 0) {
+        done(ngrt4n::RcSuccess);
+      }
+    });
+  }
 }
 
 
 int
-OpManagerHelper::fetchAndAppendDeviceMonitors(const std::string& deviceName, const std::string& deviceGroups, ChecksT& checks)
+OpManagerHelper::processDeviceMonitorsReply(QNetworkReply* reply, const std::string& deviceName, const std::string& deviceGroups)
 {
-  QStringList params = (QStringList() << m_apiKey << deviceName.c_str());
-  QNetworkReply* reply = postRequest(ListDeviceAssociatedMonitors, params);
-
   reply->deleteLater();
   QString data = reply->readAll();
 
   if (checkJsonData(data))
     return ngrt4n::RcGenericFailure;
 
-  processMonitorsJsonData(JsonHelper(data).data(), deviceName, deviceGroups, checks);
+  processMonitorsJsonData(JsonHelper(data).data(), deviceName, deviceGroups, m_checks);
 
   return ngrt4n::RcSuccess;
 }
@@ -157,7 +195,7 @@ OpManagerHelper::fetchAndAppendDeviceMonitors(const std::string& deviceName, con
 void
 OpManagerHelper::setSslReplyErrorHandlingOptions(QNetworkReply* reply)
 {
-  reply->setSslConfiguration(m_sslConfig);
+  HttpTransport::setSslConfiguration(reply, m_sslConfig);
   if (m_sslConfig.peerVerifyMode() == QSslSocket::VerifyNone)
     reply->ignoreSslErrors();
 }
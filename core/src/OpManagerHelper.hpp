@@ -27,7 +27,7 @@
 #include "Base.hpp"
 #include "JsonHelper.hpp"
 #include <QtNetwork/QNetworkReply>
-#include <QtNetwork/QNetworkAccessManager>
+#include "HttpTransport.hpp"
 #include <QtNetwork/QSslConfiguration>
 
 
@@ -35,7 +35,7 @@ namespace {
   const QString OPMANAGER_API_CONTEXT = "api/json";
 }
 
-class OpManagerHelper : public QNetworkAccessManager {
+class OpManagerHelper : public QObject {
     Q_OBJECT
   public:
     enum {
@@ -50,28 +50,25 @@ class OpManagerHelper : public QNetworkAccessManager {
   public:
     OpManagerHelper(const QString& baseUrl="http://localhost/");
     virtual ~OpManagerHelper();
-    int loadChecks(const SourceT& srcInfo, int filterType, const QString& filter, ChecksT& checks);
+    void loadChecks(const SourceT& srcInfo, const QStringList& deviceNamesOrGroups, const HttpTransport::DoneHandlerT& done);
+    const ChecksT& checks(void) const {return m_checks;}
     QString lastError(void) const {return m_lastError;}
 
 
-  public Q_SLOTS:
-    void processError(const QNetworkReply::NetworkError& code) { m_evlHandler.exit(code);}
-
-  Q_SIGNALS:
-    void propagateError(QNetworkReply::NetworkError);
-
   private :
     static RequestListT requestsPatterns();
     QString m_apiUri;
     QString m_apiKey;
     QNetworkRequest m_reqHandler;
-    QEventLoop m_evlHandler;
     QSslConfiguration m_sslConfig;
     QString m_lastError;
     QString m_replyData;
+    ChecksT m_checks;
+    int m_pendingReplies;
 
-    QNetworkReply* postRequest(int reqId, const QStringList& params);
-    int fetchAndAppendDeviceMonitors(const std::string& deviceName, const std::string& deviceGroups, ChecksT& checks);
+    void postRequest(int reqId, const QStringList& params, const HttpTransport::ReplyHandlerT& handler);
+    void processDevicesReply(QNetworkReply* reply, const QStringList& deviceNamesOrGroups, const HttpTransport::DoneHandlerT& done);
+    int processDeviceMonitorsReply(QNetworkReply* reply, const std::string& deviceName, const std::string& deviceGroups);
     void setBaseUrl(const QString& url);
     void setApiKey(const QString& key) {m_apiKey = key;}
     void setSslPeerVerification(bool verifyPeer);
@@ -28,6 +28,7 @@
 #include <QtScript/QScriptValueIterator>
 #include <QtScript/QScriptEngine>
 #include <QDebug>
+#include <QSet>
 #include <QSslConfiguration>
 
 
@@ -35,10 +36,9 @@ const RequestListT PandoraHelper::ReqPatterns = PandoraHelper::requestsPatterns(
 
 
 PandoraHelper::PandoraHelper(const QString & baseUrl)
-  : QNetworkAccessManager(),
+  : QObject(),
     m_reqHandler(new QNetworkRequest()),
     m_pandoraVersion("UNKNOWN"),
-    m_evlHandler(new QEventLoop(this)),
     m_isLogged(false)
 {
   setBaseUrl(baseUrl);
@@ -49,7 +49,6 @@ PandoraHelper::PandoraHelper(const QString & baseUrl)
 PandoraHelper::~PandoraHelper()
 {
   delete m_reqHandler;
-  delete m_evlHandler;
 }
 
 void
@@ -59,8 +58,8 @@ PandoraHelper::setBaseUrl(const QString& url)
   m_reqHandler->setUrl(QUrl(m_apiUri));
 }
 
-QNetworkReply*
-PandoraHelper::postRequest(int reqId, const QStringList& params)
+void
+PandoraHelper::postRequest(int reqId, const QStringList& params, const HttpTransport::ReplyHandlerT& handler)
 {
   QString request = ReqPatterns[reqId];
   Q_FOREACH(const QString &param, params) {
@@ -69,12 +68,9 @@ PandoraHelper::postRequest(int reqId, const QStringList& params)
 
   request = request.arg(m_pandoraApiPass, m_pandoraUsername, m_pandoraPassword);
 
-  QNetworkReply* reply = QNetworkAccessManager::post(*m_reqHandler, ngrt4n::toByteArray(request));
+  QNetworkReply* reply = HttpTransport::local()->post(*m_reqHandler, ngrt4n::toByteArray(request));
   setSslReplyErrorHandlingOptions(reply);
-  connect(reply, SIGNAL(finished()), m_evlHandler, SLOT(quit()));
-  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(processError(QNetworkReply::NetworkError)));
-  m_evlHandler->exec();
-  return reply;
+  HttpTransport::whenFinished(reply, this, handler);
 }
 
 RequestListT
@@ -133,49 +129,53 @@ PandoraHelper::processReply(QNetworkReply* reply, QString& data)
   return 0;
 }
 
-int
-PandoraHelper::openSession(const SourceT& srcInfo)
+void
+PandoraHelper::openSession(const SourceT& srcInfo, const HttpTransport::DoneHandlerT& done)
 {
   setBaseUrl(srcInfo.mon_url);
-  if (checkCredentialsInfo(srcInfo.auth) != 0)
-    return -1;
+  if (checkCredentialsInfo(srcInfo.auth) != 0) {
+    done(-1);
+    return;
+  }
 
   setSslPeerVerification(srcInfo.verify_ssl_peer);
-  QNetworkReply* response = postRequest(LoginTest, QStringList());
-
-  if (! response)
-    return -1;
-
-  QString data;
-  return processReply(response, data);
+  postRequest(LoginTest, QStringList(), [this, done](QNetworkReply* response) {
+    QString data;
+    done(processReply(response, data));
+  });
 }
 
-int
-PandoraHelper::loadChecks(const SourceT& srcInfo, ChecksT& checks, const QString& filter)
+void
+PandoraHelper::loadChecks(const SourceT& srcInfo, const QStringList& filters, const HttpTransport::DoneHandlerT& done)
 {
-  checks.clear();
+  // the API only serves the whole agent tree, fetch it once and keep the modules of all the filters
+  m_checks.clear();
 
-  if (checkCredentialsInfo(srcInfo.auth) != 0)
-    return -1;
+  if (checkCredentialsInfo(srcInfo.auth) != 0) {
+    done(-1);
+    return;
+  }
 
   setBaseUrl(srcInfo.mon_url);
 
-  QNetworkReply* response = postRequest(GetTreeAgents, QStringList());
-
-  if (! response)
-    return -1;
-
-  return processModuleReply(response, checks, filter);
+  postRequest(GetTreeAgents, QStringList(), [this, filters, done](QNetworkReply* response) {
+    done(processModuleReply(response, m_checks, filters));
+  });
 }
 
 int
-PandoraHelper::processModuleReply(QNetworkReply* reply, ChecksT& checks, const QString& filter)
+PandoraHelper::processModuleReply(QNetworkReply* reply, ChecksT& checks, const QStringList& filters)
 {
   QString data;
   if (processReply(reply, data) != 0)
     return -1;
   QTextStream streamReader(&data, QIODevice::ReadWrite);
 
+  QSet<QString> filterSet;
+  for (const auto& filter : filters) {
+    filterSet.insert(filter);
+  }
+
   checks.clear();
   CheckT check;
   QString line;
@@ -213,7 +213,7 @@ PandoraHelper::processModuleReply(QNetworkReply* reply, ChecksT& checks, const Q
           check.alarm_msg = tr("%1 value is %2").arg(moduleName, moduleValue).toStdString();
         }
 
-        if (filter.isEmpty() || currentGroupName == filter || currentAgentName == filter) {
+        if (filterSet.isEmpty() || filterSet.contains(currentGroupName) || filterSet.contains(currentAgentName)) {
           checks.insert(check.id, check);
         }
       }
@@ -231,7 +231,7 @@ PandoraHelper::processModuleReply(QNetworkReply* reply, ChecksT& checks, const Q
 void
 PandoraHelper::setSslReplyErrorHandlingOptions(QNetworkReply* reply)
 {
-  reply->setSslConfiguration(m_sslConfig);
+  HttpTransport::setSslConfiguration(reply, m_sslConfig);
   if (m_sslConfig.peerVerifyMode() == QSslSocket::VerifyNone)
     reply->ignoreSslErrors();
 }
@@ -27,7 +27,7 @@
 #include "Base.hpp"
 #include "JsonHelper.hpp"
 #include <QtNetwork/QNetworkReply>
-#include <QtNetwork/QNetworkAccessManager>
+#include "HttpTransport.hpp"
 #include <QtNetwork/QSslConfiguration>
 
 
@@ -35,7 +35,7 @@ namespace {
   const QString PANDORAFMS_API_CONTEXT = "pandora_console/include/api.php";
   }
 
-class PandoraHelper : public QNetworkAccessManager {
+class PandoraHelper : public QObject {
   Q_OBJECT
 public:
   enum {
@@ -48,10 +48,12 @@ public:
 public:
   PandoraHelper(const QString& baseUrl="http://localhost/");
   virtual ~PandoraHelper();
-  int
-  loadChecks(const SourceT& srcInfo,  ChecksT& checks, const QString& filter);
-  QNetworkReply*
-  postRequest(int reqId, const QStringList& params);
+  void
+  loadChecks(const SourceT& srcInfo, const QStringList& filters, const HttpTransport::DoneHandlerT& done);
+  const ChecksT&
+  checks(void) const {return m_checks;}
+  void
+  postRequest(int reqId, const QStringList& params, const HttpTransport::ReplyHandlerT& handler);
   void
   setBaseUrl(const QString& url);
   QString
@@ -68,24 +70,16 @@ public:
   setSslPeerVerification(bool verifyPeer);
   int
   processReply(QNetworkReply* reply, QString& data);
+  void
+  openSession(const SourceT& srcInfo, const HttpTransport::DoneHandlerT& done);
   int
-  openSession(const SourceT& srcInfo);
-  int
-  processModuleReply(QNetworkReply* reply, ChecksT& checks, const QString& filter);
-
-
-public Q_SLOTS:
-  void processError(const QNetworkReply::NetworkError& code) { m_evlHandler->exit(code);}
-
-Q_SIGNALS:
-  void propagateError(QNetworkReply::NetworkError);
+  processModuleReply(QNetworkReply* reply, ChecksT& checks, const QStringList& filters);
 
 private :
   QString m_apiUri;
   QNetworkRequest* m_reqHandler;
   QString m_pandoraVersion;
   static RequestListT requestsPatterns();
-  QEventLoop* m_evlHandler;
   bool m_isLogged;
   QString m_pandoraUsername;
   QString m_pandoraPassword;
@@ -93,6 +87,7 @@ private :
   QSslConfiguration m_sslConfig;
   QString m_lastError;
   QString m_replyData;
+  ChecksT m_checks;
 
   void setSslReplyErrorHandlingOptions(QNetworkReply* reply);
   std::string parseHostGroups(const QScriptValue& json);
@@ -25,7 +25,7 @@
 #include "Parser.hpp"
 #include "utilsCore.hpp"
 #include "ThresholdHelper.hpp"
-#include "K8sHelper.hpp"
+#include "SourceCollector.hpp"
 #include <QObject>
 #include <QtXml>
 #include <iostream>
@@ -112,6 +112,8 @@ std::pair<int, QString> Parser::parse(const QString& viewFile)
     node.alarm_msg = ngrt4n::decodeXml( xmlNode.firstChildElement("AlarmMsg").text().trimmed() );
     node.notification_msg = ngrt4n::decodeXml( xmlNode.firstChildElement("NotificationMsg").text().trimmed() );
     node.child_nodes = ngrt4n::decodeXml( xmlNode.firstChildElement("SubServices").text().trimmed() );
+    ngrt4n::compileMessageTemplate(node.alarm_msg_tpl, node.alarm_msg);
+    ngrt4n::compileMessageTemplate(node.notification_msg_tpl, node.notification_msg);
     node.weight = (m_cdata->format_version >= 3.1) ? xmlNode.attribute("weight").toDouble() : ngrt4n::WEIGHT_UNIT;
 
     if (node.sev_crule == CalcRules::WeightedAverageWithThresholds) {
@@ -170,21 +172,33 @@ std::pair<int, QString> Parser::loadDynamicViewByGroup(QDomNodeList& inXmlDomNod
   }
 
   if (findSourceOut.second.mon_type == MonitorT::Kubernetes) {
-    auto loqdK8sNs = K8sHelper(findSourceOut.second.mon_url, findSourceOut.second.verify_ssl_peer)
-                     .loadNamespaceView(monitoredGroup, outCData);
-    if (loqdK8sNs.second != ngrt4n::RcSuccess) {
-      auto m_lastErrorMsg = QObject::tr("%1: %2").arg(findSourceOut.second.id, loqdK8sNs.first);
-      return std::make_pair(loqdK8sNs.second, m_lastErrorMsg);
+    auto loqdK8sNs = SourceCollector::shared().loadNamespaceView(findSourceOut.second, monitoredGroup).get();
+    if (loqdK8sNs.rc != ngrt4n::RcSuccess) {
+      auto m_lastErrorMsg = QObject::tr("%1: %2").arg(findSourceOut.second.id, loqdK8sNs.error);
+      return std::make_pair(loqdK8sNs.rc, m_lastErrorMsg);
     }
+    for (const auto& bpnode: loqdK8sNs.cdata.bpnodes) {
+      outCData.bpnodes.insert(bpnode.id, bpnode);
+    }
+    for (const auto& cnode: loqdK8sNs.cdata.cnodes) {
+      outCData.cnodes.insert(cnode.id, cnode);
+    }
+    for (auto host = loqdK8sNs.cdata.hosts.cbegin(); host != loqdK8sNs.cdata.hosts.cend(); ++host) {
+      outCData.hosts.insert(host.key(), host.value());
+    }
+    outCData.monitor = loqdK8sNs.cdata.monitor;
 
   } else {
     auto loadViewByGroupOut = ngrt4n::loadDynamicViewByGroup(findSourceOut.second, monitoredGroup, outCData);
-    if (loadViewByGroupOut.first == ngrt4n::RcSuccess) {
-      ngrt4n::fixupDependencies(outCData);
+    if (loadViewByGroupOut.first != ngrt4n::RcSuccess) {
+      return loadViewByGroupOut;
     }
-    return loadViewByGroupOut;
+    ngrt4n::fixupDependencies(outCData);
   }
 
+  // all the items of a dynamic view come from its single source
+  outCData.source_cnodes[sourceId] = outCData.cnodes.keys();
+
   return std::make_pair(ngrt4n::RcSuccess, "");
 }
 
@@ -372,6 +386,7 @@ void Parser::insertITServiceNode(NodeT& node)
     }
   }
   m_cdata->sources.insert(srcid);
+  m_cdata->source_cnodes[srcid] << node.id;
   m_cdata->cnodes.insert(node.id, node);
 }
 
@@ -25,12 +25,55 @@
 
 #include "Base.hpp"
 #include "RawSocket.hpp"
+#include "utilsCore.hpp"
 #include <cerrno>
 #include <QDebug>
+#include <QElapsedTimer>
+#ifndef WIN32
+#include <fcntl.h>
+#include <poll.h>
+#endif
+
+namespace {
+  /** Winsock reports its errors through WSAGetLastError(), they're turned into errno values */
+  int toErrno(int error)
+  {
+#ifdef WIN32
+    switch (error) {
+      case WSAEWOULDBLOCK: return EWOULDBLOCK;
+      case WSAEINPROGRESS: return EINPROGRESS;
+      case WSAEINTR: return EINTR;
+      case WSAETIMEDOUT: return ETIMEDOUT;
+      case WSAEHOSTUNREACH: return EHOSTUNREACH;
+      case WSAEADDRNOTAVAIL: return EADDRNOTAVAIL;
+      case WSAENETDOWN: return ENETDOWN;
+      case WSAECONNRESET: return ECONNRESET;
+      case WSAECONNREFUSED: return ECONNREFUSED;
+      default: break;
+    }
+#endif
+    return error;
+  }
+
+  /** sets errno from the error of the last failed socket call and returns it */
+  int syncSocketError(void)
+  {
+#ifdef WIN32
+    errno = toErrno(WSAGetLastError());
+#endif
+    return errno;
+  }
+
+  bool isTransientError(int error)
+  {
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+  }
+}
 
 RawSocket::RawSocket(const QString& host, uint16_t port)
   : m_host(host),
-    m_port(port)
+    m_port(port),
+    m_timeout(ngrt4n::backendTimeout())
 {
 }
 
@@ -50,32 +93,118 @@ int RawSocket::setupSocket(void)
 
 int RawSocket::makeRequest(const QByteArray& data)
 {
-  SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+  QElapsedTimer timer;
+  timer.start();
 
-  if (connect(sock, (SOCKADDR *)&m_sockAddr, sizeof(m_sockAddr)) == SOCKET_ERROR) {
+  SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock == INVALID_SOCKET) {
+    syncSocketError();
     buildErrorString();
     return ngrt4n::RcRpcError;
   }
 
-  if (send(sock, data.data(), static_cast<size_t>(data.size()), 0) < data.size()) {
-    buildErrorString();
-    return ngrt4n::RcRpcError;
+  // the socket is non-blocking so that every step is bounded by the request timeout
+#ifdef WIN32
+  u_long nonBlocking = 1;
+  ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+  fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+  if (connect(sock, (SOCKADDR *)&m_sockAddr, sizeof(m_sockAddr)) == SOCKET_ERROR) {
+    int connectState = syncSocketError();
+#ifdef WIN32
+    bool inProgress = (connectState == EWOULDBLOCK);
+#else
+    bool inProgress = (connectState == EINPROGRESS);
+#endif
+    if (! inProgress || waitForSocket(sock, POLLOUT, m_timeout - timer.elapsed()) <= 0) {
+      return failRequest(sock);
+    }
+    int connectError = 0;
+    socklen_t optionLength = sizeof(connectError);
+    getsockopt(sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&connectError), &optionLength);
+    if (connectError != 0) {
+      errno = toErrno(connectError);
+      return failRequest(sock);
+    }
+  }
+
+  const char* pending = data.data();
+  size_t remaining = static_cast<size_t>(data.size());
+  while (remaining > 0) {
+    if (waitForSocket(sock, POLLOUT, m_timeout - timer.elapsed()) <= 0) {
+      return failRequest(sock);
+    }
+    ssize_t count = send(sock, pending, remaining, 0);
+    if (count < 0) {
+      if (isTransientError(syncSocketError())) continue;
+      return failRequest(sock);
+    }
+    pending += count;
+    remaining -= static_cast<size_t>(count);
   }
 
   char buffer[BUFFER_SIZE];
   ssize_t count = 0;
   m_lastResult.clear();
-  while ((count = recv(sock, buffer, static_cast<size_t>(BUFFER_SIZE - 1), 0)) > 0) {
-    m_lastResult.append(QString::fromUtf8(buffer, static_cast<int>(count)));
+  for (;;) {
+    if (waitForSocket(sock, POLLIN, m_timeout - timer.elapsed()) <= 0) {
+      return failRequest(sock);
+    }
+    count = recv(sock, buffer, static_cast<size_t>(BUFFER_SIZE - 1), 0);
+    if (count > 0) {
+      m_lastResult.append(QString::fromUtf8(buffer, static_cast<int>(count)));
+    } else if (count == 0) {
+      break;
+    } else if (! isTransientError(syncSocketError())) {
+      m_lastError = QObject::tr("%1: failed receiving data").arg(socketAddr());
+      closesocket(sock);
+      return ngrt4n::RcRpcError;
+    }
   }
 
-  if (count < 0) {
-    m_lastError = QObject::tr("Failed receiving data");
-    return ngrt4n::RcRpcError;
+  closesocket(sock);
+  return ngrt4n::RcSuccess;
+}
+
+
+int RawSocket::waitForSocket(SOCKET sock, short events, qint64 remainingTime)
+{
+  if (remainingTime <= 0) {
+    errno = ETIMEDOUT;
+    return 0;
+  }
+
+  struct pollfd pollSocket;
+  pollSocket.fd = sock;
+  pollSocket.events = events;
+  pollSocket.revents = 0;
+  int ready = 0;
+  do {
+#ifdef WIN32
+    ready = WSAPoll(&pollSocket, 1, static_cast<int>(remainingTime));
+#else
+    ready = poll(&pollSocket, 1, static_cast<int>(remainingTime));
+#endif
+  } while (ready < 0 && syncSocketError() == EINTR);
+
+  if (ready == 0) {
+    errno = ETIMEDOUT;
   }
+  return ready;
+}
+
 
+int RawSocket::failRequest(SOCKET sock)
+{
+  if (errno == ETIMEDOUT) {
+    m_lastError = QObject::tr("%1: no response within %2 ms").arg(socketAddr()).arg(m_timeout);
+  } else {
+    buildErrorString();
+  }
   closesocket(sock);
-  return ngrt4n::RcSuccess;
+  return ngrt4n::RcRpcError;
 }
 
 void RawSocket::buildErrorString(void)
@@ -60,6 +60,7 @@ public:
   ~RawSocket();
   int setupSocket();
   int makeRequest(const QByteArray& data);
+  void setTimeout(int timeout) {m_timeout = timeout;}
   QString& lastResult(void) {return m_lastResult;}
   QString lastError(void) const {return m_lastError;}
   QString socketAddr(void) const {return QString("%1:%2").arg(m_host, QString::number(m_port));}
@@ -70,8 +71,11 @@ private:
   QString m_host;
   uint16_t m_port;
   SOCKADDR_IN m_sockAddr;
+  int m_timeout; // in milliseconds, bounds a whole request
 
   void buildErrorString(void);
+  int waitForSocket(SOCKET sock, short events, qint64 remainingTime);
+  int failRequest(SOCKET sock);
 };
 
 #endif // RAWSOCKET_HPP
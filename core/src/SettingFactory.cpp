@@ -40,6 +40,8 @@ const QString SettingFactory::DB_SERVER_PORT = "/Database/dbServerPort";
 const QString SettingFactory::DB_NAME = "/Database/dbName";
 const QString SettingFactory::DB_USER = "/Database/dbUser";
 const QString SettingFactory::DB_PASSWORD = "/Database/dbPassword";
+const QString SettingFactory::DB_POOL_SIZE = "/Database/dbPoolSize";
+const QString SettingFactory::DB_POOL_WAIT_TIMEOUT = "/Database/dbPoolWaitTimeout";
 
 
 const QString SettingFactory::AUTH_MODE_KEY = "/Auth/authMode";
@@ -52,6 +54,7 @@ const QString SettingFactory::AUTH_LDAP_ID_FIELD = "/Auth/ldapIdField";
 const QString SettingFactory::AUTH_LDAP_SSL_USE_CERT = "/Auth/ldapSslUseCert";
 const QString SettingFactory::AUTH_LDAP_SSL_CERT_FILE = "/Auth/ldapSslCertFile";
 const QString SettingFactory::AUTH_LDAP_SSL_CA_FILE = "/Auth/ldapSslCaFile";
+const QString SettingFactory::AUTH_LDAP_CACHE_TTL = "/Auth/ldapCacheTtl";
 
 const QString SettingFactory::NOTIF_TYPE = "/Notification/notificationType";
 const QString SettingFactory::NOTIF_MAIL_SMTP_SERVER_ADRR = "/Notification/mailSmtpServer";
@@ -61,6 +64,14 @@ const QString SettingFactory::NOTIF_MAIL_SMTP_USERNAME = "/Notification/mailSmtp
 const QString SettingFactory::NOTIF_MAIL_SMTP_PASSWORD = "/Notification/mailSmtpPassword";
 
 const QString SettingFactory::DASHBOARD_THUMBNAILS_PER_ROW = "/Dashboard/thumbnailsPerRow";
+const QString SettingFactory::DASHBOARD_MAX_LOADED_VIEWS = "/Dashboard/maxLoadedViews";
+
+const QString SettingFactory::REPORTING_QOS_COMPRESSION = "/Reporting/qosCompression";
+const QString SettingFactory::REPORTING_QOS_EPSILON = "/Reporting/qosEpsilon";
+const QString SettingFactory::REPORTING_QOS_HEARTBEAT = "/Reporting/qosHeartbeat";
+const QString SettingFactory::REPORTING_QOS_STORE_DIR = "/Reporting/qosStoreDir";
+const QString SettingFactory::REPORTING_STATUS_SNAPSHOT = "/Reporting/statusSnapshot";
+const QString SettingFactory::REPORTING_SHARED_STATUS = "/Reporting/sharedStatus";
 
 
 SettingFactory::SettingFactory(): QSettings(COMPANY.toLower(), APP_NAME.toLower().replace(" ", "-"))
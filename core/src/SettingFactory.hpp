@@ -45,6 +45,8 @@ public:
   static const QString DB_NAME;
   static const QString DB_USER;
   static const QString DB_PASSWORD;
+  static const QString DB_POOL_SIZE;
+  static const QString DB_POOL_WAIT_TIMEOUT;
 
   static const QString AUTH_MODE_KEY;
   static const QString AUTH_LDAP_SERVER_URI;
@@ -56,6 +58,7 @@ public:
   static const QString AUTH_LDAP_SSL_USE_CERT;
   static const QString AUTH_LDAP_SSL_CERT_FILE;
   static const QString AUTH_LDAP_SSL_CA_FILE;
+  static const QString AUTH_LDAP_CACHE_TTL;
 
   static const QString NOTIF_TYPE;
   static const QString NOTIF_MAIL_SMTP_SERVER_ADRR;
@@ -65,6 +68,14 @@ public:
   static const QString NOTIF_MAIL_SMTP_PASSWORD;
 
   static const QString DASHBOARD_THUMBNAILS_PER_ROW;
+  static const QString DASHBOARD_MAX_LOADED_VIEWS;
+
+  static const QString REPORTING_QOS_COMPRESSION;
+  static const QString REPORTING_QOS_EPSILON;
+  static const QString REPORTING_QOS_HEARTBEAT;
+  static const QString REPORTING_QOS_STORE_DIR;
+  static const QString REPORTING_STATUS_SNAPSHOT;
+  static const QString REPORTING_SHARED_STATUS;
 
   SettingFactory();
 
@@ -0,0 +1,237 @@
+/*
+ * SourceCollector.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "SourceCollector.hpp"
+#include "utilsCore.hpp"
+#include "LsHelper.hpp"
+#include "ZbxHelper.hpp"
+#include "ZnsHelper.hpp"
+#include "PandoraHelper.hpp"
+#include "OpManagerHelper.hpp"
+#include "K8sHelper.hpp"
+#include <QCoreApplication>
+#include <QtConcurrentRun>
+#include <memory>
+
+namespace {
+  /** a task run from the event loop of the collector thread */
+  class TaskEvent : public QEvent
+  {
+  public:
+    static const QEvent::Type Type;
+    explicit TaskEvent(const std::function<void()>& task) : QEvent(Type), task(task) {}
+    std::function<void()> task;
+  };
+  const QEvent::Type TaskEvent::Type = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+  SourceCollector::ResultT failedResult(const QString& error)
+  {
+    SourceCollector::ResultT result;
+    result.rc = ngrt4n::RcGenericFailure;
+    result.error = error;
+    return result;
+  }
+
+  /** called from the last continuation of the helper, which can't be deleted right away */
+  template<typename HelperT>
+  void completeLoad(HelperT* helper, int rc, SourceCollector::ResultT& result, const SourceCollector::ContinuationT& continuation)
+  {
+    result.rc = rc;
+    result.error = (rc == ngrt4n::RcSuccess) ? QString() : helper->lastError();
+    helper->deleteLater();
+    continuation(result);
+  }
+}
+
+
+SourceCollector::SourceCollector(void)
+  : QObject()
+{
+  m_thread.setObjectName("SourceCollector");
+  moveToThread(&m_thread);
+  m_thread.start();
+}
+
+
+SourceCollector::~SourceCollector()
+{
+  m_thread.quit();
+  m_thread.wait();
+}
+
+
+SourceCollector& SourceCollector::shared(void)
+{
+  static SourceCollector collector;
+  return collector;
+}
+
+
+bool SourceCollector::event(QEvent* event)
+{
+  if (event->type() == TaskEvent::Type) {
+    static_cast<TaskEvent*>(event)->task();
+    return true;
+  }
+  return QObject::event(event);
+}
+
+
+void SourceCollector::post(const std::function<void()>& task)
+{
+  QCoreApplication::postEvent(this, new TaskEvent(task));
+}
+
+
+std::future<SourceCollector::ResultT> SourceCollector::toFuture(const std::function<void(const ContinuationT&)>& load)
+{
+  // waiting there would hold the event loop running the load
+  Q_ASSERT(QThread::currentThread() != &m_thread);
+
+  auto promise = std::make_shared<std::promise<ResultT> >();
+  std::future<ResultT> future = promise->get_future();
+  load([promise](const ResultT& result) { promise->set_value(result); });
+  return future;
+}
+
+
+void SourceCollector::loadDataItems(const SourceT& sinfo, const QStringList& filters, const ContinuationT& continuation)
+{
+  if (sinfo.mon_type == MonitorT::Nagios) {
+    QtConcurrent::run(ngrt4n::collectorPool(), [sinfo, filters, continuation]() {
+      ResultT result;
+      LsHelper handler(sinfo.ls_addr, static_cast<uint16_t>(sinfo.ls_port));
+      result.rc = ngrt4n::RcGenericFailure;
+      if (handler.setupSocket() == 0 && handler.loadChecks(filters, result.checks) == 0) {
+        result.rc = ngrt4n::RcSuccess;
+      }
+      result.error = handler.lastError();
+      continuation(result);
+    });
+    return;
+  }
+
+  // Kubernetes, the views are built from the namespaces and not from data points
+  if (sinfo.mon_type == MonitorT::Kubernetes) {
+    continuation(failedResult(QObject::tr("Loading data points is not supported for Kubernetes sources: %1").arg(sinfo.id)));
+    return;
+  }
+
+  post([sinfo, filters, continuation]() {
+    if (sinfo.mon_type == MonitorT::Zabbix) {
+      auto helper = new ZbxHelper();
+      helper->loadChecks(sinfo, filters, [helper, continuation](int rc) {
+        ResultT result;
+        result.checks = helper->checks();
+        completeLoad(helper, rc, result, continuation);
+      });
+    } else if (sinfo.mon_type == MonitorT::Zenoss) {
+      auto helper = new ZnsHelper(sinfo.mon_url);
+      helper->loadChecks(sinfo, filters, [helper, continuation](int rc) {
+        ResultT result;
+        result.checks = helper->checks();
+        completeLoad(helper, rc, result, continuation);
+      });
+    } else if (sinfo.mon_type == MonitorT::Pandora) {
+      auto helper = new PandoraHelper(sinfo.mon_url);
+      helper->loadChecks(sinfo, filters, [helper, continuation](int rc) {
+        ResultT result;
+        result.checks = helper->checks();
+        completeLoad(helper, rc, result, continuation);
+      });
+    } else if (sinfo.mon_type == MonitorT::OpManager) {
+      auto helper = new OpManagerHelper(sinfo.mon_url);
+      helper->loadChecks(sinfo, filters, [helper, continuation](int rc) {
+        ResultT result;
+        result.checks = helper->checks();
+        completeLoad(helper, rc, result, continuation);
+      });
+    } else {
+      continuation(failedResult(QObject::tr("Cannot load data points for unknown data source: %1").arg(sinfo.mon_type)));
+    }
+  });
+}
+
+
+void SourceCollector::loadNamespaceView(const SourceT& sinfo, const QString& k8sNamespace, const ContinuationT& continuation)
+{
+  post([sinfo, k8sNamespace, continuation]() {
+    auto helper = new K8sHelper(sinfo.mon_url, sinfo.verify_ssl_peer);
+    helper->loadNamespaceView(k8sNamespace, [helper, continuation](int rc) {
+      ResultT result;
+      result.cdata = helper->cdata();
+      completeLoad(helper, rc, result, continuation);
+    });
+  });
+}
+
+
+void SourceCollector::listNamespaces(const SourceT& sinfo, const ContinuationT& continuation)
+{
+  post([sinfo, continuation]() {
+    auto helper = new K8sHelper(sinfo.mon_url, sinfo.verify_ssl_peer);
+    helper->listNamespaces([helper, continuation](int rc) {
+      ResultT result;
+      result.namespaces = helper->namespaces();
+      completeLoad(helper, rc, result, continuation);
+    });
+  });
+}
+
+
+void SourceCollector::loadITServices(const SourceT& sinfo, const ContinuationT& continuation)
+{
+  post([sinfo, continuation]() {
+    auto helper = new ZbxHelper();
+    helper->loadITServices(sinfo, [helper, continuation](int rc) {
+      ResultT result;
+      result.cdata = helper->cdata();
+      completeLoad(helper, rc, result, continuation);
+    });
+  });
+}
+
+
+std::future<SourceCollector::ResultT> SourceCollector::loadDataItems(const SourceT& sinfo, const QStringList& filters)
+{
+  return toFuture([this, sinfo, filters](const ContinuationT& continuation) { loadDataItems(sinfo, filters, continuation); });
+}
+
+
+std::future<SourceCollector::ResultT> SourceCollector::loadNamespaceView(const SourceT& sinfo, const QString& k8sNamespace)
+{
+  return toFuture([this, sinfo, k8sNamespace](const ContinuationT& continuation) { loadNamespaceView(sinfo, k8sNamespace, continuation); });
+}
+
+
+std::future<SourceCollector::ResultT> SourceCollector::listNamespaces(const SourceT& sinfo)
+{
+  return toFuture([this, sinfo](const ContinuationT& continuation) { listNamespaces(sinfo, continuation); });
+}
+
+
+std::future<SourceCollector::ResultT> SourceCollector::loadITServices(const SourceT& sinfo)
+{
+  return toFuture([this, sinfo](const ContinuationT& continuation) { loadITServices(sinfo, continuation); });
+}
@@ -0,0 +1,83 @@
+/*
+ * SourceCollector.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef SOURCECOLLECTOR_HPP
+#define SOURCECOLLECTOR_HPP
+
+#include "Base.hpp"
+#include <QEvent>
+#include <QObject>
+#include <QThread>
+#include <functional>
+#include <future>
+
+/**
+ * Loads the data of the monitoring sources without ever blocking on the network. The HTTP
+ * helpers (Zabbix, Zenoss, Pandora FMS, OpManager and Kubernetes) all run in the collector
+ * thread, whose event loop drives the requests of all the sources being loaded at once: each
+ * helper chains its requests through continuations, and is deleted once it is done. Livestatus
+ * only has a blocking client, so the Nagios sources are loaded on the collector pool instead.
+ *
+ * A load yields its result either to a continuation, called from the collector thread or from
+ * a pool thread, or through a future. A future must not be waited for from the collector thread.
+ */
+class SourceCollector : public QObject
+{
+  Q_OBJECT
+
+public:
+  struct ResultT {
+    int rc;
+    QString error;
+    ChecksT checks;
+    CoreDataT cdata; // Kubernetes namespace views and Zabbix IT services
+    QStringList namespaces; // Kubernetes namespaces
+  };
+  typedef std::function<void(const ResultT&)> ContinuationT;
+
+  static SourceCollector& shared(void);
+
+  void loadDataItems(const SourceT& sinfo, const QStringList& filters, const ContinuationT& continuation);
+  void loadNamespaceView(const SourceT& sinfo, const QString& k8sNamespace, const ContinuationT& continuation);
+  void listNamespaces(const SourceT& sinfo, const ContinuationT& continuation);
+  void loadITServices(const SourceT& sinfo, const ContinuationT& continuation);
+
+  std::future<ResultT> loadDataItems(const SourceT& sinfo, const QStringList& filters);
+  std::future<ResultT> loadNamespaceView(const SourceT& sinfo, const QString& k8sNamespace);
+  std::future<ResultT> listNamespaces(const SourceT& sinfo);
+  std::future<ResultT> loadITServices(const SourceT& sinfo);
+
+protected:
+  bool event(QEvent* event);
+
+private:
+  QThread m_thread;
+
+  SourceCollector(void);
+  ~SourceCollector();
+  void post(const std::function<void()>& task);
+  std::future<ResultT> toFuture(const std::function<void(const ContinuationT&)>& load);
+};
+
+#endif // SOURCECOLLECTOR_HPP
@@ -10,28 +10,19 @@ StatusAggregator::StatusAggregator(void)
 
 void StatusAggregator::resetData(void)
 {
-  m_severityWeightsMap.clear();
   m_thresholdExceededMsg.clear();
-  m_statusRatios.clear();
   m_count = 0;
   m_essentialCount = 0;
   m_nonEssentialTotalWeight = 0;
   m_minSeverity = 0;
   m_maxSeverity = 0;
   m_maxEssential = 0;
+  m_ratiosUpToDate = true;
 
-  m_severityWeightsMap[ngrt4n::Normal] = 0.0;
-  m_severityWeightsMap[ngrt4n::Minor] = 0.0;
-  m_severityWeightsMap[ngrt4n::Major] = 0.0;
-  m_severityWeightsMap[ngrt4n::Critical] = 0.0;
-  m_severityWeightsMap[ngrt4n::Unknown] = 0.0;
-
-  m_statusRatios[ngrt4n::Normal] = 0.0;
-  m_statusRatios[ngrt4n::Minor] = 0.0;
-  m_statusRatios[ngrt4n::Major] = 0.0;
-  m_statusRatios[ngrt4n::Critical] = 0.0;
-  m_statusRatios[ngrt4n::Unset] = 0.0;
-
+  for (int sev = 0; sev < SeverityCount; ++sev) {
+    m_severityWeights[sev] = 0.0;
+    m_statusRatios[sev] = 0.0;
+  }
 }
 
 void StatusAggregator::addSeverity(int value, double weight)
@@ -46,14 +37,57 @@ void StatusAggregator::addSeverity(int value, double weight)
       m_essentialCount += 1;
       m_maxEssential = qMax(m_maxEssential, value);
     } else {
-      m_severityWeightsMap[value] += weight;
+      m_severityWeights[value] += weight;
       m_nonEssentialTotalWeight += weight;
     }
   }
-  updateThresholds();
+  m_ratiosUpToDate = false;
   ++m_count;
 }
 
+/**
+ * Same as calling addSeverity() for each entry of the span, but with the per-severity
+ * sums accumulated in local variables that the compiler can keep in registers.
+ */
+void StatusAggregator::addSeverities(const ngrt4n::AggregatedSeverityT* statuses, int count)
+{
+  double weights[SeverityCount] = {0.0, 0.0, 0.0, 0.0, 0.0};
+  int minSeverity = m_minSeverity;
+  int maxSeverity = m_maxSeverity;
+  int maxEssential = m_maxEssential;
+  int essentialCount = 0;
+
+  for (int index = 0; index < count; ++index) {
+    int value = statuses[index].sev;
+    double weight = statuses[index].weight;
+    if (value < ngrt4n::Normal || value > ngrt4n::Unknown)
+      value = ngrt4n::Unknown;
+
+    if (weight == 0)
+      continue;
+
+    minSeverity = qMin(minSeverity, value);
+    maxSeverity = qMax(maxSeverity, value);
+    if (weight == ngrt4n::WEIGHT_MAX) {
+      ++essentialCount;
+      maxEssential = qMax(maxEssential, value);
+    } else {
+      weights[value] += weight;
+    }
+  }
+
+  for (int sev = 0; sev < SeverityCount; ++sev) {
+    m_severityWeights[sev] += weights[sev];
+    m_nonEssentialTotalWeight += weights[sev];
+  }
+  m_minSeverity = minSeverity;
+  m_maxSeverity = maxSeverity;
+  m_maxEssential = maxEssential;
+  m_essentialCount += essentialCount;
+  m_count += count;
+  m_ratiosUpToDate = false;
+}
+
 void StatusAggregator::addThresholdLimit(QVector<ThresholdT>& thresholdsLimits, const ThresholdT& th)
 {
   thresholdsLimits.push_back(th);
@@ -64,13 +98,21 @@ void StatusAggregator::addThresholdLimit(QVector<ThresholdT>& thresholdsLimits,
 void StatusAggregator::updateThresholds(void)
 {
   if (m_nonEssentialTotalWeight > 0)
-    for (int sev : m_severityWeightsMap.keys()) m_statusRatios[sev] = m_severityWeightsMap[sev] / m_nonEssentialTotalWeight;
+    for (int sev = 0; sev < SeverityCount; ++sev) m_statusRatios[sev] = m_severityWeights[sev] / m_nonEssentialTotalWeight;
   else
-    for (int sev : m_severityWeightsMap.keys()) m_statusRatios[sev] = DBL_MAX;
+    for (int sev = 0; sev < SeverityCount; ++sev) m_statusRatios[sev] = DBL_MAX;
+  m_ratiosUpToDate = true;
+}
+
+void StatusAggregator::displayWeight(void)
+{
+  ensureThresholdsUpdated();
+  for (int sev = 0; sev < SeverityCount; ++sev) qDebug()<<Severity(sev).toString() <<  m_statusRatios[sev];
 }
 
 QString StatusAggregator::toDetailsString(void)
 {
+  ensureThresholdsUpdated();
   return QObject::tr("Unknown: %1\%; "
                      "Critical: %2\%; "
                      "Major: %3\%; "
@@ -89,8 +131,6 @@ QString StatusAggregator::toDetailsString(void)
 int StatusAggregator::aggregate(int crule, const QVector<ThresholdT>& thresholdsLimits)
 {
   m_thresholdExceededMsg.clear();
-  if (m_statusRatios.isEmpty())
-    return ngrt4n::Normal;
 
   int result = ngrt4n::Unknown;
   switch (crule) {
@@ -138,8 +178,8 @@ int StatusAggregator::weightedAverage(void)
 {
   double severityScore = 0;
   double weightSum = 0;
-  for(int sev : m_severityWeightsMap.keys()) {
-    double weight = m_severityWeightsMap[sev];
+  for (int sev = 0; sev < SeverityCount; ++sev) {
+    double weight = m_severityWeights[sev];
     if (weight > 0) {
       severityScore += weight * static_cast<double>(sev);
       weightSum += weight * ngrt4n::WEIGHT_UNIT;
@@ -150,13 +190,16 @@ int StatusAggregator::weightedAverage(void)
 
 int StatusAggregator::weightedAverageWithThresholds(const QVector<ThresholdT>& thresholdsLimits)
 {
+  ensureThresholdsUpdated();
+
   int thresholdReached = -1;
   int index = thresholdsLimits.size() - 1;
 
   while (index >= 0 && thresholdReached == -1) {
     ThresholdT th = thresholdsLimits[index];
-    QMap<int, double>::iterator thvalue = m_statusRatios.find(th.sev_in);
-    if (thvalue != m_statusRatios.end() && (*thvalue >= th.weight)) {
+    bool isTrackedSeverity = (th.sev_in >= ngrt4n::Normal && th.sev_in <= ngrt4n::Unknown);
+    double ratio = isTrackedSeverity ? m_statusRatios[th.sev_in] : 0.0;
+    if ((isTrackedSeverity || th.sev_in == ngrt4n::Unset) && ratio >= th.weight) {
       thresholdReached = thresholdsLimits[index].sev_out;
       m_thresholdExceededMsg = QObject::tr("%1 events exceeded %2\% and set to %3").arg(Severity(th.sev_in).toString(),
                                                                                         QString::number(100 * th.weight),
@@ -8,6 +8,7 @@ public:
   explicit StatusAggregator(void);
   void resetData(void);
   void addSeverity(int value, double weight);
+  void addSeverities(const ngrt4n::AggregatedSeverityT* statuses, int count);
   void addThresholdLimit(QVector<ThresholdT>& thresholdsLimits, const ThresholdT& th);
   QString toDetailsString(void);
   void updateThresholds(void);
@@ -19,10 +20,12 @@ public:
   int maxSev(void) const {return m_maxSeverity;}
   int count(void) const {return m_count;}
   double totalWeight(void) const {return m_nonEssentialTotalWeight;}
-  void displayWeight(void) { Q_FOREACH(int sev, m_severityWeightsMap.keys()) qDebug()<<Severity(sev).toString() <<  m_statusRatios[sev]; }
+  void displayWeight(void);
   QString thresholdExceededMsg(void) const {return m_thresholdExceededMsg;}
 
 private:
+  static const int SeverityCount = ngrt4n::Unknown + 1;
+
   int m_count;
   int m_essentialCount;
   double m_nonEssentialTotalWeight;
@@ -30,8 +33,11 @@ private:
   int m_maxSeverity;
   int m_maxEssential;
   QString m_thresholdExceededMsg;
-  QMap<int, double> m_severityWeightsMap;
-  QMap<int, double> m_statusRatios;
+  bool m_ratiosUpToDate;
+  double m_severityWeights[SeverityCount];
+  double m_statusRatios[SeverityCount];
+
+  void ensureThresholdsUpdated(void) { if (! m_ratiosUpToDate) updateThresholds(); }
 };
 
 
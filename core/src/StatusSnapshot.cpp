@@ -0,0 +1,441 @@
+/*
+ * StatusSnapshot.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "StatusSnapshot.hpp"
+#include "utilsCore.hpp"
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStringList>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+  const char SnapshotMagic[4] = {'R', 'S', 'N', 'P'};
+
+  bool isSameNodeStatus(const StatusSnapshot::NodeStatusT& lhs, const StatusSnapshot::NodeStatusT& rhs)
+  {
+    if (lhs.sev != rhs.sev || lhs.sevProp != rhs.sevProp || lhs.message != rhs.message || lhs.hasCheck != rhs.hasCheck) {
+      return false;
+    }
+    return ! lhs.hasCheck || ngrt4n::isSameCheck(lhs.check, rhs.check);
+  }
+
+  void appendInt32(QByteArray& buffer, qint32 value)
+  {
+    uchar bytes[4];
+    qToLittleEndian<qint32>(value, bytes);
+    buffer.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+  }
+
+  void appendInt64(QByteArray& buffer, qint64 value)
+  {
+    uchar bytes[8];
+    qToLittleEndian<qint64>(value, bytes);
+    buffer.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+  }
+
+  void appendString(QByteArray& buffer, const QByteArray& value)
+  {
+    appendInt32(buffer, value.size());
+    buffer.append(value);
+  }
+
+  /** reads the fields of a record, any read past the end of the record marks it invalid */
+  struct RecordReaderT {
+    const uchar* pos;
+    const uchar* end;
+    bool ok;
+
+    RecordReaderT(const uchar* begin, const uchar* _end) : pos(begin), end(_end), ok(true) {}
+
+    bool has(qint64 count) {
+      if (count < 0 || end - pos < count) {
+        ok = false;
+      }
+      return ok;
+    }
+
+    qint32 readInt32(void) {
+      if (! has(4)) return 0;
+      qint32 value = qFromLittleEndian<qint32>(pos);
+      pos += 4;
+      return value;
+    }
+
+    qint64 readInt64(void) {
+      if (! has(8)) return 0;
+      qint64 value = qFromLittleEndian<qint64>(pos);
+      pos += 8;
+      return value;
+    }
+
+    quint8 readByte(void) {
+      if (! has(1)) return 0;
+      return *pos++;
+    }
+
+    QByteArray readString(void) {
+      qint64 size = static_cast<quint32>(readInt32());
+      if (! has(size)) return QByteArray();
+      QByteArray value(reinterpret_cast<const char*>(pos), static_cast<int>(size));
+      pos += size;
+      return value;
+    }
+  };
+}
+
+
+StatusSnapshot::StatusSnapshot(void)
+  : m_loadedModification(0),
+    m_dirty(false)
+{
+}
+
+
+StatusSnapshot& StatusSnapshot::shared(void)
+{
+  static StatusSnapshot snapshot;
+  return snapshot;
+}
+
+
+std::pair<int, QString> StatusSnapshot::load(const QString& path)
+{
+  ViewStatusMapT views;
+  auto readOut = readFile(path, views);
+  if (readOut.first != ngrt4n::RcSuccess) {
+    return readOut;
+  }
+
+  QMutexLocker locker(&m_mutex);
+  merge(views);
+  m_loadedModification = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+  return std::make_pair(ngrt4n::RcSuccess, QObject::tr("%1 view(s) loaded from the status snapshot").arg(views.size()));
+}
+
+
+std::pair<int, QString> StatusSnapshot::save(const QString& path)
+{
+  // the records written by other collectors in the meantime are kept when more recent
+  ViewStatusMapT onDiskViews;
+  qint64 onDiskModification = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+  bool changedOnDisk;
+  {
+    QMutexLocker locker(&m_mutex);
+    changedOnDisk = (onDiskModification != m_loadedModification);
+  }
+  if (changedOnDisk) {
+    readFile(path, onDiskViews);
+  }
+
+  QByteArray content;
+  {
+    QMutexLocker locker(&m_mutex);
+    merge(onDiskViews);
+    content = serialize(m_views);
+    m_dirty = false;
+  }
+
+  QSaveFile file(path);
+  if (! file.open(QIODevice::WriteOnly)
+      || file.write(content) != content.size()
+      || ! file.commit()) {
+    QMutexLocker locker(&m_mutex);
+    m_dirty = true;
+    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("cannot write the status snapshot %1: %2").arg(path, file.errorString()));
+  }
+
+  QMutexLocker locker(&m_mutex);
+  m_loadedModification = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+  return std::make_pair(ngrt4n::RcSuccess, QString());
+}
+
+
+bool StatusSnapshot::isDirty(void) const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_dirty;
+}
+
+
+bool StatusSnapshot::contains(const QString& viewName) const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_views.contains(viewName);
+}
+
+
+bool StatusSnapshot::findView(const QString& viewName, ViewStatusT& status) const
+{
+  QMutexLocker locker(&m_mutex);
+  auto view = m_views.constFind(viewName);
+  if (view == m_views.cend()) {
+    return false;
+  }
+  status = *view;
+  return true;
+}
+
+
+void StatusSnapshot::updateView(const QString& viewName, const ViewStatusT& status)
+{
+  QMutexLocker locker(&m_mutex);
+  ViewStatusT& view = m_views[viewName];
+  qint32 notifiedStatus = (status.notifiedStatus < 0) ? view.notifiedStatus : status.notifiedStatus;
+  bool changed = (view.timestamp != status.timestamp
+                  || view.notifiedStatus != notifiedStatus
+                  || view.period != status.period
+                  || view.nodes.size() != status.nodes.size());
+  for (auto node = status.nodes.cbegin(); ! changed && node != status.nodes.cend(); ++node) {
+    auto current = view.nodes.constFind(node.key());
+    changed = (current == view.nodes.cend() || ! isSameNodeStatus(*current, *node));
+  }
+  if (! changed) {
+    return;
+  }
+  view = status;
+  view.notifiedStatus = notifiedStatus;
+  m_dirty = true;
+  m_unpublished.insert(viewName);
+}
+
+
+int StatusSnapshot::notifiedStatus(const QString& viewName) const
+{
+  QMutexLocker locker(&m_mutex);
+  auto view = m_views.constFind(viewName);
+  return (view != m_views.cend()) ? view->notifiedStatus : -1;
+}
+
+
+void StatusSnapshot::setNotifiedStatus(const QString& viewName, int status)
+{
+  QMutexLocker locker(&m_mutex);
+  auto view = m_views.find(viewName);
+  if (view != m_views.end() && view->notifiedStatus != status) {
+    view->notifiedStatus = status;
+    m_dirty = true;
+  }
+}
+
+
+StatusSnapshot::RecordMapT StatusSnapshot::takeUnpublishedRecords(void)
+{
+  QMutexLocker locker(&m_mutex);
+  RecordMapT records;
+  for (const auto& viewName : m_unpublished) {
+    auto view = m_views.constFind(viewName);
+    if (view == m_views.cend()) {
+      continue;
+    }
+    RecordT record;
+    record.timestamp = view->timestamp;
+    record.content = QByteArray(2, '\0');
+    qToLittleEndian<quint16>(FormatVersion, reinterpret_cast<uchar*>(record.content.data()));
+    record.content.append(serializeRecord(viewName, *view));
+    records.insert(viewName, record);
+  }
+  m_unpublished.clear();
+  return records;
+}
+
+
+void StatusSnapshot::markUnpublished(const RecordMapT& records)
+{
+  QMutexLocker locker(&m_mutex);
+  for (auto record = records.cbegin(); record != records.cend(); ++record) {
+    m_unpublished.insert(record.key());
+  }
+}
+
+
+std::pair<int, QString> StatusSnapshot::mergeRecords(const RecordMapT& records)
+{
+  ViewStatusMapT views;
+  QStringList invalidRecords;
+  for (auto record = records.cbegin(); record != records.cend(); ++record) {
+    const uchar* data = reinterpret_cast<const uchar*>(record->content.constData());
+    QString viewName;
+    ViewStatusT view;
+    if (record->content.size() < 2
+        || qFromLittleEndian<quint16>(data) != FormatVersion
+        || ! parseRecord(data + 2, data + record->content.size(), viewName, view)) {
+      invalidRecords.push_back(record.key());
+      continue;
+    }
+    views.insert(viewName, view);
+  }
+
+  QMutexLocker locker(&m_mutex);
+  merge(views);
+  if (! invalidRecords.isEmpty()) {
+    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("invalid or unsupported status record(s): %1").arg(invalidRecords.join(", ")));
+  }
+  return std::make_pair(ngrt4n::RcSuccess, QString());
+}
+
+
+void StatusSnapshot::merge(const ViewStatusMapT& views)
+{
+  for (auto view = views.cbegin(); view != views.cend(); ++view) {
+    auto current = m_views.find(view.key());
+    if (current == m_views.end() || view->timestamp > current->timestamp) {
+      m_views.insert(view.key(), view.value());
+    }
+  }
+}
+
+
+std::pair<int, QString> StatusSnapshot::readFile(const QString& path, ViewStatusMapT& views)
+{
+  QFile file(path);
+  if (! file.exists()) {
+    return std::make_pair(ngrt4n::RcSuccess, QString());
+  }
+  if (! file.open(QIODevice::ReadOnly)) {
+    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("cannot open the status snapshot %1: %2").arg(path, file.errorString()));
+  }
+
+  qint64 size = file.size();
+  uchar* data = (size >= HeaderSize) ? file.map(0, size) : nullptr;
+  if (! data) {
+    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("cannot map the status snapshot %1: %2").arg(path, file.errorString()));
+  }
+
+  bool parsed = parse(data, size, views);
+  file.unmap(data);
+  if (! parsed) {
+    views.clear();
+    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("invalid or unsupported status snapshot: %1").arg(path));
+  }
+  return std::make_pair(ngrt4n::RcSuccess, QString());
+}
+
+
+bool StatusSnapshot::parse(const uchar* data, qint64 size, ViewStatusMapT& views)
+{
+  if (size < HeaderSize) {
+    return false;
+  }
+  quint16 version = qFromLittleEndian<quint16>(data + 4);
+  if (memcmp(data, SnapshotMagic, sizeof(SnapshotMagic)) != 0 || version != FormatVersion) {
+    return false;
+  }
+
+  quint32 viewCount = qFromLittleEndian<quint32>(data + 16);
+  RecordReaderT reader(data + HeaderSize, data + size);
+  for (quint32 viewIndex = 0; viewIndex < viewCount; ++viewIndex) {
+    qint64 recordSize = static_cast<quint32>(reader.readInt32());
+    if (! reader.has(recordSize)) {
+      return false;
+    }
+    QString viewName;
+    ViewStatusT view;
+    if (! parseRecord(reader.pos, reader.pos + recordSize, viewName, view)) {
+      return false;
+    }
+    reader.pos += recordSize;
+    views.insert(viewName, view);
+  }
+  return true;
+}
+
+
+bool StatusSnapshot::parseRecord(const uchar* begin, const uchar* end, QString& viewName, ViewStatusT& view)
+{
+  RecordReaderT record(begin, end);
+  viewName = QString::fromUtf8(record.readString());
+  view.timestamp = record.readInt64();
+  view.notifiedStatus = record.readInt32();
+  view.period = record.readInt32();
+  qint32 nodeCount = record.readInt32();
+  for (qint32 nodeIndex = 0; nodeIndex < nodeCount && record.ok; ++nodeIndex) {
+    QString nodeId = QString::fromUtf8(record.readString());
+    NodeStatusT node;
+    node.sev = record.readInt32();
+    node.sevProp = record.readInt32();
+    node.message = QString::fromUtf8(record.readString());
+    node.hasCheck = (record.readByte() != 0);
+    if (node.hasCheck) {
+      node.check.status = record.readInt32();
+      node.check.id = record.readString().toStdString();
+      node.check.host = record.readString().toStdString();
+      node.check.check_command = record.readString().toStdString();
+      node.check.last_state_change = record.readString().toStdString();
+      node.check.alarm_msg = record.readString().toStdString();
+      node.check.host_groups = record.readString().toStdString();
+    }
+    view.nodes.insert(nodeId, node);
+  }
+  return record.ok;
+}
+
+
+QByteArray StatusSnapshot::serialize(const ViewStatusMapT& views)
+{
+  QByteArray content(HeaderSize, '\0');
+  uchar* header = reinterpret_cast<uchar*>(content.data());
+  memcpy(header, SnapshotMagic, sizeof(SnapshotMagic));
+  qToLittleEndian<quint16>(FormatVersion, header + 4);
+  qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch() / 1000, header + 8);
+  qToLittleEndian<quint32>(static_cast<quint32>(views.size()), header + 16);
+
+  for (auto view = views.cbegin(); view != views.cend(); ++view) {
+    QByteArray record = serializeRecord(view.key(), *view);
+    appendInt32(content, record.size());
+    content.append(record);
+  }
+  return content;
+}
+
+
+QByteArray StatusSnapshot::serializeRecord(const QString& viewName, const ViewStatusT& view)
+{
+  QByteArray record;
+  appendString(record, viewName.toUtf8());
+  appendInt64(record, view.timestamp);
+  appendInt32(record, view.notifiedStatus);
+  appendInt32(record, view.period);
+  appendInt32(record, view.nodes.size());
+  for (auto node = view.nodes.cbegin(); node != view.nodes.cend(); ++node) {
+    appendString(record, node.key().toUtf8());
+    appendInt32(record, node->sev);
+    appendInt32(record, node->sevProp);
+    appendString(record, node->message.toUtf8());
+    record.append(static_cast<char>(node->hasCheck ? 1 : 0));
+    if (node->hasCheck) {
+      appendInt32(record, node->check.status);
+      appendString(record, QByteArray::fromStdString(node->check.id));
+      appendString(record, QByteArray::fromStdString(node->check.host));
+      appendString(record, QByteArray::fromStdString(node->check.check_command));
+      appendString(record, QByteArray::fromStdString(node->check.last_state_change));
+      appendString(record, QByteArray::fromStdString(node->check.alarm_msg));
+      appendString(record, QByteArray::fromStdString(node->check.host_groups));
+    }
+  }
+  return record;
+}
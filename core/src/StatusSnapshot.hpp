@@ -0,0 +1,112 @@
+/*
+ * StatusSnapshot.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef STATUSSNAPSHOT_HPP
+#define STATUSSNAPSHOT_HPP
+
+#include "Base.hpp"
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+/**
+ * Last known status of the views, written periodically by ngrt4n-reportd and loaded when it
+ * starts, so that a restarted collector resumes from the last collected status instead of
+ * Unknown until every source has answered.
+ *
+ * The file starts with a fixed header (magic, version, write time, view count), followed by one
+ * record per view: its name, the time of its collection, its last notified status, the
+ * collection period of its collector, then the severity, message and check data of its nodes.
+ * Integers are little-endian and strings are length-prefixed UTF-8, so that the file is read in
+ * place once memory-mapped; a file of any other version is rejected. It is written to
+ * a temporary file renamed over the previous one, and merged with the records already on disk
+ * so that several collectors can share it: the most recent record of a view wins.
+ *
+ * The file is local to its host, so the collectors also publish the records of the views they
+ * update in the database, from which the web sessions take them wherever they run.
+ */
+class StatusSnapshot
+{
+public:
+  static const quint16 FormatVersion = 1;
+  static const int HeaderSize = 24;
+
+  struct NodeStatusT {
+    qint32 sev;
+    qint32 sevProp;
+    QString message;
+    bool hasCheck;
+    CheckT check;
+  };
+  typedef QHash<QString, NodeStatusT> NodeStatusMapT;
+
+  struct ViewStatusT {
+    qint64 timestamp; // time of the collection, in seconds since epoch
+    qint32 notifiedStatus; // -1 when unknown
+    qint32 period; // collection period in seconds, 0 when unknown
+    NodeStatusMapT nodes;
+    ViewStatusT(void) : timestamp(0), notifiedStatus(-1), period(0) {}
+  };
+  typedef QHash<QString, ViewStatusT> ViewStatusMapT;
+
+  struct RecordT {
+    qint64 timestamp;
+    QByteArray content; // format version followed by the view record, as stored in the database
+  };
+  typedef QHash<QString, RecordT> RecordMapT;
+
+  static StatusSnapshot& shared(void);
+
+  std::pair<int, QString> load(const QString& path);
+  std::pair<int, QString> save(const QString& path);
+  bool isDirty(void) const;
+  bool contains(const QString& viewName) const;
+  bool findView(const QString& viewName, ViewStatusT& status) const;
+  void updateView(const QString& viewName, const ViewStatusT& status);
+  int notifiedStatus(const QString& viewName) const;
+  void setNotifiedStatus(const QString& viewName, int status);
+  RecordMapT takeUnpublishedRecords(void);
+  void markUnpublished(const RecordMapT& records);
+  std::pair<int, QString> mergeRecords(const RecordMapT& records);
+
+  static bool parse(const uchar* data, qint64 size, ViewStatusMapT& views);
+  static bool parseRecord(const uchar* begin, const uchar* end, QString& viewName, ViewStatusT& view);
+  static QByteArray serialize(const ViewStatusMapT& views);
+  static QByteArray serializeRecord(const QString& viewName, const ViewStatusT& view);
+
+private:
+  mutable QMutex m_mutex;
+  ViewStatusMapT m_views;
+  qint64 m_loadedModification; // in milliseconds since epoch
+  bool m_dirty;
+  QSet<QString> m_unpublished;
+
+  StatusSnapshot(void);
+  void merge(const ViewStatusMapT& views);
+  static std::pair<int, QString> readFile(const QString& path, ViewStatusMapT& views);
+};
+
+#endif // STATUSSNAPSHOT_HPP
@@ -23,6 +23,7 @@
  */
 #include "TestK8sHelper.hpp"
 #include "K8sHelper.hpp"
+#include "SourceCollector.hpp"
 #include "utilsCore.hpp"
 #include <QtTest/QtTest>
 #include <QFile>
@@ -109,17 +110,17 @@ void TestK8sHelper::test_parseNamespacedPods(void)
 
 void TestK8sHelper::test_httpDataRetrieving(void)
 {
-    K8sHelper  k8s(m_PROXY_URL, false);
     SourceT sinfo;
-    auto&& outNs = k8s.listNamespaces();
-    qDebug() << outNs.first;
-    QCOMPARE(outNs.second, static_cast<int>(ngrt4n::RcSuccess));
-    QCOMPARE(outNs.first.size() > 0, true);
-    for (auto&& ns: outNs.first) {
-        CoreDataT cdata;
-        auto nsViewOut = k8s.loadNamespaceView(ns, cdata);
-        QVERIFY(nsViewOut.second == static_cast<int>(ngrt4n::RcSuccess));
-        ngrt4n::saveViewDataToPath(cdata, "/tmp/roi_"+ns+".xml");
+    sinfo.mon_url = m_PROXY_URL;
+    sinfo.verify_ssl_peer = false;
+    auto&& outNs = SourceCollector::shared().listNamespaces(sinfo).get();
+    qDebug() << outNs.namespaces;
+    QCOMPARE(outNs.rc, static_cast<int>(ngrt4n::RcSuccess));
+    QCOMPARE(outNs.namespaces.size() > 0, true);
+    for (auto&& ns: outNs.namespaces) {
+        auto nsViewOut = SourceCollector::shared().loadNamespaceView(sinfo, ns).get();
+        QVERIFY(nsViewOut.rc == static_cast<int>(ngrt4n::RcSuccess));
+        ngrt4n::saveViewDataToPath(nsViewOut.cdata, "/tmp/roi_"+ns+".xml");
     }
 }
 
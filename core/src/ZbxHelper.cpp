@@ -29,13 +29,16 @@
 #include <QtScript/QScriptEngine>
 #include <QDebug>
 #include <QSslConfiguration>
+#include <QSet>
+#include <QJsonArray>
+#include <QJsonDocument>
 
 
 const RequestListT ZbxHelper::ReqPatterns = ZbxHelper::requestsPatterns();
 
 
 ZbxHelper::ZbxHelper(const QString & baseUrl)
-  : QNetworkAccessManager(),
+  : QObject(),
     m_apiUri(baseUrl%ZBX_API_CONTEXT),
     m_getTriggersByHostOrGroupApiVersion(-1),
     m_isLogged(false)
@@ -96,6 +99,13 @@ ZbxHelper::requestsPatterns()
                                \"output\": [\"triggerid\",\"description\",\"value\",\"error\",\"comments\",\"priority\"], \
                                \"limit\": -1}, \
                                \"id\": %9}";
+  patterns[GetHostGroupIds] = "{\"jsonrpc\": \"2.0\", \
+                              \"auth\": \"%1\", \
+                              \"method\": \"hostgroup.get\", \
+                              \"params\": { \
+                              \"output\": [\"groupid\"], \
+                              \"filter\": {\"name\": %2}}, \
+                              \"id\": %9}";
   patterns[GetITServices] = "{\"jsonrpc\": \"2.0\", \
                             \"auth\": \"%1\", \
                             \"method\": \"service.get\", \
@@ -106,17 +116,19 @@ ZbxHelper::requestsPatterns()
 }
 
 
-bool ZbxHelper::checkLogin(void)
+void
+ZbxHelper::checkLogin(const HttpTransport::DoneHandlerT& done)
 {
-  if (! m_isLogged && openSession() != ngrt4n::RcSuccess) {
-    m_isLogged = false;
+  if (m_isLogged) {
+    done(ngrt4n::RcSuccess);
+    return;
   }
 
-  return m_isLogged;
+  openSession(done);
 }
 
-int
-ZbxHelper::postRequest(qint32 reqId, const QStringList& params)
+void
+ZbxHelper::postRequest(qint32 reqId, const QStringList& params, const HttpTransport::DoneHandlerT& done)
 {
   QString request = "";
   if (reqId == GetLogin || reqId == GetApiVersion) {
@@ -129,19 +141,12 @@ ZbxHelper::postRequest(qint32 reqId, const QStringList& params)
     request = request.arg(myparam);
   }
 
-  QNetworkReply* reply = QNetworkAccessManager::post(m_reqHandler, ngrt4n::toByteArray(request));
+  QNetworkReply* reply = HttpTransport::local()->post(m_reqHandler, ngrt4n::toByteArray(request));
   setSslReplyErrorHandlingOptions(reply);
 
-  connect(reply, SIGNAL(finished()), &m_evlHandler, SLOT(quit()));
-  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(processError(QNetworkReply::NetworkError)));
-
-  m_evlHandler.exec();
-
-  if (! reply) {
-    return ngrt4n::RcGenericFailure;
-  }
-
-  return parseReply(reply);
+  HttpTransport::whenFinished(reply, this, [this, done](QNetworkReply* finishedReply) {
+    done(parseReply(finishedReply));
+  });
 }
 
 
@@ -197,29 +202,28 @@ ZbxHelper::checkBackendSuccessfulResult(void)
   return false;
 }
 
-int
-ZbxHelper::openSession(void)
+void
+ZbxHelper::openSession(const HttpTransport::DoneHandlerT& done)
 {
   setBaseUrl(m_sourceInfo.mon_url);
   QStringList params = ngrt4n::getAuthInfo(m_sourceInfo.auth);
   if (params.size() != 2) {
     m_lastError = tr("Bad auth string, should be in the form of login:password");
-    return ngrt4n::RcGenericFailure;
+    done(ngrt4n::RcGenericFailure);
+    return;
   }
 
   params.push_back(QString::number(GetLogin));
   setSslPeerVerification(m_sourceInfo.verify_ssl_peer);
 
-  if (postRequest(GetLogin, params) != ngrt4n::RcSuccess) {
-    return ngrt4n::RcGenericFailure;
-  }
-
-  if (processLoginReply() != ngrt4n::RcSuccess) {
-    return ngrt4n::RcGenericFailure;
-  }
-
-  // Get the API version and return
-  return fecthApiVersion();
+  postRequest(GetLogin, params, [this, done](int rc) {
+    if (rc != ngrt4n::RcSuccess || processLoginReply() != ngrt4n::RcSuccess) {
+      done(ngrt4n::RcGenericFailure);
+      return;
+    }
+    // Get the API version and return
+    fecthApiVersion(done);
+  });
 }
 
 int
@@ -237,17 +241,19 @@ ZbxHelper::processLoginReply(void)
   return ngrt4n::RcGenericFailure;
 }
 
-int
-ZbxHelper::fecthApiVersion(void)
+void
+ZbxHelper::fecthApiVersion(const HttpTransport::DoneHandlerT& done)
 {
   setSslPeerVerification(m_sourceInfo.verify_ssl_peer);
 
   QStringList params {QString::number(GetApiVersion)};
-  if (postRequest(ZbxHelper::GetApiVersion, params) != ngrt4n::RcSuccess) {
-    return ngrt4n::RcGenericFailure;
-  }
-
-  return processGetApiVersionReply();
+  postRequest(ZbxHelper::GetApiVersion, params, [this, done](int rc) {
+    if (rc != ngrt4n::RcSuccess) {
+      done(ngrt4n::RcGenericFailure);
+      return;
+    }
+    done(processGetApiVersionReply());
+  });
 }
 
 int
@@ -322,88 +328,175 @@ ZbxHelper::processTriggerData(ChecksT& checks)
   return ngrt4n::RcSuccess;
 }
 
-int
-ZbxHelper::loadChecks(const SourceT& srcInfo, ChecksT& checks, const QString& filterValue,
-                      ngrt4n::RequestFilterT filterType)
+void
+ZbxHelper::loadChecks(const SourceT& srcInfo, const QStringList& hostOrGroupNames, const HttpTransport::DoneHandlerT& done)
 {
   m_sourceInfo = srcInfo;
 
-  checks.clear();
+  m_checks.clear();
 
-  if (! checkLogin()) {
-    return ngrt4n::RcGenericFailure;
+  checkLogin([this, hostOrGroupNames, done](int rc) {
+    if (rc != ngrt4n::RcSuccess) {
+      done(ngrt4n::RcGenericFailure);
+      return;
+    }
+
+    if (hostOrGroupNames.isEmpty()) {
+      fetchTriggers("", done);
+      return;
+    }
+
+    // the triggers of all the hosts at once, then those of the names not matching a host
+    QString hostNames = QJsonDocument(QJsonArray::fromStringList(hostOrGroupNames)).toJson(QJsonDocument::Compact);
+    fetchTriggers(QString("\"filter\": { \"host\": %1},").arg(hostNames), [this, hostOrGroupNames, done](int rc) {
+      if (rc != ngrt4n::RcSuccess) {
+        done(ngrt4n::RcGenericFailure);
+        return;
+      }
+      fetchGroupTriggers(hostOrGroupNames, done);
+    });
+  });
+}
+
+
+void
+ZbxHelper::fetchGroupTriggers(const QStringList& hostOrGroupNames, const HttpTransport::DoneHandlerT& done)
+{
+  // the names not matching a host are taken as groups, resolved to ids to fetch their triggers at once
+  QSet<QString> foundHosts;
+  for (const auto& check : m_checks) {
+    foundHosts.insert(QString::fromStdString(check.host));
+  }
+  QStringList groupNames;
+  for (const auto& name : hostOrGroupNames) {
+    if (! foundHosts.contains(name)) {
+      groupNames.push_back(name);
+    }
+  }
+  if (groupNames.isEmpty()) {
+    done(ngrt4n::RcSuccess);
+    return;
   }
 
   QStringList params;
-  if (! filterValue.isEmpty()) {
-    if (filterType == ngrt4n::GroupFilter) {
-      params.push_back( QString("\"group\": \"%1\",").arg(filterValue) );
-    } else {
-      params.push_back( QString("\"filter\": { \"host\":[\"%1\"]},").arg(filterValue) );
+  params.push_back(QJsonDocument(QJsonArray::fromStringList(groupNames)).toJson(QJsonDocument::Compact));
+  params.push_back(QString::number(GetHostGroupIds));
+  postRequest(GetHostGroupIds, params, [this, done](int rc) {
+    QStringList groupIds;
+    if (rc != ngrt4n::RcSuccess || processHostGroupIdsReply(groupIds) != ngrt4n::RcSuccess) {
+      done(ngrt4n::RcGenericFailure);
+      return;
     }
-  } else {
-    params.push_back("");
-  }
-  //params.push_back(filter);
-  params.push_back(QString::number(m_getTriggersByHostOrGroupApiVersion));
+    if (groupIds.isEmpty()) {
+      done(ngrt4n::RcSuccess);
+      return;
+    }
+    QString groupIdList = QJsonDocument(QJsonArray::fromStringList(groupIds)).toJson(QJsonDocument::Compact);
+    fetchTriggers(QString("\"groupids\": %1,").arg(groupIdList), done);
+  });
+}
 
-  if (postRequest(m_getTriggersByHostOrGroupApiVersion, params) != ngrt4n::RcSuccess) {
-    return ngrt4n::RcGenericFailure;
-  }
 
-  if (! checkBackendSuccessfulResult()) {
-    return ngrt4n::RcGenericFailure;
-  }
+void
+ZbxHelper::fetchTriggers(const QString& filterParam, const HttpTransport::DoneHandlerT& done)
+{
+  QStringList params;
+  params.push_back(filterParam);
+  params.push_back(QString::number(m_getTriggersByHostOrGroupApiVersion));
 
-  return processTriggerData(checks);
+  postRequest(m_getTriggersByHostOrGroupApiVersion, params, [this, done](int rc) {
+    if (rc != ngrt4n::RcSuccess || ! checkBackendSuccessfulResult()) {
+      done(ngrt4n::RcGenericFailure);
+      return;
+    }
+    done(processTriggerData(m_checks));
+  });
 }
 
 
-std::pair<int, QString>
-ZbxHelper::loadITServices(const SourceT& srcInfo, CoreDataT& cdata)
+int
+ZbxHelper::processHostGroupIdsReply(QStringList& groupIds)
 {
-  m_sourceInfo = srcInfo;
-  cdata.clear();
-  cdata.monitor = MonitorT::Any;
+  groupIds.clear();
 
-  if (! checkLogin()) {
-    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("login failed: %s").arg(m_lastError));
+  if (! checkBackendSuccessfulResult()) {
+    return ngrt4n::RcGenericFailure;
   }
 
-  QStringList params(QString::number(GetITServices));
-  if (postRequest(GetITServices, params) != ngrt4n::RcSuccess) {
-    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("failed to post request: %s").arg(m_lastError));
+  QScriptValueIterator group(m_replyJsonData.getProperty("result"));
+  while (group.hasNext()) {
+    group.next();
+    if (group.flags() & QScriptValue::SkipInEnumeration) continue;
+    groupIds.push_back(group.value().property("groupid").toString());
   }
 
-  if (! checkBackendSuccessfulResult()) {
-    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("failed to parse backend request: %s").arg(m_lastError));
-  }
+  return ngrt4n::RcSuccess;
+}
 
-  ZabbixParentChildsDependenciesMapT parentChildsDependencies;
-  ZabbixChildParentDependenciesMapT childParentDependencies;
-  ZabbixServiceTriggerDependenciesMapT serviceTriggerDependencies;
 
-  if (processZabbixITServiceData(cdata, parentChildsDependencies, childParentDependencies, serviceTriggerDependencies) != ngrt4n::RcSuccess) {
-    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("failed to process output: %s").arg(m_lastError));
-  }
+void
+ZbxHelper::loadITServices(const SourceT& srcInfo, const HttpTransport::DoneHandlerT& done)
+{
+  m_sourceInfo = srcInfo;
+  m_cdata.clear();
+  m_cdata.monitor = MonitorT::Any;
+
+  checkLogin([this, done](int rc) {
+    if (rc != ngrt4n::RcSuccess) {
+      m_lastError = QObject::tr("login failed: %1").arg(m_lastError);
+      done(ngrt4n::RcGenericFailure);
+      return;
+    }
 
-  if (setBusinessServiceDependencies(cdata.bpnodes, parentChildsDependencies) != ngrt4n::RcSuccess) {
-    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("failed to build dependencies for bpnodes: %s").arg(m_lastError));
-  }
+    QStringList params(QString::number(GetITServices));
+    postRequest(GetITServices, params, [this, done](int rc) {
+      if (rc != ngrt4n::RcSuccess) {
+        m_lastError = QObject::tr("failed to post request: %1").arg(m_lastError);
+        done(ngrt4n::RcGenericFailure);
+        return;
+      }
 
-  if (setITServiceDataPoint(cdata.cnodes, serviceTriggerDependencies) != ngrt4n::RcSuccess) {
-    return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("failed to build dependencies for cnodes: %s").arg(m_lastError));
-  }
+      if (! checkBackendSuccessfulResult()) {
+        m_lastError = QObject::tr("failed to parse backend request: %1").arg(m_lastError);
+        done(ngrt4n::RcGenericFailure);
+        return;
+      }
 
-  NodeT rootService;
-  rootService.id = ngrt4n::ROOT_ID;
-  rootService.name = tr("Zabbix IT Services");
-  rootService.icon = "Zabbix";
-  rootService.type = NodeType::BusinessService;
-  rootService.child_nodes = extractTopParentServices(cdata.bpnodes, childParentDependencies);
-  cdata.bpnodes.insert(ngrt4n::ROOT_ID, rootService);
+      ZabbixParentChildsDependenciesMapT parentChildsDependencies;
+      ZabbixChildParentDependenciesMapT childParentDependencies;
+      ZabbixServiceTriggerDependenciesMapT serviceTriggerDependencies;
 
-  return std::make_pair(ngrt4n::RcSuccess, "");
+      if (processZabbixITServiceData(m_cdata, parentChildsDependencies, childParentDependencies, serviceTriggerDependencies) != ngrt4n::RcSuccess) {
+        m_lastError = QObject::tr("failed to process output: %1").arg(m_lastError);
+        done(ngrt4n::RcGenericFailure);
+        return;
+      }
+
+      if (setBusinessServiceDependencies(m_cdata.bpnodes, parentChildsDependencies) != ngrt4n::RcSuccess) {
+        m_lastError = QObject::tr("failed to build dependencies for bpnodes: %1").arg(m_lastError);
+        done(ngrt4n::RcGenericFailure);
+        return;
+      }
+
+      setITServiceDataPoint(serviceTriggerDependencies, [this, childParentDependencies, done](int rc) {
+        if (rc != ngrt4n::RcSuccess) {
+          m_lastError = QObject::tr("failed to build dependencies for cnodes: %1").arg(m_lastError);
+          done(ngrt4n::RcGenericFailure);
+          return;
+        }
+
+        NodeT rootService;
+        rootService.id = ngrt4n::ROOT_ID;
+        rootService.name = tr("Zabbix IT Services");
+        rootService.icon = "Zabbix";
+        rootService.type = NodeType::BusinessService;
+        rootService.child_nodes = extractTopParentServices(m_cdata.bpnodes, childParentDependencies);
+        m_cdata.bpnodes.insert(ngrt4n::ROOT_ID, rootService);
+
+        done(ngrt4n::RcSuccess);
+      });
+    });
+  });
 }
 
 QString ZbxHelper::extractTopParentServices(const NodeListT& bpnodes, const ZabbixChildParentDependenciesMapT& childParentDependencies)
@@ -534,7 +627,7 @@ int ZbxHelper::setBusinessServiceDependencies(NodeListT& bpnodes, const ZabbixPa
   return ngrt4n::RcSuccess;
 }
 
-int ZbxHelper::setITServiceDataPoint(NodeListT& cnodes, const ZabbixServiceTriggerDependenciesMapT& serviceTriggerDependencies)
+void ZbxHelper::setITServiceDataPoint(const ZabbixServiceTriggerDependenciesMapT& serviceTriggerDependencies, const HttpTransport::DoneHandlerT& done)
 {
   QStringList params;
 
@@ -542,36 +635,37 @@ int ZbxHelper::setITServiceDataPoint(NodeListT& cnodes, const ZabbixServiceTrigg
   params.push_back( getTriggersIdsJsonList(uniqueTriggerIds) );
   params.push_back(QString::number(GetTriggersByIds));
 
-  if (postRequest(GetTriggersByIds, params) != ngrt4n::RcSuccess) {
-    return ngrt4n::RcGenericFailure;
-  }
-
-  if (! checkBackendSuccessfulResult()) {
-    return ngrt4n::RcGenericFailure;
-  }
+  postRequest(GetTriggersByIds, params, [this, serviceTriggerDependencies, done](int rc) {
+    if (rc != ngrt4n::RcSuccess || ! checkBackendSuccessfulResult()) {
+      done(ngrt4n::RcGenericFailure);
+      return;
+    }
 
-  ChecksT dataPoints;
-  if (processTriggerData(dataPoints) != ngrt4n::RcSuccess) {
-    return ngrt4n::RcGenericFailure;
-  }
+    ChecksT dataPoints;
+    if (processTriggerData(dataPoints) != ngrt4n::RcSuccess) {
+      done(ngrt4n::RcGenericFailure);
+      return;
+    }
 
-  ZabbixServiceTriggerDependenciesMapT::ConstIterator serviceTriggerLink = serviceTriggerDependencies.begin();
-  while (serviceTriggerLink != serviceTriggerDependencies.end()) {
-    NodeListT::Iterator cnode = cnodes.find( serviceTriggerLink.key() );
-    if (cnode != cnodes.end()) {
-      ChecksT::ConstIterator dataPoint = dataPoints.find(serviceTriggerLink.value().toStdString());
-      if (dataPoint != dataPoints.end()) {
-        cnode->child_nodes = QString("%1:%2").arg(m_sourceInfo.id.trimmed(),
-                                                  QString::fromStdString(dataPoint.value().id).trimmed());
-      } else {
-        cnode->child_nodes = "";
-        qDebug()<< "Not trigger associated to the service: "<< cnodes[serviceTriggerLink.key()].name;
+    NodeListT& cnodes = m_cdata.cnodes;
+    ZabbixServiceTriggerDependenciesMapT::ConstIterator serviceTriggerLink = serviceTriggerDependencies.begin();
+    while (serviceTriggerLink != serviceTriggerDependencies.end()) {
+      NodeListT::Iterator cnode = cnodes.find( serviceTriggerLink.key() );
+      if (cnode != cnodes.end()) {
+        ChecksT::ConstIterator dataPoint = dataPoints.find(serviceTriggerLink.value().toStdString());
+        if (dataPoint != dataPoints.end()) {
+          cnode->child_nodes = QString("%1:%2").arg(m_sourceInfo.id.trimmed(),
+                                                    QString::fromStdString(dataPoint.value().id).trimmed());
+        } else {
+          cnode->child_nodes = "";
+          qDebug()<< "Not trigger associated to the service: "<< cnodes[serviceTriggerLink.key()].name;
+        }
       }
+      ++serviceTriggerLink;
     }
-    ++serviceTriggerLink;
-  }
 
-  return ngrt4n::RcSuccess;
+    done(ngrt4n::RcSuccess);
+  });
 }
 
 
@@ -593,7 +687,7 @@ QString ZbxHelper::getTriggersIdsJsonList(const QSet<QString>& triggerIds)
 void
 ZbxHelper::setSslReplyErrorHandlingOptions(QNetworkReply* reply)
 {
-  reply->setSslConfiguration(m_sslConfig);
+  HttpTransport::setSslConfiguration(reply, m_sslConfig);
   if (m_sslConfig.peerVerifyMode() == QSslSocket::VerifyNone)
     reply->ignoreSslErrors();
 }
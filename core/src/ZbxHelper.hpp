@@ -27,7 +27,7 @@
 #include "Base.hpp"
 #include "JsonHelper.hpp"
 #include <QtNetwork/QNetworkReply>
-#include <QtNetwork/QNetworkAccessManager>
+#include "HttpTransport.hpp"
 #include <QtNetwork/QSslConfiguration>
 
 
@@ -35,7 +35,7 @@ namespace {
   const QString ZBX_API_CONTEXT = "/api_jsonrpc.php";
 }
 
-class ZbxHelper : public QNetworkAccessManager {
+class ZbxHelper : public QObject {
   Q_OBJECT
 public:
   enum {
@@ -44,31 +44,26 @@ public:
     GetTriggersByHostOrGroup=3,
     GetTriggersByHostOrGroupV18=4,
     GetTriggersByIds = 6,
-    GetITServices = 5
+    GetITServices = 5,
+    GetHostGroupIds = 7
   };
   static const RequestListT ReqPatterns;
 
 public:
   ZbxHelper(const QString& baseUrl="http://localhost/zabbix");
   virtual ~ZbxHelper();
-  int postRequest(qint32 reqId, const QStringList& params);
   void setBaseUrl(const QString& url) {m_apiUri = url%ZBX_API_CONTEXT; m_reqHandler.setUrl(QUrl(m_apiUri));}
   void setApiVersion(const QString& apiv);
   QString lastError(void) const {return m_lastError;}
   void setSslPeerVerification(bool verifyPeer);
   int parseReply(QNetworkReply* reply);
   bool checkBackendSuccessfulResult(void);
-  int openSession(void);
-  int loadChecks(const SourceT& srcInfo, ChecksT& checks, const QString& filterValue, ngrt4n::RequestFilterT filterType = ngrt4n::HostFilter);
-  std::pair<int,QString> loadITServices(const SourceT& srcInfo, CoreDataT& cdata);
+  void loadChecks(const SourceT& srcInfo, const QStringList& hostOrGroupNames, const HttpTransport::DoneHandlerT& done);
+  void loadITServices(const SourceT& srcInfo, const HttpTransport::DoneHandlerT& done);
+  const ChecksT& checks(void) const {return m_checks;}
+  const CoreDataT& cdata(void) const {return m_cdata;}
 
 
-public Q_SLOTS:
-  void processError(const QNetworkReply::NetworkError& code) { m_evlHandler.exit(code);}
-
-Q_SIGNALS:
-  void propagateError(QNetworkReply::NetworkError);
-
 private :
   static RequestListT requestsPatterns();
   typedef QMap<QString, QSet<QString> > ZabbixParentChildsDependenciesMapT;
@@ -76,7 +71,6 @@ private :
   typedef QMap<QString, QString> ZabbixServiceTriggerDependenciesMapT;
   QString m_apiUri;
   QNetworkRequest m_reqHandler;
-  QEventLoop m_evlHandler;
   int m_getTriggersByHostOrGroupApiVersion;
   bool m_isLogged;
   SourceT m_sourceInfo;
@@ -84,19 +78,26 @@ private :
   QSslConfiguration m_sslConfig;
   QString m_lastError;
   JsonHelper m_replyJsonData;
+  ChecksT m_checks;
+  CoreDataT m_cdata;
 
-  bool checkLogin(void);
+  void postRequest(qint32 reqId, const QStringList& params, const HttpTransport::DoneHandlerT& done);
+  void checkLogin(const HttpTransport::DoneHandlerT& done);
+  void openSession(const HttpTransport::DoneHandlerT& done);
   int processLoginReply(void);
-  int fecthApiVersion(void);
+  void fecthApiVersion(const HttpTransport::DoneHandlerT& done);
   int processGetApiVersionReply(void);
   int processTriggerData(ChecksT& checks);
+  void fetchTriggers(const QString& filterParam, const HttpTransport::DoneHandlerT& done);
+  void fetchGroupTriggers(const QStringList& hostOrGroupNames, const HttpTransport::DoneHandlerT& done);
+  int processHostGroupIdsReply(QStringList& groupIds);
   int processZabbixITServiceData(CoreDataT& cdata,
                                  ZabbixParentChildsDependenciesMapT& parentChildsDependencies,
                                  ZabbixChildParentDependenciesMapT& childParentDependencies,
                                  ZabbixServiceTriggerDependenciesMapT& serviceTriggerDependencies);
   QString extractTopParentServices(const NodeListT& bpnodes, const ZabbixChildParentDependenciesMapT& childParentDependencies);
   int setBusinessServiceDependencies(NodeListT& bpnodes, const ZabbixParentChildsDependenciesMapT& parentChildsDependencies);
-  int setITServiceDataPoint(NodeListT& cnodes, const ZabbixServiceTriggerDependenciesMapT& serviceTriggerDependencies);
+  void setITServiceDataPoint(const ZabbixServiceTriggerDependenciesMapT& serviceTriggerDependencies, const HttpTransport::DoneHandlerT& done);
   void setSslReplyErrorHandlingOptions(QNetworkReply* reply);
   std::string processHostGroupsJsonValue(const QScriptValue& hostGroupJsonValue);
   std::string processHostJsonValue(const QScriptValue& hostJsonValue);
@@ -37,9 +37,10 @@ const RequestListT ZnsHelper::ContentTypes = ZnsHelper::contentTypes();
 const RequestListT ZnsHelper::Routers = ZnsHelper::routers();
 
 ZnsHelper::ZnsHelper(const QString& baseUrl)
-  : QNetworkAccessManager(),
+  : QObject(),
     m_apiBaseUrl(baseUrl),
-    m_isLogged(false)
+    m_isLogged(false),
+    m_pendingReplies(0)
 {
   m_reqHandler.setUrl(QUrl(m_apiBaseUrl+ZNS_API_CONTEXT));
 }
@@ -54,15 +55,12 @@ void ZnsHelper::setBaseUrl(const QString& url)
   m_reqHandler.setUrl(QUrl(m_apiBaseUrl+ZNS_LOGIN_API_CONTEXT));
 }
 
-QNetworkReply* ZnsHelper::postRequest(int reqType, const QByteArray& data)
+void ZnsHelper::postRequest(int reqType, const QByteArray& data, const HttpTransport::ReplyHandlerT& handler)
 {
   m_reqHandler.setRawHeader("Content-Type", ngrt4n::toByteArray(ContentTypes[reqType]));
-  QNetworkReply* reply = QNetworkAccessManager::post(m_reqHandler, data);
+  QNetworkReply* reply = HttpTransport::local()->post(m_reqHandler, data);
   setSslReplyErrorHandlingOptions(reply);
-  connect(reply, SIGNAL(finished()), &m_evlHandler, SLOT(quit()));
-  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(processError(QNetworkReply::NetworkError)));
-  m_evlHandler.exec();
-  return reply;
+  HttpTransport::whenFinished(reply, this, handler);
 }
 
 void ZnsHelper::setRouterEndpoint(const int& reqType) {
@@ -159,14 +157,15 @@ ZnsHelper::checkRPCResultStatus(void)
   return true;
 }
 
-int
-ZnsHelper::openSession(const SourceT& srcInfo)
+void
+ZnsHelper::openSession(const SourceT& srcInfo, const HttpTransport::DoneHandlerT& done)
 {
   setBaseUrl(srcInfo.mon_url);
   QStringList authInfo = ngrt4n::getAuthInfo(srcInfo.auth);
   if (authInfo.size() != 2) {
     m_lastError = tr("Bad auth string, should be in the form of login:password");
-    return -1;
+    done(-1);
+    return;
   }
 
   setBaseUrl(srcInfo.mon_url);
@@ -182,18 +181,14 @@ ZnsHelper::openSession(const SourceT& srcInfo)
   params.addQueryItem("submitted", "true");
   params.addQueryItem("came_from", getApiContextEndpoint());
   setSslPeerVerification(srcInfo.verify_ssl_peer);
-  QNetworkReply* response = nullptr;
+  HttpTransport::ReplyHandlerT handleLoginReply = [this, done](QNetworkReply* reply) {
+    done(processLoginReply(reply) != 0 ? -1 : 0);
+  };
 #if QT_VERSION < QT_VERSION_CHECK(5,0,0)
-  response = postRequest(ZnsHelper::Login, params.encodedQuery());
+  postRequest(ZnsHelper::Login, params.encodedQuery(), handleLoginReply);
 #else
-  response = postRequest(ZnsHelper::Login, params.query(QUrl::FullyEncoded).toUtf8());
+  postRequest(ZnsHelper::Login, params.query(QUrl::FullyEncoded).toUtf8(), handleLoginReply);
 #endif
-
-  if (! response || processLoginReply(response) != 0) {
-    return -1;
-  }
-
-  return 0;
 }
 
 int
@@ -207,7 +202,7 @@ ZnsHelper::processLoginReply(QNetworkReply* reply)
   QVariant cookiesContainer = reply->header(QNetworkRequest::SetCookieHeader);
   QList<QNetworkCookie> cookies = qvariant_cast<QList<QNetworkCookie> >(cookiesContainer);
   if (m_replyData.endsWith("submitted=true")) {
-    cookieJar()->setCookiesFromUrl(cookies, m_apiBaseUrl);
+    HttpTransport::local()->cookieJar()->setCookiesFromUrl(cookies, m_apiBaseUrl);
     m_isLogged =  true;
     returnValue = 0;
   } else {
@@ -312,22 +307,24 @@ ZnsHelper::processDeviceInfoReply(QNetworkReply* reply, ChecksT& checks)
 
 
 
-int
-ZnsHelper::processDeviceReply(QNetworkReply* reply, ChecksT& checks)
+void
+ZnsHelper::processDeviceReply(QNetworkReply* reply, const HttpTransport::DoneHandlerT& done)
 {
-  if (parseReply(reply) != 0)
-    return -1;
-
-  if (! checkRPCResultStatus())
-    return -1;
+  if (parseReply(reply) != 0 || ! checkRPCResultStatus()) {
+    done(-1);
+    return;
+  }
 
   // check weird reponse
   qint32 tid = m_replyJsonData.getProperty("tid").toInt32();
   if (tid != ZnsHelper::Device) {
     m_lastError = tr("Weird transaction type set for device (%1)").arg(tid);
-    return -1;
+    done(-1);
+    return;
   }
 
+  // the components and the ping info of all the devices are requested at once
+  m_pendingReplies = 0;
   QScriptValueIterator devices(m_replyJsonData.getProperty("result").property("devices"));
   while (devices.hasNext()) {
     devices.next();
@@ -335,54 +332,121 @@ ZnsHelper::processDeviceReply(QNetworkReply* reply, ChecksT& checks)
 
     QScriptValue curDevice = devices.value();
     QString deviceUid = curDevice.property("uid").toString();
-    QNetworkReply* response = nullptr;
-    response = postRequest(Component, ngrt4n::toByteArray(ReqPatterns[Component].arg(deviceUid, QString::number(Component))));
-    processComponentReply(response, checks);
+    m_pendingReplies += 2;
+    postRequest(Component, ngrt4n::toByteArray(ReqPatterns[Component].arg(deviceUid, QString::number(Component))),
+                [this, done](QNetworkReply* response) {
+      processComponentReply(response, m_filterChecks);
+      handleDeviceDetailsReply(done);
+    });
 
     //retrieve ping info
-    response = postRequest(DeviceInfo, ngrt4n::toByteArray(ReqPatterns[DeviceInfo].arg(deviceUid, QString::number(DeviceInfo))));
-    processDeviceInfoReply(response, checks);
+    postRequest(DeviceInfo, ngrt4n::toByteArray(ReqPatterns[DeviceInfo].arg(deviceUid, QString::number(DeviceInfo))),
+                [this, done](QNetworkReply* response) {
+      processDeviceInfoReply(response, m_filterChecks);
+      handleDeviceDetailsReply(done);
+    });
+  }
+
+  if (m_pendingReplies == 0) {
+    done(0);
   }
-  return 0;
 }
 
 
-int
-ZnsHelper::loadChecks(const SourceT& srcInfo, ChecksT& checks,
-                      const QString& filterValue, ngrt4n::RequestFilterT filterType)
+void
+ZnsHelper::handleDeviceDetailsReply(const HttpTransport::DoneHandlerT& done)
 {
-  setBaseUrl(srcInfo.mon_url);
+  // a device missing details is left out, it does not fail the others
+  if (--m_pendingReplies == 0) {
+    done(0);
+  }
+}
 
-  // Log in if not yet the case
-  if (! m_isLogged && openSession(srcInfo) != 0) {
-    return ngrt4n::RcGenericFailure;
+
+void
+ZnsHelper::loadChecks(const SourceT& srcInfo, const QStringList& hostOrGroupNames, const HttpTransport::DoneHandlerT& done)
+{
+  // the API only selects one device or group per request, at least within a single session
+  m_checks.clear();
+  if (hostOrGroupNames.isEmpty()) {
+    loadFilterChecks(srcInfo, QString(), ngrt4n::HostFilter, [this, done](int rc) {
+      m_checks = m_filterChecks;
+      done(rc);
+    });
+    return;
+  }
+  loadNextFilterChecks(srcInfo, hostOrGroupNames, 0, done);
+}
+
+
+void
+ZnsHelper::loadNextFilterChecks(const SourceT& srcInfo, const QStringList& hostOrGroupNames, int index,
+                                const HttpTransport::DoneHandlerT& done)
+{
+  if (index >= hostOrGroupNames.size()) {
+    done(ngrt4n::RcSuccess);
+    return;
   }
 
+  // a name matching no host is taken as a group
+  const QString& filter = hostOrGroupNames[index];
+  loadFilterChecks(srcInfo, filter, ngrt4n::HostFilter, [this, srcInfo, hostOrGroupNames, index, filter, done](int rc) {
+    HttpTransport::DoneHandlerT mergeFilterChecks = [this, srcInfo, hostOrGroupNames, index, done](int rc) {
+      if (rc != ngrt4n::RcSuccess) {
+        done(rc);
+        return;
+      }
+      for (auto check = m_filterChecks.begin(); check != m_filterChecks.end(); ++check) {
+        m_checks.insert(check.key(), check.value());
+      }
+      loadNextFilterChecks(srcInfo, hostOrGroupNames, index + 1, done);
+    };
+    if (rc == ngrt4n::RcSuccess && m_filterChecks.empty()) {
+      loadFilterChecks(srcInfo, filter, ngrt4n::GroupFilter, mergeFilterChecks);
+    } else {
+      mergeFilterChecks(rc);
+    }
+  });
+}
+
+
+void
+ZnsHelper::loadFilterChecks(const SourceT& srcInfo, const QString& filterValue, ngrt4n::RequestFilterT filterType,
+                            const HttpTransport::DoneHandlerT& done)
+{
+  setBaseUrl(srcInfo.mon_url);
+  m_filterChecks.clear();
+
+  // Log in if not yet the case
   if (! m_isLogged) {
-    return ngrt4n::RcGenericFailure;
+    openSession(srcInfo, [this, srcInfo, filterValue, filterType, done](int rc) {
+      if (rc != 0 || ! m_isLogged) {
+        done(ngrt4n::RcGenericFailure);
+        return;
+      }
+      loadFilterChecks(srcInfo, filterValue, filterType, done);
+    });
+    return;
   }
 
-  checks.clear();
-  QNetworkReply* response = nullptr;
+  HttpTransport::ReplyHandlerT handleDeviceReply = [this, done](QNetworkReply* response) {
+    processDeviceReply(response, [done](int rc) {
+      done(rc != 0 ? ngrt4n::RcGenericFailure : ngrt4n::RcSuccess);
+    });
+  };
 
   setRouterEndpoint(Device);
   if (filterType == ngrt4n::GroupFilter) {
-    response = postRequest(Device, ngrt4n::toByteArray(ReqPatterns[Device].arg("groups", filterValue, QString::number(Device))));
+    postRequest(Device, ngrt4n::toByteArray(ReqPatterns[Device].arg("groups", filterValue, QString::number(Device))), handleDeviceReply);
   } else {
-    response = postRequest(Device, ngrt4n::toByteArray(ReqPatterns[Device].arg("name", filterValue, QString::number(Device))));
+    postRequest(Device, ngrt4n::toByteArray(ReqPatterns[Device].arg("name", filterValue, QString::number(Device))), handleDeviceReply);
   }
-
-  if (! response || processDeviceReply(response, checks) !=0)  {
-    return ngrt4n::RcGenericFailure;
-  }
-
-  return ngrt4n::RcSuccess;
 }
 
 void
 ZnsHelper::setSslReplyErrorHandlingOptions(QNetworkReply* reply)
 {
-  reply->setSslConfiguration(m_sslConfig);
+  HttpTransport::setSslConfiguration(reply, m_sslConfig);
   if (m_sslConfig.peerVerifyMode() == QSslSocket::VerifyNone)
     reply->ignoreSslErrors();
 }
@@ -28,7 +28,7 @@
 #include "Base.hpp"
 #include "JsonHelper.hpp"
 #include <QtNetwork/QNetworkReply>
-#include <QtNetwork/QNetworkAccessManager>
+#include "HttpTransport.hpp"
 #include <QtNetwork/QSslConfiguration>
 
 namespace {
@@ -36,7 +36,7 @@ namespace {
   const QString ZNS_LOGIN_API_CONTEXT = "/zport/acl_users/cookieAuthHelper/login";
   }
 
-class ZnsHelper : public QNetworkAccessManager {
+class ZnsHelper : public QObject {
   Q_OBJECT
 
 public:
@@ -61,8 +61,8 @@ public:
   routers();
   void
   setBaseUrl(const QString & url);
-  QNetworkReply*
-  postRequest(int reqId,  const QByteArray & data);
+  void
+  postRequest(int reqId,  const QByteArray & data, const HttpTransport::ReplyHandlerT& handler);
   void
   setRouterEndpoint(const int & reqType);
   QString
@@ -89,38 +89,40 @@ public:
   parseReply(QNetworkReply* reply);
   bool
   checkRPCResultStatus(void);
-  int
-  openSession(const SourceT& srcInfo);
+  void
+  openSession(const SourceT& srcInfo, const HttpTransport::DoneHandlerT& done);
   int
   processLoginReply(QNetworkReply* reply);
-  int
-  processDeviceReply(QNetworkReply* reply, ChecksT& checks);
+  void
+  processDeviceReply(QNetworkReply* reply, const HttpTransport::DoneHandlerT& done);
   int
   processDeviceInfoReply(QNetworkReply* reply, ChecksT& checks);
   int
   processComponentReply(QNetworkReply* reply, ChecksT& checks);
-  int
-  loadChecks(const SourceT& srcInfo, ChecksT& checks,  const QString& filterValue,
-             ngrt4n::RequestFilterT filterType = ngrt4n::HostFilter);
-
-
-public Q_SLOTS:
-  void processError(const QNetworkReply::NetworkError& code) { m_evlHandler.exit(code); }
+  void
+  loadChecks(const SourceT& srcInfo, const QStringList& hostOrGroupNames, const HttpTransport::DoneHandlerT& done);
+  const ChecksT&
+  checks(void) const {return m_checks;}
 
-Q_SIGNALS:
-  void propagateError(QNetworkReply::NetworkError);
 
 private :
   QString m_apiBaseUrl;
   QNetworkRequest m_reqHandler;
-  QEventLoop m_evlHandler;
   bool m_isLogged;
   QSslConfiguration m_sslConfig;
   QString m_lastError;
   QString m_replyData;
   JsonHelper m_replyJsonData;
+  ChecksT m_checks;
+  ChecksT m_filterChecks;
+  int m_pendingReplies;
 
   void setSslReplyErrorHandlingOptions(QNetworkReply* reply);
+  void loadNextFilterChecks(const SourceT& srcInfo, const QStringList& hostOrGroupNames, int index,
+                            const HttpTransport::DoneHandlerT& done);
+  void loadFilterChecks(const SourceT& srcInfo, const QString& filterValue, ngrt4n::RequestFilterT filterType,
+                        const HttpTransport::DoneHandlerT& done);
+  void handleDeviceDetailsReply(const HttpTransport::DoneHandlerT& done);
   std::string parseHostGroups(const QScriptValue& json);
 };
 
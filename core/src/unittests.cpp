@@ -1,5 +1,16 @@
 #include "StatusAggregator.hpp"
+#include "WebBiFetchTracker.hpp"
+#include "DashboardBase.hpp"
+#include "QosSegmentStore.hpp"
+#include "QosCollector.hpp"
+#include "DbSession.hpp"
+#include "CircuitBreaker.hpp"
+#include "StatusSnapshot.hpp"
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
 #include <QtTest/QTest>
 
 class TestStatusAggregation : public QObject
@@ -26,6 +37,7 @@ private Q_SLOTS:
   void testWeighted4(void);
   void testLoadbalancedWebsite(void);
   void testWorst(void);
+  void testAddSeverities(void);
 
 private:
   StatusAggregator* m_StatusAggregator;
@@ -151,6 +163,794 @@ void TestStatusAggregation::testWorst(void)
   QCOMPARE(m_StatusAggregator->aggregate(CalcRules::Worst, thresholdsLimits), static_cast<int>(ngrt4n::Unknown));
 }
 
-QTEST_MAIN(TestStatusAggregation)
+void TestStatusAggregation::testAddSeverities(void)
+{
+  const ngrt4n::AggregatedSeverityT statuses[] = {
+    {ngrt4n::Major, ngrt4n::WEIGHT_UNIT},
+    {ngrt4n::Minor, 2 * ngrt4n::WEIGHT_UNIT},
+    {ngrt4n::Unset, ngrt4n::WEIGHT_UNIT},
+    {ngrt4n::Critical, 0},
+    {ngrt4n::Normal, ngrt4n::WEIGHT_MAX}
+  };
+  const int count = sizeof(statuses) / sizeof(statuses[0]);
+
+  StatusAggregator expected;
+  for (int index = 0; index < count; ++index) {
+    expected.addSeverity(statuses[index].sev, statuses[index].weight);
+  }
+
+  m_StatusAggregator->resetData();
+  m_StatusAggregator->addSeverities(statuses, count);
+
+  QCOMPARE(m_StatusAggregator->count(), expected.count());
+  QCOMPARE(m_StatusAggregator->totalWeight(), expected.totalWeight());
+  QCOMPARE(m_StatusAggregator->minSev(), expected.minSev());
+  QCOMPARE(m_StatusAggregator->maxSev(), expected.maxSev());
+
+  QVector<ThresholdT> thresholdsLimits;
+  m_StatusAggregator->addThresholdLimit(thresholdsLimits, {0.25, ngrt4n::Unknown, ngrt4n::Critical});
+  QCOMPARE(m_StatusAggregator->aggregate(CalcRules::WeightedAverageWithThresholds, thresholdsLimits),
+           expected.aggregate(CalcRules::WeightedAverageWithThresholds, thresholdsLimits));
+  QCOMPARE(m_StatusAggregator->toDetailsString(), expected.toDetailsString());
+}
+
+
+class TestBiFetchTracker : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void testFetchFromWindowStart(void);
+  void testViewWithoutEntries(void);
+  void testFreshEntries(void);
+  void testWindowChanged(void);
+
+private:
+  static QosDataT entry(long timestamp);
+};
+
+QosDataT TestBiFetchTracker::entry(long timestamp)
+{
+  QosDataT qosData;
+  qosData.timestamp = timestamp;
+  qosData.status = ngrt4n::Normal;
+  return qosData;
+}
+
+void TestBiFetchTracker::testFetchFromWindowStart(void)
+{
+  WebBiFetchTracker tracker;
+  tracker.setWindow(1000, 5000);
+  QCOMPARE(tracker.nextFetchTime(QList<std::string>() << "view1" << "view2"), 1000L);
+  QCOMPARE(tracker.nextFetchTime(QList<std::string>()), 1000L);
+
+  tracker.markFetched("view1", QosDataList{entry(1200), entry(1500)}, 2000);
+  QCOMPARE(tracker.nextFetchTime(QList<std::string>() << "view1" << "view2"), 1000L);
+  QCOMPARE(tracker.nextFetchTime(QList<std::string>() << "view1"), 1500L);
+}
+
+void TestBiFetchTracker::testViewWithoutEntries(void)
+{
+  WebBiFetchTracker tracker;
+  tracker.setWindow(1000, 5000);
+  QList<std::string> viewNames = QList<std::string>() << "view1" << "view2";
+
+  // the view without entries doesn't hold the next fetches at the start of the window
+  tracker.markFetched("view1", QosDataList{entry(1200), entry(1500)}, 2000);
+  tracker.markFetched("view2", QosDataList(), 2000);
+  QVERIFY(tracker.isLoaded("view2"));
+  QCOMPARE(tracker.nextFetchTime(viewNames), 1500L);
+
+  // no entries again, the view keeps its marker
+  tracker.markFetched("view1", QosDataList{entry(2500)}, 3000);
+  tracker.markFetched("view2", QosDataList(), 3000);
+  QCOMPARE(tracker.loadedTime("view2"), 2000L);
+  QCOMPARE(tracker.nextFetchTime(viewNames), 2000L);
+
+  // its first entry is taken as fresh
+  QosDataList freshEntries = tracker.freshEntries("view2", QosDataList{entry(2800)});
+  QCOMPARE(static_cast<int>(freshEntries.size()), 1);
+  tracker.markFetched("view2", freshEntries, 3500);
+  QCOMPARE(tracker.nextFetchTime(viewNames), 2500L);
+}
+
+void TestBiFetchTracker::testFreshEntries(void)
+{
+  WebBiFetchTracker tracker;
+  tracker.setWindow(1000, 5000);
+  QosDataList entries{entry(1200), entry(1500), entry(1800)};
+
+  QCOMPARE(static_cast<int>(tracker.freshEntries("view1", entries).size()), 3);
+  tracker.markFetched("view1", QosDataList{entry(1200), entry(1500)}, 1600);
+
+  QosDataList freshEntries = tracker.freshEntries("view1", entries);
+  QCOMPARE(static_cast<int>(freshEntries.size()), 1);
+  QCOMPARE(freshEntries.front().timestamp, 1800L);
+}
+
+void TestBiFetchTracker::testWindowChanged(void)
+{
+  WebBiFetchTracker tracker;
+  tracker.setWindow(1000, 5000);
+  tracker.markFetched("view1", QosDataList{entry(1200)}, 2000);
+
+  tracker.setWindow(1000, 5000);
+  QVERIFY(tracker.isLoaded("view1"));
+
+  tracker.setWindow(3000, 6000);
+  QVERIFY(! tracker.isLoaded("view1"));
+  QCOMPARE(tracker.nextFetchTime(QList<std::string>() << "view1"), 3000L);
+}
+
+class TestBpNodeAggregation : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void testSequentialLevel(void);
+  void testParallelLevel(void);
+  void testNestedLevels(void);
+
+private:
+  /** renders nothing, only the status computation of the dashboard is exercised */
+  class TestDashboard : public DashboardBase
+  {
+  public:
+    TestDashboard(void) : DashboardBase(nullptr) {}
+    CoreDataT& cdata(void) {return m_cdata;}
+
+  protected:
+    virtual void buildMap(void) {}
+    virtual void updateMap(const NodeT&, const QString&) {}
+    virtual void buildTree(void) {}
+    virtual void updateTree(const NodeT&, const QString&) {}
+    virtual void updateMsgConsole(const NodeT&) {}
+    virtual void updateChart(void) {}
+    virtual void updateEventFeeds(const NodeT&) {}
+  };
+
+  static NodeT node(const QString& id, int type, int calcRule, const QString& children);
+  static int expectedStatus(const CoreDataT& cdata, const QString& nodeId);
+  static void buildServiceTree(CoreDataT& cdata, int serviceCount);
+  static void checkAggregation(int serviceCount);
+};
+
+NodeT TestBpNodeAggregation::node(const QString& id, int type, int calcRule, const QString& children)
+{
+  NodeT result = NodeT();
+  result.id = id;
+  result.name = id;
+  result.type = type;
+  result.sev = ngrt4n::Unknown;
+  result.sev_prop = ngrt4n::Unknown;
+  result.sev_crule = calcRule;
+  result.sev_prule = PropRules::Unchanged;
+  result.weight = ngrt4n::WEIGHT_UNIT;
+  result.child_nodes = children;
+  return result;
+}
+
+/** aggregates the children of the node one by one, as a reference for the level-wise computation */
+int TestBpNodeAggregation::expectedStatus(const CoreDataT& cdata, const QString& nodeId)
+{
+  auto bpnode = cdata.bpnodes.constFind(nodeId);
+  StatusAggregator aggregator;
+  for (const auto& childId: bpnode->child_nodes.split(ngrt4n::CHILD_Q_SEP)) {
+    auto cnode = cdata.cnodes.constFind(childId);
+    if (cnode != cdata.cnodes.cend()) {
+      aggregator.addSeverity(cnode->sev_prop, cnode->weight);
+    } else if (cdata.bpnodes.contains(childId)) {
+      aggregator.addSeverity(StatusAggregator::propagate(expectedStatus(cdata, childId), PropRules::Unchanged), ngrt4n::WEIGHT_UNIT);
+    } else {
+      aggregator.addSeverity(ngrt4n::Unknown, ngrt4n::WEIGHT_UNIT);
+    }
+  }
+  return aggregator.aggregate(bpnode->sev_crule, bpnode->thresholdLimits);
+}
+
+void TestBpNodeAggregation::buildServiceTree(CoreDataT& cdata, int serviceCount)
+{
+  QStringList serviceIds;
+  for (int index = 0; index < serviceCount; ++index) {
+    QString serviceId = QString("service%1").arg(index);
+    QStringList checkIds;
+    for (int checkIndex = 0; checkIndex < 3; ++checkIndex) {
+      QString checkId = QString("%1/check%2").arg(serviceId).arg(checkIndex);
+      NodeT cnode = node(checkId, NodeType::ITService, CalcRules::Worst, checkId);
+      cnode.sev = (index + checkIndex) % (ngrt4n::Critical + 1);
+      cnode.sev_prop = cnode.sev;
+      cdata.cnodes.insert(checkId, cnode);
+      checkIds.push_back(checkId);
+    }
+    int calcRule = (index % 2 == 0) ? CalcRules::Worst : CalcRules::Average;
+    cdata.bpnodes.insert(serviceId, node(serviceId, NodeType::BusinessService, calcRule, checkIds.join(ngrt4n::CHILD_Q_SEP)));
+    serviceIds.push_back(serviceId);
+  }
+  cdata.bpnodes.insert(ngrt4n::ROOT_ID, node(ngrt4n::ROOT_ID, NodeType::BusinessService, CalcRules::Worst, serviceIds.join(ngrt4n::CHILD_Q_SEP)));
+}
+
+void TestBpNodeAggregation::checkAggregation(int serviceCount)
+{
+  TestDashboard dashboard;
+  buildServiceTree(dashboard.cdata(), serviceCount);
+  dashboard.computeAllBpNodesStatus(nullptr);
+
+  const CoreDataT& cdata = dashboard.cdata();
+  for (auto bpnode = cdata.bpnodes.cbegin(); bpnode != cdata.bpnodes.cend(); ++bpnode) {
+    QCOMPARE(bpnode->sev, expectedStatus(cdata, bpnode.key()));
+    QCOMPARE(bpnode->sev_prop, StatusAggregator::propagate(bpnode->sev, bpnode->sev_prule));
+  }
+
+  // a second run over the same checks gives the same statuses
+  NodeListT firstRun = cdata.bpnodes;
+  dashboard.computeAllBpNodesStatus(nullptr);
+  for (auto bpnode = firstRun.cbegin(); bpnode != firstRun.cend(); ++bpnode) {
+    QCOMPARE(cdata.bpnodes[bpnode.key()].sev, bpnode->sev);
+    QCOMPARE(cdata.bpnodes[bpnode.key()].actual_msg, bpnode->actual_msg);
+  }
+}
+
+void TestBpNodeAggregation::testSequentialLevel(void)
+{
+  checkAggregation(8);
+}
+
+void TestBpNodeAggregation::testParallelLevel(void)
+{
+  checkAggregation(ngrt4n::MinParallelAggregationLevelSize + 8);
+}
+
+void TestBpNodeAggregation::testNestedLevels(void)
+{
+  TestDashboard dashboard;
+  CoreDataT& cdata = dashboard.cdata();
+  buildServiceTree(cdata, 4);
+
+  // the root gets a deeper branch, and a service refers to a node that does not exist
+  cdata.bpnodes.insert("group", node("group", NodeType::BusinessService, CalcRules::Worst, "service1,service2"));
+  cdata.bpnodes["root"].child_nodes = "group,service0,service3";
+  cdata.bpnodes["service2"].child_nodes.append(",missing");
+  dashboard.computeAllBpNodesStatus(nullptr);
+
+  QCOMPARE(cdata.bpnodes["service2"].sev, static_cast<int>(ngrt4n::Unknown));
+  QCOMPARE(cdata.bpnodes["group"].sev, expectedStatus(cdata, "group"));
+  QCOMPARE(cdata.bpnodes["root"].sev, expectedStatus(cdata, "root"));
+}
+
+
+class TestQosSegmentStore : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void testAppend(void);
+  void testPartialRecord(void);
+  void testBisection(void);
+
+private:
+  static QosDataT entry(const std::string& viewName, long timestamp, int status);
+};
+
+QosDataT TestQosSegmentStore::entry(const std::string& viewName, long timestamp, int status)
+{
+  QosDataT qosData;
+  qosData.view_name = viewName;
+  qosData.timestamp = timestamp;
+  qosData.status = status;
+  qosData.normal = 62.5;
+  qosData.minor = 12.25;
+  qosData.major = 0;
+  qosData.critical = 25.25;
+  qosData.unknown = 0;
+  return qosData;
+}
+
+void TestQosSegmentStore::testAppend(void)
+{
+  QTemporaryDir storeDir;
+  QVERIFY(storeDir.isValid());
+  QosSegmentStore store(storeDir.path());
+
+  // the second day goes to a new segment, an entry older than the last one is refused
+  const long day = QosSegmentStore::SegmentSpan;
+  QCOMPARE(store.append(entry("view/1", 10 * day + 60, ngrt4n::Normal)), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(store.append(entry("view/1", 10 * day + 120, ngrt4n::Major)), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(store.append(entry("view/1", 11 * day + 60, ngrt4n::Unset)), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(store.append(entry("view/1", 11 * day + 30, ngrt4n::Normal)), static_cast<int>(ngrt4n::RcGenericFailure));
+
+  QosDataListMapT qosDataMap;
+  QCOMPARE(store.list(qosDataMap, "view/1", 0, 12 * day), 3);
+  const QosDataList& entries = qosDataMap["view/1"];
+  QCOMPARE(entries[0].timestamp, 10 * day + 60);
+  QCOMPARE(entries[1].status, static_cast<int>(ngrt4n::Major));
+  QCOMPARE(entries[2].status, static_cast<int>(ngrt4n::Unset));
+  QCOMPARE(entries[2].normal, 62.5f);
+  QCOMPARE(entries[2].minor, 12.25f);
+  QCOMPARE(entries[2].critical, 25.25f);
+
+  QCOMPARE(store.listViews(), std::list<std::string>{"view/1"});
+  QosDataT preceding;
+  QVERIFY(store.findPreceding(preceding, "view/1", 11 * day + 60));
+  QCOMPARE(preceding.timestamp, 10 * day + 120);
+}
+
+void TestQosSegmentStore::testPartialRecord(void)
+{
+  QTemporaryDir storeDir;
+  QVERIFY(storeDir.isValid());
+  QosSegmentStore store(storeDir.path());
+  QCOMPARE(store.append(entry("view", 60, ngrt4n::Normal)), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(store.append(entry("view", 120, ngrt4n::Minor)), static_cast<int>(ngrt4n::RcSuccess));
+
+  // an interrupted append leaves the first bytes of a record
+  QFile segment(QString("%1/view/0.qseg").arg(storeDir.path()));
+  QVERIFY(segment.open(QIODevice::Append));
+  QCOMPARE(segment.write("\x3c\x00\x00", 3), 3LL);
+  segment.close();
+
+  QosDataListMapT qosDataMap;
+  QCOMPARE(store.list(qosDataMap, "view", 0, 1000), 2);
+
+  // it is cut on the next append, which lands right after the complete records
+  QCOMPARE(store.append(entry("view", 180, ngrt4n::Critical)), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(segment.size(), static_cast<qint64>(QosSegmentStore::HeaderSize + 3 * QosSegmentStore::RecordSize));
+  QCOMPARE(store.list(qosDataMap, "view", 0, 1000), 3);
+  QCOMPARE(qosDataMap["view"].back().timestamp, 180L);
+  QCOMPARE(qosDataMap["view"].back().status, static_cast<int>(ngrt4n::Critical));
+}
+
+void TestQosSegmentStore::testBisection(void)
+{
+  QTemporaryDir storeDir;
+  QVERIFY(storeDir.isValid());
+  QosSegmentStore store(storeDir.path());
+  for (long timestamp = 10; timestamp <= 1000; timestamp += 10) {
+    QCOMPARE(store.append(entry("view", timestamp, ngrt4n::Normal)), static_cast<int>(ngrt4n::RcSuccess));
+  }
+
+  QosDataListMapT qosDataMap;
+  QCOMPARE(store.list(qosDataMap, "view", 255, 500), 25);
+  QCOMPARE(qosDataMap["view"].front().timestamp, 260L);
+  QCOMPARE(qosDataMap["view"].back().timestamp, 500L);
+
+  QCOMPARE(store.list(qosDataMap, "view", 0, 10), 1);
+  QCOMPARE(store.list(qosDataMap, "view", 1000, 2000), 1);
+  QCOMPARE(store.list(qosDataMap, "view", 1001, 2000), 0);
+  QVERIFY(qosDataMap.isEmpty());
+}
+
+
+class TestQosRecordingFilter : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void testDisabled(void);
+  void testEpsilon(void);
+  void testHeartbeat(void);
+
+private:
+  static QosDataT sample(const std::string& viewName, long timestamp, int status, float normal);
+};
+
+QosDataT TestQosRecordingFilter::sample(const std::string& viewName, long timestamp, int status, float normal)
+{
+  QosDataT qosData;
+  qosData.view_name = viewName;
+  qosData.timestamp = timestamp;
+  qosData.status = status;
+  qosData.normal = normal;
+  qosData.minor = 100 - normal;
+  qosData.major = 0;
+  qosData.critical = 0;
+  qosData.unknown = 0;
+  return qosData;
+}
+
+void TestQosRecordingFilter::testDisabled(void)
+{
+  QosRecordingFilter filter(false, 1.0, 300);
+  QVERIFY(filter.accept(sample("view", 0, ngrt4n::Normal, 100)));
+  QVERIFY(filter.accept(sample("view", 10, ngrt4n::Normal, 100)));
+}
+
+void TestQosRecordingFilter::testEpsilon(void)
+{
+  QosRecordingFilter filter(true, 1.0, 300);
+  QVERIFY(filter.accept(sample("view1", 0, ngrt4n::Normal, 90)));
+  QVERIFY(filter.accept(sample("view2", 0, ngrt4n::Normal, 90)));
+  QVERIFY(! filter.accept(sample("view1", 10, ngrt4n::Normal, 90)));
+
+  // the moves are measured from the last recorded sample, so small ones add up
+  QVERIFY(! filter.accept(sample("view1", 20, ngrt4n::Normal, 90.6f)));
+  QVERIFY(filter.accept(sample("view1", 30, ngrt4n::Normal, 91.2f)));
+  QVERIFY(! filter.accept(sample("view1", 40, ngrt4n::Normal, 90.5f)));
+
+  // a status change is recorded whatever the ratios
+  QVERIFY(filter.accept(sample("view1", 50, ngrt4n::Minor, 91.2f)));
+  QVERIFY(! filter.accept(sample("view2", 50, ngrt4n::Normal, 90)));
+}
+
+void TestQosRecordingFilter::testHeartbeat(void)
+{
+  QosRecordingFilter filter(true, 1.0, 300);
+  QVERIFY(filter.accept(sample("view", 1000, ngrt4n::Normal, 100)));
+  QVERIFY(! filter.accept(sample("view", 1299, ngrt4n::Normal, 100)));
+  QVERIFY(filter.accept(sample("view", 1300, ngrt4n::Normal, 100)));
+  QVERIFY(! filter.accept(sample("view", 1301, ngrt4n::Normal, 100)));
+}
+
+
+class TestViewLeases : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void initTestCase(void);
+  void cleanupTestCase(void);
+  void testSingleCollector(void);
+  void testRebalancing(void);
+  void testRelease(void);
+
+private:
+  static const long LeaseTtl = 90;
+  static const long ReleaseGrace = -1; // the released views are free right away
+  QTemporaryDir m_dbDir;
+  DbSession* m_dbSession;
+
+  QSet<QString> acquire(const std::string& collectorId);
+};
+
+void TestViewLeases::initTestCase(void)
+{
+  QVERIFY(m_dbDir.isValid());
+  m_dbSession = new DbSession(Sqlite3Db, QString("%1/realopinsight.db").arg(m_dbDir.path()).toStdString());
+  QVERIFY(m_dbSession->isConnected());
+  QCOMPARE(m_dbSession->initDb(), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(m_dbSession->setupLastQosDataTable(), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(m_dbSession->setupCollectorLeaseTables(), static_cast<int>(ngrt4n::RcSuccess));
+
+  for (int index = 0; index < 4; ++index) {
+    DboView view;
+    view.name = QString("view%1").arg(index).toStdString();
+    view.path = QString("/tmp/view%1.ngrt4n.xml").arg(index).toStdString();
+    view.service_count = 1;
+    QCOMPARE(m_dbSession->addView(view).first, static_cast<int>(ngrt4n::RcSuccess));
+  }
+}
+
+void TestViewLeases::cleanupTestCase(void)
+{
+  delete m_dbSession;
+}
+
+QSet<QString> TestViewLeases::acquire(const std::string& collectorId)
+{
+  ViewLeaseListT leases;
+  auto acquireOut = m_dbSession->acquireViewLeases(collectorId, LeaseTtl, ReleaseGrace, leases);
+  QSet<QString> viewNames;
+  if (acquireOut.first != ngrt4n::RcSuccess) {
+    qWarning() << acquireOut.second;
+    return viewNames;
+  }
+  for (const auto& lease : leases) {
+    viewNames.insert(QString::fromStdString(lease.view_name));
+  }
+  return viewNames;
+}
+
+void TestViewLeases::testSingleCollector(void)
+{
+  QSet<QString> viewNames = acquire("collector1");
+  QCOMPARE(viewNames.size(), 4);
+
+  // renewing keeps the same views
+  QCOMPARE(acquire("collector1"), viewNames);
+}
+
+void TestViewLeases::testRebalancing(void)
+{
+  // the joining collector only gets views once the other one gave back what exceeds its share
+  QCOMPARE(acquire("collector2").size(), 0);
+  QSet<QString> firstViews = acquire("collector1");
+  QCOMPARE(firstViews.size(), 2);
+  QSet<QString> secondViews = acquire("collector2");
+  QCOMPARE(secondViews.size(), 2);
+  QVERIFY(! firstViews.intersects(secondViews));
+
+  QCOMPARE(acquire("collector1"), firstViews);
+  QCOMPARE(acquire("collector2"), secondViews);
+}
+
+void TestViewLeases::testRelease(void)
+{
+  QCOMPARE(m_dbSession->releaseViewLeases("collector1"), static_cast<int>(ngrt4n::RcSuccess));
+  QCOMPARE(acquire("collector2").size(), 4);
+}
+
+
+class TestCircuitBreaker : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void testThreshold(void);
+  void testBackoff(void);
+  void testSuccessResets(void);
+
+private:
+  static const int FailureThreshold = 3;
+  static const qint64 RetryDelay = 50; // in milliseconds
+  static const qint64 MaxRetryDelay = 150;
+
+  static qint64 retryDelay(CircuitBreaker& breaker, const QString& key);
+};
+
+/** records a failure and returns the delay until the next request is let through */
+qint64 TestCircuitBreaker::retryDelay(CircuitBreaker& breaker, const QString& key)
+{
+  breaker.recordFailure(key);
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  qint64 retryTime = 0;
+  if (breaker.allowRequest(key, &retryTime)) {
+    return 0;
+  }
+  return retryTime - now;
+}
+
+void TestCircuitBreaker::testThreshold(void)
+{
+  CircuitBreaker breaker(FailureThreshold, RetryDelay, MaxRetryDelay);
+  QVERIFY(breaker.allowRequest("source1"));
+  breaker.recordFailure("source1");
+  breaker.recordFailure("source1");
+  QVERIFY(breaker.allowRequest("source1"));
+
+  breaker.recordFailure("source1");
+  qint64 retryTime = 0;
+  QVERIFY(! breaker.allowRequest("source1", &retryTime));
+  QVERIFY(retryTime > QDateTime::currentMSecsSinceEpoch());
+  QVERIFY(breaker.allowRequest("source2"));
+}
+
+void TestCircuitBreaker::testBackoff(void)
+{
+  CircuitBreaker breaker(FailureThreshold, RetryDelay, MaxRetryDelay);
+  breaker.recordFailure("source");
+  breaker.recordFailure("source");
+  qint64 delay = retryDelay(breaker, "source");
+  QVERIFY(delay > 0 && delay <= RetryDelay);
+
+  // a single probe is let through once the delay is over, the others wait for its outcome
+  QTest::qSleep(RetryDelay + 10);
+  QVERIFY(breaker.allowRequest("source"));
+  QVERIFY(! breaker.allowRequest("source"));
+
+  // each failed probe doubles the delay, up to the maximum
+  delay = retryDelay(breaker, "source");
+  QVERIFY(delay > RetryDelay && delay <= 2 * RetryDelay);
+  delay = retryDelay(breaker, "source");
+  QVERIFY(delay > 2 * RetryDelay && delay <= MaxRetryDelay);
+  delay = retryDelay(breaker, "source");
+  QVERIFY(delay > 2 * RetryDelay && delay <= MaxRetryDelay);
+}
+
+void TestCircuitBreaker::testSuccessResets(void)
+{
+  CircuitBreaker breaker(FailureThreshold, RetryDelay, MaxRetryDelay);
+  for (int count = 0; count < FailureThreshold; ++count) {
+    breaker.recordFailure("source");
+  }
+  QVERIFY(! breaker.allowRequest("source"));
+
+  breaker.recordSuccess("source");
+  QVERIFY(breaker.allowRequest("source"));
+  breaker.recordFailure("source");
+  QVERIFY(breaker.allowRequest("source"));
+}
+
+
+class TestStatusSnapshot : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void testSerializeParse(void);
+  void testRejectedContent(void);
+  void testRecords(void);
+  void testMergeRecords(void);
+
+private:
+  static StatusSnapshot::ViewStatusT viewStatus(qint64 timestamp, int sev);
+  static StatusSnapshot::RecordT record(const QString& viewName, const StatusSnapshot::ViewStatusT& view);
+  static bool parse(const QByteArray& content, StatusSnapshot::ViewStatusMapT& views);
+};
+
+StatusSnapshot::ViewStatusT TestStatusSnapshot::viewStatus(qint64 timestamp, int sev)
+{
+  StatusSnapshot::ViewStatusT view;
+  view.timestamp = timestamp;
+  view.notifiedStatus = sev;
+  view.period = 300;
+
+  StatusSnapshot::NodeStatusT bpnode;
+  bpnode.sev = sev;
+  bpnode.sevProp = sev;
+  bpnode.message = QString::fromUtf8("service \xc3\xa9tat %1").arg(sev);
+  bpnode.hasCheck = false;
+  view.nodes.insert("root", bpnode);
+
+  StatusSnapshot::NodeStatusT cnode;
+  cnode.sev = sev;
+  cnode.sevProp = ngrt4n::Minor;
+  cnode.message = "disk usage";
+  cnode.hasCheck = true;
+  cnode.check.status = 2;
+  cnode.check.id = "host1/disk";
+  cnode.check.host = "host1";
+  cnode.check.check_command = "check_disk";
+  cnode.check.last_state_change = "1500000000";
+  cnode.check.alarm_msg = "DISK CRITICAL";
+  cnode.check.host_groups = "linux";
+  view.nodes.insert("host1/disk", cnode);
+  return view;
+}
+
+/** builds a record as published in the database */
+StatusSnapshot::RecordT TestStatusSnapshot::record(const QString& viewName, const StatusSnapshot::ViewStatusT& view)
+{
+  StatusSnapshot::RecordT result;
+  result.timestamp = view.timestamp;
+  result.content = QByteArray(2, '\0');
+  qToLittleEndian<quint16>(StatusSnapshot::FormatVersion, reinterpret_cast<uchar*>(result.content.data()));
+  result.content.append(StatusSnapshot::serializeRecord(viewName, view));
+  return result;
+}
+
+bool TestStatusSnapshot::parse(const QByteArray& content, StatusSnapshot::ViewStatusMapT& views)
+{
+  return StatusSnapshot::parse(reinterpret_cast<const uchar*>(content.constData()), content.size(), views);
+}
+
+void TestStatusSnapshot::testSerializeParse(void)
+{
+  StatusSnapshot::ViewStatusMapT views;
+  views.insert("view1", viewStatus(1000, ngrt4n::Critical));
+  views.insert("view2", StatusSnapshot::ViewStatusT());
+
+  StatusSnapshot::ViewStatusMapT parsedViews;
+  QVERIFY(parse(StatusSnapshot::serialize(views), parsedViews));
+  QCOMPARE(parsedViews.size(), 2);
+  QCOMPARE(parsedViews["view2"].nodes.size(), 0);
+  QCOMPARE(parsedViews["view2"].notifiedStatus, -1);
+
+  const StatusSnapshot::ViewStatusT& view = parsedViews["view1"];
+  QCOMPARE(view.timestamp, 1000LL);
+  QCOMPARE(view.notifiedStatus, static_cast<qint32>(ngrt4n::Critical));
+  QCOMPARE(view.period, 300);
+  QCOMPARE(view.nodes.size(), 2);
+  QCOMPARE(view.nodes["root"].message, views["view1"].nodes["root"].message);
+  QVERIFY(! view.nodes["root"].hasCheck);
+
+  const StatusSnapshot::NodeStatusT& cnode = view.nodes["host1/disk"];
+  QCOMPARE(cnode.sevProp, static_cast<qint32>(ngrt4n::Minor));
+  QVERIFY(cnode.hasCheck);
+  QVERIFY(ngrt4n::isSameCheck(cnode.check, views["view1"].nodes["host1/disk"].check));
+}
+
+void TestStatusSnapshot::testRejectedContent(void)
+{
+  StatusSnapshot::ViewStatusMapT views;
+  views.insert("view1", viewStatus(1000, ngrt4n::Major));
+  const QByteArray content = StatusSnapshot::serialize(views);
+  StatusSnapshot::ViewStatusMapT parsedViews;
+
+  // only the current format version is read
+  for (quint16 version : {static_cast<quint16>(StatusSnapshot::FormatVersion - 1), static_cast<quint16>(StatusSnapshot::FormatVersion + 1)}) {
+    QByteArray otherVersion = content;
+    qToLittleEndian<quint16>(version, reinterpret_cast<uchar*>(otherVersion.data()) + 4);
+    QVERIFY(! parse(otherVersion, parsedViews));
+  }
+
+  QByteArray otherMagic = content;
+  otherMagic[0] = 'X';
+  QVERIFY(! parse(otherMagic, parsedViews));
+  QVERIFY(! parse(content.left(StatusSnapshot::HeaderSize - 1), parsedViews));
+  QVERIFY(! parse(content.left(content.size() - 1), parsedViews));
+
+  QString viewName;
+  StatusSnapshot::ViewStatusT view;
+  const QByteArray viewRecord = StatusSnapshot::serializeRecord("view1", views["view1"]);
+  const uchar* data = reinterpret_cast<const uchar*>(viewRecord.constData());
+  QVERIFY(StatusSnapshot::parseRecord(data, data + viewRecord.size(), viewName, view));
+  QCOMPARE(viewName, QString("view1"));
+  QVERIFY(! StatusSnapshot::parseRecord(data, data + viewRecord.size() - 1, viewName, view));
+}
+
+void TestStatusSnapshot::testRecords(void)
+{
+  StatusSnapshot& snapshot = StatusSnapshot::shared();
+  snapshot.takeUnpublishedRecords();
+
+  // only the views whose status changed are published, once
+  snapshot.updateView("records-view", viewStatus(1000, ngrt4n::Major));
+  snapshot.updateView("records-view", viewStatus(1000, ngrt4n::Major));
+  StatusSnapshot::RecordMapT records = snapshot.takeUnpublishedRecords();
+  QCOMPARE(records.size(), 1);
+  QCOMPARE(records["records-view"].timestamp, 1000LL);
+  QCOMPARE(records["records-view"].content, record("records-view", viewStatus(1000, ngrt4n::Major)).content);
+  QVERIFY(snapshot.takeUnpublishedRecords().isEmpty());
+
+  snapshot.updateView("records-view", viewStatus(1000, ngrt4n::Major));
+  QVERIFY(snapshot.takeUnpublishedRecords().isEmpty());
+
+  // the records not stored are published again with the next ones
+  snapshot.markUnpublished(records);
+  QCOMPARE(snapshot.takeUnpublishedRecords().keys(), records.keys());
+}
+
+void TestStatusSnapshot::testMergeRecords(void)
+{
+  StatusSnapshot& snapshot = StatusSnapshot::shared();
+  snapshot.updateView("merged-view", viewStatus(2000, ngrt4n::Major));
+
+  // the most recent record of a view wins
+  StatusSnapshot::RecordMapT records;
+  records.insert("merged-view", record("merged-view", viewStatus(1000, ngrt4n::Critical)));
+  QCOMPARE(snapshot.mergeRecords(records).first, static_cast<int>(ngrt4n::RcSuccess));
+  StatusSnapshot::ViewStatusT view;
+  QVERIFY(snapshot.findView("merged-view", view));
+  QCOMPARE(view.timestamp, 2000LL);
+
+  records.insert("merged-view", record("merged-view", viewStatus(3000, ngrt4n::Critical)));
+  QCOMPARE(snapshot.mergeRecords(records).first, static_cast<int>(ngrt4n::RcSuccess));
+  QVERIFY(snapshot.findView("merged-view", view));
+  QCOMPARE(view.timestamp, 3000LL);
+  QCOMPARE(view.nodes["root"].sev, static_cast<qint32>(ngrt4n::Critical));
+
+  // a record of another version is reported, the valid ones are still merged
+  StatusSnapshot::RecordT otherVersion = record("other-version-view", viewStatus(1000, ngrt4n::Normal));
+  qToLittleEndian<quint16>(StatusSnapshot::FormatVersion + 1, reinterpret_cast<uchar*>(otherVersion.content.data()));
+  records.clear();
+  records.insert("other-version-view", otherVersion);
+  records.insert("new-view", record("new-view", viewStatus(1000, ngrt4n::Normal)));
+  QCOMPARE(snapshot.mergeRecords(records).first, static_cast<int>(ngrt4n::RcGenericFailure));
+  QVERIFY(! snapshot.contains("other-version-view"));
+  QVERIFY(snapshot.contains("new-view"));
+}
+
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  int status = 0;
+
+  TestStatusAggregation statusAggregation;
+  status |= QTest::qExec(&statusAggregation, argc, argv);
+
+  TestBiFetchTracker biFetchTracker;
+  status |= QTest::qExec(&biFetchTracker, argc, argv);
+
+  TestBpNodeAggregation bpnodeAggregation;
+  status |= QTest::qExec(&bpnodeAggregation, argc, argv);
+
+  TestQosSegmentStore qosSegmentStore;
+  status |= QTest::qExec(&qosSegmentStore, argc, argv);
+
+  TestQosRecordingFilter qosRecordingFilter;
+  status |= QTest::qExec(&qosRecordingFilter, argc, argv);
+
+  TestViewLeases viewLeases;
+  status |= QTest::qExec(&viewLeases, argc, argv);
+
+  TestCircuitBreaker circuitBreaker;
+  status |= QTest::qExec(&circuitBreaker, argc, argv);
+
+  TestStatusSnapshot statusSnapshot;
+  status |= QTest::qExec(&statusSnapshot, argc, argv);
+
+  return status;
+}
+
 #include "unittests.moc"
 
@@ -23,15 +23,11 @@
  */
 
 #include "utilsCore.hpp"
-#include "ZbxHelper.hpp"
-#include "LsHelper.hpp"
-#include "ZnsHelper.hpp"
-#include "PandoraHelper.hpp"
-#include "OpManagerHelper.hpp"
+#include "SourceCollector.hpp"
 #include "ThresholdHelper.hpp"
-#include "K8sHelper.hpp"
 
 #include <QFileInfo>
+#include <QTimer>
 
 
 QString ngrt4n::getAbsolutePath(const QString& _path)
@@ -376,71 +372,58 @@ std::pair<int, QString> ngrt4n::loadDynamicViewByGroup(const SourceT& sinfo, con
 
 std::pair<int, QString> ngrt4n::loadDataItems(const SourceT& sinfo, const QString& filter, ChecksT& checks)
 {
-  // Nagios
-  if (sinfo.mon_type == MonitorT::Nagios) {
-    int retcode = ngrt4n::RcGenericFailure;
-    LsHelper handler(sinfo.ls_addr, static_cast<uint16_t>(sinfo.ls_port));
-    if (handler.setupSocket() == 0 && handler.loadChecks(filter, checks) == 0) {
-      retcode = ngrt4n::RcSuccess;
-    }
-    return std::make_pair(retcode, handler.lastError());
-  }
+  // an empty filter selects all the data points, like an empty filter list
+  return loadDataItems(sinfo, filter.isEmpty() ? QStringList() : QStringList{filter}, checks);
+}
 
-  // Zabbix
-  if (sinfo.mon_type == MonitorT::Zabbix) {
-    ZbxHelper handler;
-    int retcode = handler.loadChecks(sinfo, checks, filter, ngrt4n::GroupFilter);
-    if (checks.empty()) {
-      retcode = handler.loadChecks(sinfo, checks, filter, ngrt4n::HostFilter);
-    }
-    return std::make_pair(retcode, handler.lastError());
-  }
 
+std::pair<int, QString> ngrt4n::loadDataItems(const SourceT& sinfo, const QStringList& filters, ChecksT& checks)
+{
+  // the source is loaded by the collector, this thread only waits for the result
+  SourceCollector::ResultT result = SourceCollector::shared().loadDataItems(sinfo, filters).get();
+  checks = result.checks;
+  return std::make_pair(result.rc, result.error);
+}
 
-  // Zenoss
-  if (sinfo.mon_type == MonitorT::Zenoss) {
-    ZnsHelper handler(sinfo.mon_url);
-    int retcode = handler.loadChecks(sinfo, checks, filter, ngrt4n::HostFilter);
-    if (checks.empty()) {
-      retcode = handler.loadChecks(sinfo, checks, filter, ngrt4n::GroupFilter);
-    }
-    return std::make_pair(retcode, handler.lastError());
-  }
+int ngrt4n::backendTimeout(void)
+{
+  static const int timeout = [] {
+    bool ok = false;
+    int value = qgetenv("REALOPINSIGHT_BACKEND_TIMEOUT").toInt(&ok);
+    return (ok && value > 0) ? value : DefaultBackendTimeout;
+  }();
+  return timeout;
+}
 
 
-  // Pandora
-  if (sinfo.mon_type == MonitorT::Pandora) {
-    PandoraHelper handler(sinfo.mon_url);
-    int retcode = handler.loadChecks(sinfo, checks, filter);
-    return std::make_pair(retcode, handler.lastError());
-  }
+void ngrt4n::setRequestTimeout(QNetworkReply* reply)
+{
+  // aborting the reply emits finished(), which runs the continuation waiting for it
+  QTimer::singleShot(backendTimeout(), reply, SLOT(abort()));
+}
 
 
-  // OpManager
-  if (sinfo.mon_type == MonitorT::OpManager) {
-    int retcode = ngrt4n::RcGenericFailure;
-    OpManagerHelper handler(sinfo.mon_url);
-    if (filter.isEmpty()) {
-      retcode = handler.loadChecks(sinfo, OpManagerHelper::ListAllDevices, filter, checks);
-    } else {
-      retcode = handler.loadChecks(sinfo, OpManagerHelper::ListDeviceByName, filter, checks);
-      if (checks.empty()) {
-        retcode = handler.loadChecks(sinfo, OpManagerHelper::ListDeviceByCategory, filter, checks);
-        if (checks.empty()) {
-          retcode = handler.loadChecks(sinfo, OpManagerHelper::ListDeviceByType, filter, checks);
-        }
-      }
-    }
-    return std::make_pair(retcode, handler.lastError());
-  }
+QThreadPool* ngrt4n::collectorPool(void)
+{
+  // the Livestatus sources are loaded in these threads, the other ones on the collector thread;
+  // a load holds its thread until done, so the thread count bounds the sources polled at once
+  static QThreadPool pool;
+  static bool initialized = [] {
+    pool.setMaxThreadCount(MaxConcurrentSourceLoads);
+    pool.setExpiryTimeout(-1); // the threads keep their HTTP transport, and thus its connections
+    return true;
+  }();
+  Q_UNUSED(initialized);
+  return &pool;
+}
 
-  // Kubernetes
-  if (sinfo.mon_type == MonitorT::Kubernetes) {
-    K8sHelper k8s(sinfo.mon_url, sinfo.verify_ssl_peer);
-    return std::make_pair(ngrt4n::RcGenericFailure, "TODO import k8s data points");
-  }
 
-  return std::make_pair(ngrt4n::RcGenericFailure, QObject::tr("Cannot load data points for unknown data source: %1").arg(sinfo.mon_type));
+QString ngrt4n::sourceKey(const SourceT& sinfo)
+{
+  if (sinfo.mon_type == MonitorT::Nagios) {
+    return QString("%1|%2:%3").arg(sinfo.id, sinfo.ls_addr, QString::number(sinfo.ls_port));
+  }
+  return QString("%1|%2").arg(sinfo.id, sinfo.mon_url);
 }
 
 
@@ -585,3 +568,88 @@ QString ngrt4n::decodeXml(const QString& data)
       .replace("&lt;", "<")
       .replace("&gt;", ">");
 }
+
+
+void ngrt4n::compileMessageTemplate(MessageTemplateT& tpl, const QString& msg)
+{
+  static const QVector<QPair<int, QString>> TAGS = {
+    {MessageTemplateT::Hostname, TAG_HOSTNAME},
+    {MessageTemplateT::CheckName, TAG_CHECK},
+    {MessageTemplateT::Threshold, TAG_THERESHOLD},
+    {MessageTemplateT::ZabbixHostname, TAG_ZABBIX_HOSTNAME},
+    {MessageTemplateT::ZabbixHostname, TAG_ZABBIX_HOSTNAME2}
+  };
+
+  tpl.source = msg;
+  tpl.segments.clear();
+  tpl.compiled = true;
+
+  int literalStart = 0;
+  int pos = msg.indexOf('{');
+  while (pos != -1) {
+    int tagLength = 0;
+    for (const auto& tag: TAGS) {
+      if (msg.midRef(pos, tag.second.size()) == tag.second) {
+        if (pos > literalStart) {
+          tpl.segments.push_back({MessageTemplateT::Literal, msg.mid(literalStart, pos - literalStart)});
+        }
+        tpl.segments.push_back({tag.first, tag.second});
+        tagLength = tag.second.size();
+        break;
+      }
+    }
+    if (tagLength > 0) {
+      literalStart = pos + tagLength;
+      pos = msg.indexOf('{', literalStart);
+    } else {
+      pos = msg.indexOf('{', pos + 1);
+    }
+  }
+
+  if (literalStart < msg.size()) {
+    tpl.segments.push_back({MessageTemplateT::Literal, msg.mid(literalStart)});
+  }
+}
+
+
+const MessageTemplateT& ngrt4n::upToDateMessageTemplate(MessageTemplateT& tpl, const QString& msg)
+{
+  if (! tpl.compiled || tpl.source != msg) {
+    compileMessageTemplate(tpl, msg);
+  }
+  return tpl;
+}
+
+
+/* tags without value (null string) are rendered as is */
+QString ngrt4n::renderMessageTemplate(const MessageTemplateT& tpl, const QString tagValues[MessageTemplateT::TagCount])
+{
+  QString result;
+  result.reserve(tpl.source.size());
+  for (const auto& segment: tpl.segments) {
+    if (segment.tag == MessageTemplateT::Literal || tagValues[segment.tag].isNull()) {
+      result.append(segment.text);
+    } else {
+      result.append(tagValues[segment.tag]);
+    }
+  }
+  return result;
+}
+
+
+bool ngrt4n::hasSameMessageInputs(const CheckT& check1, const CheckT& check2)
+{
+  return check1.status == check2.status
+      && check1.host == check2.host
+      && check1.id == check2.id
+      && check1.check_command == check2.check_command
+      && check1.alarm_msg == check2.alarm_msg;
+}
+
+
+bool ngrt4n::isSameCheck(const CheckT& check1, const CheckT& check2)
+{
+  return hasSameMessageInputs(check1, check2)
+      && check1.last_state_change == check2.last_state_change
+      && check1.host_groups == check2.host_groups;
+}
@@ -27,6 +27,8 @@
 
 #include "Base.hpp"
 #include <QString>
+#include <QNetworkReply>
+#include <QThreadPool>
 #include <unistd.h>
 
 namespace {
@@ -38,6 +40,12 @@ namespace ngrt4n
   const int DefaultPort = 1983;
   const int DefaultUpdateInterval = 300;
   const int MaxMsg = 512;
+  const int MinParallelAggregationLevelSize = 256;
+  const int MaxConcurrentSourceLoads = 16;
+  const int DefaultBackendTimeout = 15000; // in milliseconds, per request to a monitoring backend
+  const int SourceFailureThreshold = 3; // consecutive failures before a source is skipped
+  const qint64 SourceRetryDelay = 30 * 1000; // in milliseconds
+  const qint64 SourceMaxRetryDelay = 10 * 60 * 1000; // in milliseconds
 
   const QString ROOT_ID = "root";
   const QString PLUS = "plus";
@@ -170,6 +178,15 @@ namespace ngrt4n
   std::pair<int, QString> loadDynamicViewByGroup(const SourceT& sinfo, const QString& filter, CoreDataT& cdata);
 
   std::pair<int, QString> loadDataItems(const SourceT& sinfo, const QString& filter, ChecksT& checks);
+  std::pair<int, QString> loadDataItems(const SourceT& sinfo, const QStringList& filters, ChecksT& checks);
+
+  int backendTimeout(void);
+
+  void setRequestTimeout(QNetworkReply* reply);
+
+  QThreadPool* collectorPool(void);
+
+  QString sourceKey(const SourceT& sinfo);
 
   std::pair<int, QString> saveViewDataToPath(const CoreDataT& cdata, const QString& path);
 
@@ -183,6 +200,15 @@ namespace ngrt4n
 
   QString decodeXml(const QString& data);
 
+  void compileMessageTemplate(MessageTemplateT& tpl, const QString& msg);
+
+  const MessageTemplateT& upToDateMessageTemplate(MessageTemplateT& tpl, const QString& msg);
+
+  QString renderMessageTemplate(const MessageTemplateT& tpl, const QString tagValues[MessageTemplateT::TagCount]);
+
+  bool hasSameMessageInputs(const CheckT& check1, const CheckT& check2);
+  bool isSameCheck(const CheckT& check1, const CheckT& check2);
+
 } //NAMESPACE
 
 #endif // UTILS_CLIENT_HPP
@@ -27,12 +27,14 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include <Wt/Dbo/Dbo>
 #include <string>
 #include <set>
 #include <Wt/WDateTime>
 #include <QString>
 #include <QMap>
+#include <QStringList>
 #include "WebUtils.hpp"
 
 namespace dbo = Wt::Dbo;
@@ -44,6 +46,7 @@ struct QosDataT;
 class DboQosData;
 class DboNotification;
 class DboSource;
+class DboLastQosData;
 struct NotificationT;
 
 namespace Wt {
@@ -68,6 +71,14 @@ namespace Wt {
       static IdType invalidId() { return std::string(); }
       static const char* surrogateIdField() { return nullptr; }
     };
+
+    template<>
+    struct dbo_traits<DboLastQosData> : public dbo_default_traits {
+      typedef std::string IdType;
+      static IdType invalidId() { return std::string(); }
+      static const char* surrogateIdField() { return nullptr; }
+      static const char* versionField() { return nullptr; }
+    };
   }
 }
 
@@ -290,6 +301,57 @@ public:
   }
 };
 
+/** holds the most recent QoS entry of each view, maintained by reportd along with the QoS history */
+class DboLastQosData {
+public:
+  std::string view_name;
+  long timestamp;
+  int status;
+  float normal;
+  float minor;
+  float major;
+  float critical;
+  float unknown;
+
+  void setData(const QosDataT& data)
+  {
+    view_name = data.view_name;
+    timestamp = data.timestamp;
+    status = data.status;
+    normal = data.normal;
+    minor = data.minor;
+    major = data.major;
+    critical = data.critical;
+    unknown = data.unknown;
+  }
+
+  QosDataT data(void) const
+  {
+    QosDataT d;
+    d.view_name = view_name;
+    d.timestamp = timestamp;
+    d.status = status;
+    d.normal = normal;
+    d.minor = minor;
+    d.major = major;
+    d.critical = critical;
+    d.unknown = unknown;
+    return d;
+  }
+
+  template<class Action>
+  void persist(Action& a) {
+    dbo::id(a, view_name, "view_name");
+    dbo::field(a, timestamp, "timestamp");
+    dbo::field(a, status, "status");
+    dbo::field(a, normal, "normal");
+    dbo::field(a, minor, "minor");
+    dbo::field(a, major, "major");
+    dbo::field(a, critical, "critical");
+    dbo::field(a, unknown, "unknown");
+  }
+};
+
 class DboLoginSession
 {
 public:
@@ -326,6 +388,12 @@ struct NotificationT {
   NotificationT(): view_status(-1) { }
 };
 
+struct NotificationTargetT {
+  QStringList recipients;
+  int last_status; // status of the last notification sent for the view, -1 if none
+  NotificationTargetT(): last_status(-1) { }
+};
+
 /** holds notification info like a wt::dbo object */
 class DboNotification
 {
@@ -395,17 +463,35 @@ public:
   }
 };
 
+struct ViewLeaseT {
+  std::string view_name;
+  std::string view_path;
+  long last_sample; // timestamp of the last QoS sample of the view, 0 if none
+};
+
+struct ViewStatusRecordT {
+  std::string view_name;
+  long timestamp;
+  std::vector<unsigned char> record; // status snapshot record of the view
+};
+
 
 typedef std::set<std::string> UserViewsT;
 typedef std::list<DboUser> DbUsersT;
+typedef std::vector<DboUserT> DboUserListT;
 typedef std::list<DboView> DbViewsT;
 typedef std::list<DboLoginSession> LoginSessionListT;
-typedef std::list<QosDataT> QosDataList;
+typedef std::list<ViewLeaseT> ViewLeaseListT;
+typedef std::list<ViewStatusRecordT> ViewStatusRecordListT;
+typedef std::vector<QosDataT> QosDataList;
 typedef QMap<std::string, QosDataList > QosDataListMapT;
+typedef QMap<std::string, QosDataT> QosDataMapT;
 typedef QMap<std::string, NotificationT> NotificationMapT;
+typedef QMap<std::string, NotificationTargetT> NotificationTargetMapT;
 typedef dbo::collection< dbo::ptr<DboUser> > DboUserCollectionT;
 typedef dbo::collection< dbo::ptr<DboView> > DboViewCollectionT;
 typedef dbo::collection< dbo::ptr<DboQosData> > DboQosDataCollectionT;
+typedef dbo::collection< dbo::ptr<DboLastQosData> > DboLastQosDataCollectionT;
 typedef dbo::collection< dbo::ptr<DboNotification> > DboNotificationCollectionT;
 typedef dbo::collection< dbo::ptr<DboLoginSession> > DboLoginSessionCollectionT;
 typedef dbo::collection< dbo::ptr<DboSource> > DboSourceCollectionT;
@@ -30,6 +30,8 @@
 #include <Wt/Auth/Identity>
 #include <Wt/Auth/PasswordStrengthValidator>
 #include <Wt/Dbo/Exception>
+#include <QElapsedTimer>
+#include <memory>
 #include <regex>
 
 namespace Wt {
@@ -45,35 +47,414 @@ namespace Wt {
   }
 }
 
-DbSession::DbSession(int dbType, const std::string& db)
-  : m_isConnected(false)
-{
-  m_dboUserDb = new UserDatabase(*this);
-  m_passAuthService = new Wt::Auth::PasswordService(m_basicAuthService);
+namespace {
+  // The authentication services hold no per-session state, set them up once for the whole process
+  struct SharedAuthServicesT {
+    Wt::Auth::AuthService basicAuth;
+    Wt::Auth::PasswordService passwordAuth;
+
+    SharedAuthServicesT(void) : passwordAuth(basicAuth) {
+      basicAuth.setAuthTokensEnabled(true, "realopinsightcookie");
+      basicAuth.setEmailVerificationEnabled(true);
+      Wt::Auth::PasswordVerifier* verifier = new Wt::Auth::PasswordVerifier();
+      verifier->addHashFunction(new Wt::Auth::BCryptHashFunction(7));
+      passwordAuth.setVerifier(verifier);
+      passwordAuth.setStrengthValidator(new Wt::Auth::PasswordStrengthValidator());
+      passwordAuth.setAttemptThrottlingEnabled(true);
+    }
+  };
 
-  try {
+  SharedAuthServicesT& sharedAuthServices(void)
+  {
+    static SharedAuthServicesT services;
+    return services;
+  }
+
+  dbo::SqlConnection* createDbConnection(int dbType, const std::string& db)
+  {
+    dbo::SqlConnection* connection = nullptr;
     switch (dbType) {
       case PostgresqlDb:
-        m_dboSqlConncetion = new Wt::Dbo::backend::Postgres(db);
-        m_dboSqlConncetion->setProperty("show-queries", "false");
-        setConnection(*m_dboSqlConncetion);
+        connection = new Wt::Dbo::backend::Postgres(db);
         break;
-
         // Sqlite3 is the default database
       case Sqlite3Db:
       default:
-        m_dboSqlConncetion = new Wt::Dbo::backend::Sqlite3(db);
-        m_dboSqlConncetion->setProperty("show-queries", "false");
-        setConnection(*m_dboSqlConncetion);
+        connection = new Wt::Dbo::backend::Sqlite3(db);
         break;
     }
+    connection->setProperty("show-queries", "false");
+    return connection;
+  }
+}
+
+
+DbConnectionPool* DbConnectionPool::s_sharedPool = nullptr;
+
+DbConnectionPool::DbConnectionPool(int dbType, dbo::SqlConnection* connection, int size, int waitTimeout)
+  : dbo::FixedSqlConnectionPool(connection, size),
+    m_dbType(dbType)
+{
+  setTimeout(waitTimeout);
+  m_stats.size = size;
+}
+
+dbo::SqlConnection* DbConnectionPool::getConnection()
+{
+  // a caller only waits when all the connections are taken at the time it asks for one
+  bool mustWait = false;
+  {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    mustWait = m_stats.inUse >= m_stats.size;
+  }
+
+  QElapsedTimer waitTimer;
+  waitTimer.start();
+
+  dbo::SqlConnection* connection = nullptr;
+  try {
+    connection = dbo::FixedSqlConnectionPool::getConnection();
+  } catch (const dbo::Exception& ex) {
+    {
+      std::lock_guard<std::mutex> lock(m_statsMutex);
+      ++m_stats.timeoutCount;
+    }
+    CORE_LOG("error", QObject::tr("no database connection available after %1 ms: %2").arg(waitTimer.elapsed()).arg(ex.what()).toStdString());
+    throw;
+  }
+
+  qint64 waitMs = waitTimer.elapsed();
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  ++m_stats.acquireCount;
+  if (mustWait) {
+    ++m_stats.waitCount;
+    m_stats.totalWaitMs += waitMs;
+    m_stats.maxWaitMs = qMax(m_stats.maxWaitMs, waitMs);
+  }
+  ++m_stats.inUse;
+  m_stats.peakInUse = qMax(m_stats.peakInUse, m_stats.inUse);
+
+  return connection;
+}
+
+void DbConnectionPool::returnConnection(dbo::SqlConnection* connection)
+{
+  dbo::FixedSqlConnectionPool::returnConnection(connection);
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  --m_stats.inUse;
+}
 
-    // do this before doing anything to avoid unauthorized access
-    configureAuth();
-    setupDbMapping();
+DbConnectionPoolStatsT DbConnectionPool::stats(void) const
+{
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  return m_stats;
+}
 
-    m_isConnected = true;
+std::pair<int, QString> DbConnectionPool::initShared(int dbType, const std::string& db, int size, int waitTimeout)
+{
+  if (s_sharedPool) {
+    return std::make_pair(ngrt4n::RcSuccess, QString());
+  }
 
+  try {
+    s_sharedPool = new DbConnectionPool(dbType, createDbConnection(dbType, db), size, waitTimeout);
+  } catch (const std::exception& ex) {
+    auto errorMsg = QObject::tr("failed to set up the database connection pool: %1").arg(ex.what());
+    CORE_LOG("fatal", errorMsg.toStdString());
+    return std::make_pair(ngrt4n::RcDbError, errorMsg);
+  }
+
+  CORE_LOG("info", QObject::tr("database connection pool ready (size: %1, wait timeout: %2s)").arg(size).arg(waitTimeout).toStdString());
+  return std::make_pair(ngrt4n::RcSuccess, QString());
+}
+
+void DbConnectionPool::releaseShared(void)
+{
+  if (s_sharedPool) {
+    CORE_LOG("info", QObject::tr("database connection pool stats: %1").arg(s_sharedPool->stats().toString()).toStdString());
+    delete s_sharedPool;
+    s_sharedPool = nullptr;
+  }
+}
+
+QString DbConnectionPoolStatsT::toString(void) const
+{
+  return QObject::tr("size=%1 inUse=%2 peakInUse=%3 acquires=%4 waits=%5 timeouts=%6 avgWaitMs=%7 maxWaitMs=%8")
+      .arg(size)
+      .arg(inUse)
+      .arg(peakInUse)
+      .arg(acquireCount)
+      .arg(waitCount)
+      .arg(timeoutCount)
+      .arg(waitCount > 0 ? totalWaitMs / waitCount : 0)
+      .arg(maxWaitMs);
+}
+
+
+ViewAclCache::ViewAclCache(void)
+  : m_loaded(false),
+    m_loadTime(0),
+    m_generation(0)
+{
+}
+
+ViewAclCache& ViewAclCache::shared(void)
+{
+  static ViewAclCache cache;
+  return cache;
+}
+
+bool ViewAclCache::isValid(void) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_loaded && QDateTime::currentMSecsSinceEpoch() - m_loadTime < MaxAge * 1000;
+}
+
+long ViewAclCache::generation(void) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_generation;
+}
+
+void ViewAclCache::load(long generation, const DbViewsT& views, const AssignmentMapT& assignments)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // the content read from the database is outdated if anything changed in the meantime
+  if (generation != m_generation) {
+    return;
+  }
+  m_views.clear();
+  for (const auto& view : views) {
+    m_views[view.name] = ViewInfoT{view.path, view.service_count};
+  }
+  m_assignments = assignments;
+  m_loaded = true;
+  m_loadTime = QDateTime::currentMSecsSinceEpoch();
+}
+
+void ViewAclCache::invalidate(void)
+{
+  // the content is kept for the readers racing with the change, the next lookup reloads it
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_generation;
+  m_loaded = false;
+}
+
+void ViewAclCache::assignView(const std::string& username, const std::string& vname)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_generation;
+  if (m_views.find(vname) != m_views.end()) {
+    m_assignments[username].insert(vname);
+  }
+}
+
+void ViewAclCache::revokeView(const std::string& username, const std::string& vname)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_generation;
+  auto userEntry = m_assignments.find(username);
+  if (userEntry != m_assignments.end()) {
+    userEntry->second.erase(vname);
+  }
+}
+
+void ViewAclCache::removeView(const std::string& vname)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_generation;
+  m_views.erase(vname);
+  for (auto& userEntry : m_assignments) {
+    userEntry.second.erase(vname);
+  }
+}
+
+DbViewsT ViewAclCache::views(void) const
+{
+  DbViewsT vlist;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& entry : m_views) {
+    vlist.push_back(toDboView(entry.first, entry.second));
+  }
+  return vlist;
+}
+
+DbViewsT ViewAclCache::userViews(const std::string& username) const
+{
+  DbViewsT vlist;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto userEntry = m_assignments.find(username);
+  if (userEntry != m_assignments.end()) {
+    for (const auto& vname : userEntry->second) {
+      auto view = m_views.find(vname);
+      if (view != m_views.end()) {
+        vlist.push_back(toDboView(view->first, view->second));
+      }
+    }
+  }
+  return vlist;
+}
+
+UserViewsT ViewAclCache::userViewList(void) const
+{
+  UserViewsT userViewList;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& userEntry : m_assignments) {
+    for (const auto& vname : userEntry.second) {
+      userViewList.insert(userEntry.first+":"+vname);
+    }
+  }
+  return userViewList;
+}
+
+bool ViewAclCache::findView(const std::string& vname, DboView& view) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto entry = m_views.find(vname);
+  if (entry == m_views.end()) {
+    return false;
+  }
+  view = toDboView(entry->first, entry->second);
+  return true;
+}
+
+DboView ViewAclCache::toDboView(const std::string& vname, const ViewInfoT& info)
+{
+  DboView view;
+  view.name = vname;
+  view.path = info.path;
+  view.service_count = info.serviceCount;
+  return view;
+}
+
+
+LoginSessionCache::LoginSessionCache(void)
+  : m_stopping(false)
+{
+}
+
+LoginSessionCache::~LoginSessionCache()
+{
+  stop();
+}
+
+LoginSessionCache& LoginSessionCache::shared(void)
+{
+  static LoginSessionCache cache;
+  return cache;
+}
+
+bool LoginSessionCache::find(const std::string& username, const std::string& sessionId, int& status)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto entry = m_entries.find(KeyT(username, sessionId));
+  if (entry == m_entries.end()) {
+    return false;
+  }
+  if (entry->second.expiry <= QDateTime::currentMSecsSinceEpoch()) {
+    m_entries.erase(entry);
+    return false;
+  }
+  status = entry->second.session.status;
+  return true;
+}
+
+void LoginSessionCache::insert(const DboLoginSession& session, bool persist)
+{
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  KeyT key(session.username, session.sessionId);
+  if (m_entries.find(key) == m_entries.end() && m_entries.size() >= Capacity) {
+    evictEntries(now);
+  }
+  m_entries[key] = EntryT{session, now + EntryTtl * 1000};
+
+  if (persist && ! m_stopping) {
+    m_pendingWrites.push_back(session);
+    if (! m_writer.joinable()) {
+      m_writer = std::thread(&LoginSessionCache::runWriter, this);
+    } else if (m_pendingWrites.size() >= FlushBatchSize) {
+      m_writerCondition.notify_one();
+    }
+  }
+}
+
+void LoginSessionCache::stop(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_writerCondition.notify_one();
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+}
+
+void LoginSessionCache::evictEntries(qint64 now)
+{
+  for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+    entry = (entry->second.expiry <= now) ? m_entries.erase(entry) : std::next(entry);
+  }
+  if (m_entries.size() < Capacity) {
+    return;
+  }
+  // still full of live sessions, make room by dropping the one closest to expiry
+  auto oldest = m_entries.begin();
+  for (auto entry = m_entries.begin(); entry != m_entries.end(); ++entry) {
+    if (entry->second.expiry < oldest->second.expiry) {
+      oldest = entry;
+    }
+  }
+  m_entries.erase(oldest);
+}
+
+void LoginSessionCache::runWriter(void)
+{
+  // the writer has its own database session, created within its thread
+  std::unique_ptr<DbSession> dbSession;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (! m_stopping || ! m_pendingWrites.empty()) {
+    m_writerCondition.wait_for(lock, std::chrono::milliseconds(FlushInterval), [this]() {
+      return m_stopping || m_pendingWrites.size() >= FlushBatchSize;
+    });
+    if (m_pendingWrites.empty()) {
+      continue;
+    }
+
+    LoginSessionListT batch;
+    batch.swap(m_pendingWrites);
+    lock.unlock();
+    if (! dbSession) {
+      if (DbConnectionPool::shared()) {
+        dbSession.reset(new DbSession(*DbConnectionPool::shared()));
+      } else {
+        WebBaseSettings settings;
+        dbSession.reset(new DbSession(settings.getDbType(), settings.getDbConnectionString()));
+      }
+    }
+    auto saveOut = dbSession->saveSessions(batch);
+    if (saveOut.first != ngrt4n::RcSuccess) {
+      CORE_LOG("error", QObject::tr("%1 login session(s) not saved: %2").arg(batch.size()).arg(saveOut.second).toStdString());
+    }
+    lock.lock();
+  }
+}
+
+
+DbSession::DbSession(int dbType, const std::string& db)
+  : m_isConnected(false),
+    m_dbType(dbType),
+    m_dboSqlConncetion(nullptr),
+    m_qosStore(nullptr)
+{
+  m_dboUserDb = new UserDatabase(*this);
+  m_passAuthService = &sharedAuthServices().passwordAuth;
+
+  try {
+    m_dboSqlConncetion = createDbConnection(dbType, db);
+    setConnection(*m_dboSqlConncetion);
+    initialize();
   } catch (const std::exception& ex) {
     auto errorMsg = QObject::tr("Connection to database failed: %1").arg(ex.what()).toStdString();
     CORE_LOG("fatal", errorMsg);
@@ -81,11 +462,45 @@ DbSession::DbSession(int dbType, const std::string& db)
   }
 }
 
+DbSession::DbSession(DbConnectionPool& connectionPool)
+  : m_isConnected(false),
+    m_dbType(connectionPool.dbType()),
+    m_dboSqlConncetion(nullptr),
+    m_qosStore(nullptr)
+{
+  m_dboUserDb = new UserDatabase(*this);
+  m_passAuthService = &sharedAuthServices().passwordAuth;
+
+  try {
+    setConnectionPool(connectionPool);
+    initialize();
+  } catch (const std::exception& ex) {
+    auto errorMsg = QObject::tr("Connection to database failed: %1").arg(ex.what()).toStdString();
+    CORE_LOG("fatal", errorMsg);
+  }
+}
+
 DbSession::~DbSession()
 {
   delete m_dboUserDb;
   delete m_dboSqlConncetion;
-  delete m_passAuthService;
+  delete m_qosStore;
+}
+
+void DbSession::initialize(void)
+{
+  // do this before doing anything to avoid unauthorized access
+  sharedAuthServices();
+  setupDbMapping();
+
+  // the QoS history goes to the segment store when one is configured, the rest stays in the database;
+  // the setting is read once for all the sessions
+  static const QString qosStoreDir = WebBaseSettings().getQosStoreDir();
+  if (! qosStoreDir.isEmpty()) {
+    m_qosStore = new QosSegmentStore(qosStoreDir);
+  }
+
+  m_isConnected = true;
 }
 
 void DbSession::setupDbMapping(void)
@@ -95,6 +510,7 @@ void DbSession::setupDbMapping(void)
   mapClass<AuthInfo>("auth_info");
   mapClass<DboLoginSession>("login_session");
   mapClass<DboQosData>("qosdata");
+  mapClass<DboLastQosData>("qosdata_last");
   mapClass<DboNotification>("notification");
   mapClass<AuthInfo::AuthIdentityType>("auth_identity");
   mapClass<AuthInfo::AuthTokenType>("auth_token");
@@ -115,14 +531,7 @@ DbSession::addUser(const DboUserT& userInfo)
       CORE_LOG("error", out.second.toStdString());
       out.first = ngrt4n::RcDbDuplicationError;
     } else {
-      Wt::Auth::User dbuser = m_dboUserDb->registerNew();
-      dbo::ptr<AuthInfo> info = m_dboUserDb->find(dbuser);
-      info.modify()->setEmail(userInfo.email);
-      m_passAuthService->updatePassword(dbuser, userInfo.password);
-      DboUser* userTmpPtr(new DboUser());
-      userTmpPtr->setData(userInfo);
-      info.modify()->setUser( add(userTmpPtr) );
-      dbuser.addIdentity(Wt::Auth::Identity::LoginName, userInfo.username);
+      registerUser(userInfo);
       out.first = ngrt4n::RcSuccess;
     }
   } catch (const dbo::Exception& ex) {
@@ -134,6 +543,56 @@ DbSession::addUser(const DboUserT& userInfo)
   return out;
 }
 
+
+std::pair<int, QString>
+DbSession::addUsers(const DboUserListT& userInfos, std::set<std::string>& addedUsers)
+{
+  std::pair<int, QString> out {ngrt4n::RcDbError, ""};
+
+  // all the users are added within a single transaction, the existing ones are skipped
+  dbo::Transaction transaction(*this);
+  try {
+    std::set<std::string> existingNames;
+    DboUserCollectionT users = find<DboUser>();
+    for (const auto& user : users) {
+      existingNames.insert(user->username);
+    }
+
+    addedUsers.clear();
+    for (const auto& userInfo : userInfos) {
+      if (existingNames.insert(userInfo.username).second) {
+        registerUser(userInfo);
+        addedUsers.insert(userInfo.username);
+      }
+    }
+    out.first = ngrt4n::RcSuccess;
+    out.second = QObject::tr("%1 user(s) added").arg(addedUsers.size());
+  } catch (const dbo::Exception& ex) {
+    addedUsers.clear();
+    transaction.rollback();
+    out.second = "Failed to add the users.";
+    CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+    return out;
+  }
+  transaction.commit();
+
+  return out;
+}
+
+
+void
+DbSession::registerUser(const DboUserT& userInfo)
+{
+  Wt::Auth::User dbuser = m_dboUserDb->registerNew();
+  dbo::ptr<AuthInfo> info = m_dboUserDb->find(dbuser);
+  info.modify()->setEmail(userInfo.email);
+  m_passAuthService->updatePassword(dbuser, userInfo.password);
+  DboUser* userTmpPtr(new DboUser());
+  userTmpPtr->setData(userInfo);
+  info.modify()->setUser( add(userTmpPtr) );
+  dbuser.addIdentity(Wt::Auth::Identity::LoginName, userInfo.username);
+}
+
 std::pair<int, QString>
 DbSession::updateUser(const DboUserT& userInfo)
 {
@@ -208,6 +667,7 @@ int DbSession::deleteUser(const std::string& username)
     CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
   }
   transaction.commit();
+  ViewAclCache::shared().invalidate();
   return rc;
 }
 
@@ -225,6 +685,7 @@ int DbSession::deleteAuthSystemUsers(int authSystem)
     CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
   }
   transaction.commit();
+  ViewAclCache::shared().invalidate();
   return retValue;
 }
 
@@ -250,7 +711,7 @@ std::string DbSession::hashPassword(const std::string& pass)
 
 Wt::Auth::AuthService& DbSession::auth()
 {
-  return m_basicAuthService;
+  return sharedAuthServices().basicAuth;
 }
 
 Wt::Auth::PasswordService* DbSession::passwordAuthentificator(void)
@@ -264,17 +725,6 @@ Wt::Auth::Login& DbSession::loginObject(void)
   return m_loginObj;
 }
 
-void DbSession::configureAuth(void)
-{
-  m_basicAuthService.setAuthTokensEnabled(true, "realopinsightcookie");
-  m_basicAuthService.setEmailVerificationEnabled(true);
-  Wt::Auth::PasswordVerifier* verifier = new Wt::Auth::PasswordVerifier();
-  verifier->addHashFunction(new Wt::Auth::BCryptHashFunction(7));
-  m_passAuthService->setVerifier(verifier);
-  m_passAuthService->setStrengthValidator(new Wt::Auth::PasswordStrengthValidator());
-  m_passAuthService->setAttemptThrottlingEnabled(true);
-}
-
 void DbSession::setLoggedUser(void)
 {
   dbo::Transaction transaction(*this);
@@ -307,9 +757,17 @@ DbUsersT DbSession::listUsers(void)
   return ulist;
 }
 
-DbViewsT DbSession::listViews(void)
+bool DbSession::loadViewAclCache(void)
 {
+  ViewAclCache& cache = ViewAclCache::shared();
+  if (cache.isValid()) {
+    return true;
+  }
+
+  long generation = cache.generation();
   DbViewsT vlist;
+  ViewAclCache::AssignmentMapT assignments;
+  bool loaded = false;
   dbo::Transaction transaction(*this);
   try {
     DboViewCollectionT views = find<DboView>();
@@ -318,46 +776,46 @@ DbViewsT DbSession::listViews(void)
         vlist.push_back(*view);
       }
     }
+    typedef boost::tuple<std::string, std::string> UserViewRowT;
+    dbo::collection<UserViewRowT> rows = query<UserViewRowT>("SELECT user_name, view_name FROM user_view");
+    for (const auto& row : rows) {
+      assignments[row.get<0>()].insert(row.get<1>());
+    }
+    loaded = true;
   } catch (const dbo::Exception& ex) {
-    vlist.clear();
     CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
   }
   transaction.commit();
 
-  return vlist;
+  if (loaded) {
+    cache.load(generation, vlist, assignments);
+  }
+  return loaded;
 }
 
-DbViewsT DbSession::listViewListByAssignedUser(const std::string& uname)
+DbViewsT DbSession::listViews(void)
 {
-  DbViewsT vlist;
-  dbo::Transaction transaction(*this);
-  try {
-    dbo::ptr<DboUser> userDboPtr = find<DboUser>().where("name=?").bind(uname);
-    for (auto& view : userDboPtr.modify()->views) {
-      if (view.get()) {
-        vlist.push_back(*view);
-      }
-    }
-  } catch (const dbo::Exception& ex) {
-    vlist.clear();
-    CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  if (! loadViewAclCache()) {
+    return DbViewsT();
   }
-  transaction.commit();
+  return ViewAclCache::shared().views();
+}
 
-  return vlist;
+DbViewsT DbSession::listViewListByAssignedUser(const std::string& uname)
+{
+  if (! loadViewAclCache()) {
+    return DbViewsT();
+  }
+  return ViewAclCache::shared().userViews(uname);
 }
 
 
 bool DbSession::findView(const std::string& vname, DboView& view)
 {
-  auto vlist = listViews();
-  DbViewsT::const_iterator it = std::find_if(vlist.cbegin(), vlist.cend(), [&vname](const DboView& v){return v.name == vname;});
-  bool found = false;
-  if (it != vlist.end()) {
-    found = true;
-    view = *it;
+  if (! loadViewAclCache()) {
+    return false;
   }
-  return found;
+  return ViewAclCache::shared().findView(vname, view);
 }
 
 
@@ -416,6 +874,7 @@ DbSession::addView(const DboView& vInfo)
     CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
   }
   transaction.commit();
+  ViewAclCache::shared().invalidate();
 
   return out;
 }
@@ -438,6 +897,7 @@ DbSession::updateViewWithPath(const DboView& vinfo, const std::string& vpath)
     CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
   }
   transaction.commit();
+  ViewAclCache::shared().invalidate();
 
   return out;
 }
@@ -461,6 +921,10 @@ DbSession::deleteViewWithName(const std::string& vname)
   }
   transaction.commit();
 
+  if (out.first == ngrt4n::RcSuccess) {
+    ViewAclCache::shared().removeView(vname);
+  }
+
   return out;
 }
 
@@ -468,17 +932,10 @@ DbSession::deleteViewWithName(const std::string& vname)
 
 UserViewsT DbSession::updateUserViewList(void)
 {
-  UserViewsT userViewList;
-  dbo::Transaction transaction(*this);
-  DboUserCollectionT users = find<DboUser>();
-  for (auto& user : users) {
-    for (const auto& view: user->views) {
-      userViewList.insert(user->username+":"+view->name);
-    }
+  if (! loadViewAclCache()) {
+    return UserViewsT();
   }
-  transaction.commit();
-
-  return userViewList;
+  return ViewAclCache::shared().userViewList();
 }
 
 
@@ -502,6 +959,10 @@ DbSession::assignView(const std::string& userId, const std::string& vname)
   }
   transaction.commit();
 
+  if (out.first == ngrt4n::RcSuccess) {
+    ViewAclCache::shared().assignView(userId, vname);
+  }
+
   return out;
 }
 
@@ -525,6 +986,10 @@ DbSession::revokeView(const std::string& userId, const std::string& viewId)
   }
   transaction.commit();
 
+  if (out.first == ngrt4n::RcSuccess) {
+    ViewAclCache::shared().revokeView(userId, viewId);
+  }
+
   return out;
 }
 
@@ -557,30 +1022,27 @@ int DbSession::listAssignedUsersEmails(QStringList& emails, const std::string& v
 
 int DbSession::addSession(const DboLoginSession& session)
 {
-  int rc = ngrt4n::RcDbError;
-
-  dbo::Transaction transaction(*this);
-  try {
-    if (checkUserCookie(session) != DboLoginSession::ActiveCookie) {
-      DboLoginSession* sessionPtr(new DboLoginSession());
-      *sessionPtr = session;
-      add(sessionPtr);
-      rc = ngrt4n::RcSuccess;
-    } else {
-      CORE_LOG("debug", "Already active session");
-      rc = ngrt4n::RcGenericFailure;
-    }
-  } catch (const dbo::Exception& ex) {
-    CORE_LOG("error", QObject::tr("Failed adding session at %1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  // a session only known by the cache is still pending, in any case the cache has the last word
+  int status = DboLoginSession::InvalidSession;
+  if (LoginSessionCache::shared().find(session.username, session.sessionId, status)
+      && status == DboLoginSession::ActiveCookie) {
+    CORE_LOG("debug", "Already active session");
+    return ngrt4n::RcGenericFailure;
   }
-  transaction.commit();
 
-  return rc;
+  // the database is updated in the background, the writer merges the sessions already stored
+  LoginSessionCache::shared().insert(session, true);
+  return ngrt4n::RcSuccess;
 }
 
 
 int DbSession::checkUserCookie(const DboLoginSession& session)
 {
+  int status = DboLoginSession::InvalidSession;
+  if (LoginSessionCache::shared().find(session.username, session.sessionId, status)) {
+    return (status == DboLoginSession::ActiveCookie) ? DboLoginSession::ActiveCookie : DboLoginSession::InvalidSession;
+  }
+
   int rc = DboLoginSession::InvalidSession;
   dbo::Transaction transaction(*this);
   try {
@@ -588,8 +1050,12 @@ int DbSession::checkUserCookie(const DboLoginSession& session)
                                           .where("username=? AND session_id=? AND status = ?")
                                           .bind(session.username)
                                           .bind(session.sessionId)
-                                          .bind(DboLoginSession::ExpiredCookie);
-    rc = sessions.size()? DboLoginSession::ActiveCookie : DboLoginSession::InvalidSession;
+                                          .bind(DboLoginSession::ActiveCookie);
+    if (sessions.size() > 0) {
+      rc = DboLoginSession::ActiveCookie;
+      dbo::ptr<DboLoginSession> sessionPtr = *sessions.begin();
+      LoginSessionCache::shared().insert(*sessionPtr, false);
+    }
   } catch (const dbo::Exception& ex) {
     CORE_LOG("error", QObject::tr("failed checking session at %1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
   }
@@ -598,10 +1064,54 @@ int DbSession::checkUserCookie(const DboLoginSession& session)
 }
 
 
+std::pair<int, QString> DbSession::saveSessions(const LoginSessionListT& sessions)
+{
+  std::pair<int, QString> out {ngrt4n::RcDbError, ""};
+
+  // the sessions are saved within a single transaction, the existing ones are updated
+  dbo::Transaction transaction(*this);
+  try {
+    for (const auto& session : sessions) {
+      DboLoginSessionCollectionT existingSessions = find<DboLoginSession>()
+                                                    .where("username=? AND session_id=?")
+                                                    .bind(session.username)
+                                                    .bind(session.sessionId);
+      if (existingSessions.size() > 0) {
+        for (auto& existing : existingSessions) {
+          existing.modify()->lastAccess = session.lastAccess;
+          existing.modify()->status = session.status;
+        }
+      } else {
+        DboLoginSession* sessionPtr(new DboLoginSession());
+        *sessionPtr = session;
+        add(sessionPtr);
+      }
+    }
+    out.first = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    transaction.rollback();
+    out.second = ex.what();
+    CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+    return out;
+  }
+  transaction.commit();
+
+  return out;
+}
+
+
 int DbSession::addQosData(const QosDataT& qosData)
 {
   REPORTD_LOG("info", QObject::tr("Adding QoS entry: %1").arg(qosData.toString().c_str()));
 
+  if (m_qosStore) {
+    int retValue = m_qosStore->append(qosData);
+    if (retValue == ngrt4n::RcSuccess) {
+      retValue = setLastQosData(qosData);
+    }
+    return retValue;
+  }
+
   int retValue = ngrt4n::RcGenericFailure;
   dbo::Transaction transaction(*this);
   try {
@@ -610,6 +1120,7 @@ int DbSession::addQosData(const QosDataT& qosData)
     qosDataDbo->view = find<DboView>().where("name=?").bind(qosData.view_name);
     if (qosDataDbo->view.get() != nullptr) {
       dbo::ptr<DboQosData> dboEntry = add(qosDataDbo);
+      updateLastQosData(qosData);
       retValue = ngrt4n::RcSuccess;
     } else {
       retValue = ngrt4n::RcDbError;
@@ -628,6 +1139,17 @@ DbSession::addQosDataList(const QosDataList& qosDataList)
 {
   std::pair<int, QString> out {ngrt4n::RcDbError, ""};
 
+  if (m_qosStore) {
+    out.first = ngrt4n::RcSuccess;
+    for (const auto& qosData : qosDataList) {
+      if (addQosData(qosData) != ngrt4n::RcSuccess) {
+        out.first = ngrt4n::RcDbError;
+        out.second = "Failed to add QoS entries to the segment store.";
+      }
+    }
+    return out;
+  }
+
   dbo::Transaction transaction(*this);
   try {
     for (const auto& qosData : qosDataList) {
@@ -635,6 +1157,7 @@ DbSession::addQosDataList(const QosDataList& qosDataList)
       ptr_qosDboData->setData(qosData);
       ptr_qosDboData->view = find<DboView>().where("name=?").bind(qosData.view_name);;
       dbo::ptr<DboQosData> dboEntry = add(ptr_qosDboData);
+      updateLastQosData(qosData);
       out.second.append(QString("QoS entry added: %1").arg(dboEntry->toString().c_str()));
     }
     out.first = 0;
@@ -650,26 +1173,41 @@ DbSession::addQosDataList(const QosDataList& qosDataList)
 
 int DbSession::listQosData(QosDataListMapT& qosDataMap, const std::string& viewId, long fromDate, long toDate)
 {
+  typedef boost::tuple<std::string, long, int, float, float, float, float, float> QosDataRowT;
+
+  if (m_qosStore) {
+    return m_qosStore->list(qosDataMap, viewId, fromDate, toDate);
+  }
+
   int count = 0;
   dbo::Transaction transaction(*this);
   try {
-    DboQosDataCollectionT dbEntries;
-    if (viewId.empty()) {
-      dbEntries = find<DboQosData>()
-                  .where("timestamp >= ? AND timestamp <= ?")
-                  .orderBy("timestamp")
-                  .bind(fromDate).bind(toDate);
-    } else {
-      dbEntries = find<DboQosData>()
-                  .where("view_name = ? AND timestamp >= ? AND timestamp <= ?")
-                  .orderBy("timestamp")
-                  .bind(viewId).bind(fromDate).bind(toDate);
+    // read the view name from the foreign key column instead of loading the view of each row,
+    // rows come grouped by view so that each view's list is looked up only once
+    dbo::Query<QosDataRowT> rowsQuery = query<QosDataRowT>("SELECT view_name, timestamp, status, normal, minor, major, critical, unknown FROM qosdata");
+    rowsQuery.where("timestamp >= ? AND timestamp <= ?").bind(fromDate).bind(toDate);
+    if (! viewId.empty()) {
+      rowsQuery.where("view_name = ?").bind(viewId);
     }
+    dbo::collection<QosDataRowT> rows = rowsQuery.orderBy("view_name, timestamp");
 
     qosDataMap.clear();
-    for (auto& entry : dbEntries) {
-      auto viewDashboardAliasName = entry->data().view_name;
-      qosDataMap[viewDashboardAliasName].push_back(entry->data());
+    QosDataList* viewEntries = nullptr;
+    for (const auto& row : rows) {
+      const std::string& viewName = boost::get<0>(row);
+      if (! viewEntries || viewEntries->back().view_name != viewName) {
+        viewEntries = &qosDataMap[viewName];
+      }
+      QosDataT entry;
+      entry.view_name = viewName;
+      entry.timestamp = boost::get<1>(row);
+      entry.status    = boost::get<2>(row);
+      entry.normal    = boost::get<3>(row);
+      entry.minor     = boost::get<4>(row);
+      entry.major     = boost::get<5>(row);
+      entry.critical  = boost::get<6>(row);
+      entry.unknown   = boost::get<7>(row);
+      viewEntries->push_back(entry);
       ++count;
     }
   } catch (const dbo::Exception& ex) {
@@ -686,29 +1224,396 @@ int DbSession::getLastQosData(QosDataT& qosData, const std::string& viewId)
   int count = -1;
   dbo::Transaction transaction(*this);
   try {
-    DboQosDataCollectionT queryResults;
-    if (viewId.empty()) {
-      queryResults = find<DboQosData>()
-                     .orderBy("timestamp DESC")
-                     .limit(1);
+    if (viewId.empty() && m_qosStore) {
+      DboLastQosDataCollectionT queryResults = find<DboLastQosData>()
+                                               .orderBy("timestamp DESC")
+                                               .limit(1);
+      if (queryResults.size() == 1) {
+        count = 0;
+        qosData = queryResults.begin()->get()->data();
+      }
+    } else if (viewId.empty()) {
+      DboQosDataCollectionT queryResults = find<DboQosData>()
+                                           .orderBy("timestamp DESC")
+                                           .limit(1);
+      if (queryResults.size() == 1) {
+        count = 0;
+        qosData =  queryResults.begin()->modify()->data();
+      }
     } else {
-      queryResults = find<DboQosData>()
-                     .orderBy("timestamp DESC")
-                     .limit(1);
+      dbo::ptr<DboLastQosData> lastEntry = find<DboLastQosData>().where("view_name = ?").bind(viewId);
+      if (lastEntry) {
+        count = 0;
+        qosData = lastEntry->data();
+      }
     }
+  } catch (const dbo::Exception& ex) {
+    CORE_LOG("error", QObject::tr("Failed to fetch last QoS entry at %1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return count;
+}
+
 
-    if (queryResults.size() == 1) {
-      count = 0;
-      qosData =  queryResults.begin()->modify()->data();
+int DbSession::listLastQosData(QosDataMapT& qosDataMap, const std::set<std::string>& viewIds)
+{
+  int count = 0;
+  dbo::Transaction transaction(*this);
+  try {
+    dbo::Query< dbo::ptr<DboLastQosData> > query = find<DboLastQosData>();
+    if (! viewIds.empty()) {
+      QStringList placeholders;
+      for (std::size_t i = 0; i < viewIds.size(); ++i) {
+        placeholders.push_back("?");
+      }
+      query.where(QString("view_name IN (%1)").arg(placeholders.join(",")).toStdString());
+      for (const auto& viewId: viewIds) {
+        query.bind(viewId);
+      }
+    }
+
+    DboLastQosDataCollectionT dbEntries = query.resultList();
+    qosDataMap.clear();
+    for (const auto& entry : dbEntries) {
+      qosDataMap.insert(entry->view_name, entry->data());
+      ++count;
     }
   } catch (const dbo::Exception& ex) {
-    CORE_LOG("error", QObject::tr("Failed to fetch last QoS entry at %1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+    count = -1;
+    CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return count;
+}
+
+
+/** lists for each of the given views (all if empty) its last entry recorded strictly before the given date */
+int DbSession::listPrecedingQosData(QosDataMapT& qosDataMap, const std::set<std::string>& viewIds, long beforeDate)
+{
+  typedef boost::tuple<std::string, long, int, float, float, float, float, float> QosDataRowT;
+
+  if (m_qosStore) {
+    qosDataMap.clear();
+    for (const auto& viewId : m_qosStore->listViews()) {
+      if (! viewIds.empty() && viewIds.find(viewId) == viewIds.end()) {
+        continue;
+      }
+      QosDataT entry;
+      if (m_qosStore->findPreceding(entry, viewId, beforeDate)) {
+        qosDataMap.insert(viewId, entry);
+      }
+    }
+    return qosDataMap.size();
+  }
+
+  QString viewFilter;
+  if (! viewIds.empty()) {
+    QStringList placeholders;
+    for (std::size_t i = 0; i < viewIds.size(); ++i) {
+      placeholders.push_back("?");
+    }
+    viewFilter = QString(" AND view_name IN (%1)").arg(placeholders.join(","));
+  }
+
+  int count = 0;
+  dbo::Transaction transaction(*this);
+  try {
+    // one pass over the rows before the date gives the last timestamp of each view, the rows are then joined back
+    dbo::Query<QosDataRowT> precedingQuery = query<QosDataRowT>(QString("SELECT q.view_name, q.timestamp, q.status, q.normal, q.minor, q.major, q.critical, q.unknown"
+                                                                        " FROM qosdata q"
+                                                                        " JOIN (SELECT view_name, MAX(timestamp) AS last_timestamp FROM qosdata"
+                                                                        "       WHERE timestamp < ?%1 GROUP BY view_name) p"
+                                                                        " ON q.view_name = p.view_name AND q.timestamp = p.last_timestamp").arg(viewFilter).toStdString());
+    precedingQuery.bind(beforeDate);
+    for (const auto& viewId: viewIds) {
+      precedingQuery.bind(viewId);
+    }
+    dbo::collection<QosDataRowT> rows = precedingQuery.resultList();
+    qosDataMap.clear();
+    for (const auto& row : rows) {
+      QosDataT entry;
+      entry.view_name = boost::get<0>(row);
+      entry.timestamp = boost::get<1>(row);
+      entry.status    = boost::get<2>(row);
+      entry.normal    = boost::get<3>(row);
+      entry.minor     = boost::get<4>(row);
+      entry.major     = boost::get<5>(row);
+      entry.critical  = boost::get<6>(row);
+      entry.unknown   = boost::get<7>(row);
+      qosDataMap.insert(entry.view_name, entry);
+      ++count;
+    }
+  } catch (const dbo::Exception& ex) {
+    count = -1;
+    CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return count;
+}
+
+
+int DbSession::setLastQosData(const QosDataT& qosData)
+{
+  int rc = ngrt4n::RcDbError;
+  dbo::Transaction transaction(*this);
+  try {
+    updateLastQosData(qosData);
+    rc = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return rc;
+}
+
+
+/** must be called within a transaction */
+void DbSession::updateLastQosData(const QosDataT& qosData)
+{
+  dbo::ptr<DboLastQosData> lastEntry = find<DboLastQosData>().where("view_name = ?").bind(qosData.view_name);
+  if (! lastEntry) {
+    DboLastQosData* lastEntryPtr = new DboLastQosData();
+    lastEntryPtr->setData(qosData);
+    add(lastEntryPtr);
+  } else if (lastEntry->timestamp <= qosData.timestamp) {
+    lastEntry.modify()->setData(qosData);
+  }
+}
+
+
+/** creates the latest QoS table on databases initialized before it was introduced */
+int DbSession::setupLastQosDataTable(void)
+{
+  int rc = ngrt4n::RcDbError;
+  dbo::Transaction transaction(*this);
+  try {
+    execute("CREATE TABLE IF NOT EXISTS qosdata_last ("
+            " view_name text NOT NULL PRIMARY KEY,"
+            " timestamp bigint NOT NULL,"
+            " status integer NOT NULL,"
+            " normal real NOT NULL,"
+            " minor real NOT NULL,"
+            " major real NOT NULL,"
+            " critical real NOT NULL,"
+            " unknown real NOT NULL"
+            ");");
+    rc = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return rc;
+}
+
+
+/**
+ * Creates the table holding the last status of each view, published by the collectors so that
+ * the web sessions get it whatever the host they run on
+ */
+int DbSession::setupViewStatusTable(void)
+{
+  int rc = ngrt4n::RcDbError;
+  dbo::Transaction transaction(*this);
+  try {
+    execute(QString("CREATE TABLE IF NOT EXISTS view_status ("
+                    " view_name text NOT NULL PRIMARY KEY,"
+                    " timestamp bigint NOT NULL,"
+                    " record %1 NOT NULL"
+                    ");").arg(m_dbType == PostgresqlDb ? "bytea" : "blob").toStdString());
+    rc = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return rc;
+}
+
+
+/** a record never replaces a more recent one, e.g. published by the collector that took the view over */
+std::pair<int, QString> DbSession::saveViewStatuses(const ViewStatusRecordListT& records)
+{
+  std::pair<int, QString> out {ngrt4n::RcDbError, ""};
+  dbo::Transaction transaction(*this);
+  try {
+    for (const auto& record : records) {
+      execute("INSERT INTO view_status (view_name, timestamp, record) VALUES (?, ?, ?)"
+              " ON CONFLICT (view_name) DO UPDATE SET timestamp = excluded.timestamp, record = excluded.record"
+              " WHERE excluded.timestamp >= view_status.timestamp;")
+          .bind(record.view_name).bind(record.timestamp).bind(record.record);
+    }
+    out.first = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    out.second = QObject::tr("failed to publish the view statuses: %1").arg(ex.what());
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return out;
+}
+
+
+int DbSession::listViewStatuses(ViewStatusRecordListT& records, const std::set<std::string>& viewNames)
+{
+  typedef boost::tuple<std::string, long, std::vector<unsigned char> > ViewStatusRowT;
+
+  int count = 0;
+  records.clear();
+  dbo::Transaction transaction(*this);
+  try {
+    dbo::Query<ViewStatusRowT> statusQuery = query<ViewStatusRowT>("SELECT view_name, timestamp, record FROM view_status");
+    if (! viewNames.empty()) {
+      QStringList placeholders;
+      for (std::size_t i = 0; i < viewNames.size(); ++i) {
+        placeholders.push_back("?");
+      }
+      statusQuery.where(QString("view_name IN (%1)").arg(placeholders.join(",")).toStdString());
+      for (const auto& viewName: viewNames) {
+        statusQuery.bind(viewName);
+      }
+    }
+
+    dbo::collection<ViewStatusRowT> rows = statusQuery.resultList();
+    for (const auto& row : rows) {
+      ViewStatusRecordT record;
+      boost::tie(record.view_name, record.timestamp, record.record) = row;
+      records.push_back(record);
+      ++count;
+    }
+  } catch (const dbo::Exception& ex) {
+    count = -1;
+    records.clear();
+    CORE_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
   }
   transaction.commit();
   return count;
 }
 
 
+int DbSession::setupCollectorLeaseTables(void)
+{
+  int rc = ngrt4n::RcDbError;
+  dbo::Transaction transaction(*this);
+  try {
+    execute("CREATE TABLE IF NOT EXISTS collector_node ("
+            " collector_id text NOT NULL PRIMARY KEY,"
+            " last_seen bigint NOT NULL"
+            ");");
+    execute("CREATE TABLE IF NOT EXISTS collector_lease ("
+            " view_name text NOT NULL PRIMARY KEY,"
+            " owner text NOT NULL,"
+            " expires_at bigint NOT NULL"
+            ");");
+    rc = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return rc;
+}
+
+
+/**
+ * Returns the current time of the database server, in seconds since epoch. The collectors
+ * compare lease times against it rather than against their own clocks, which may be skewed.
+ */
+long DbSession::databaseTime(void)
+{
+  if (m_dbType == PostgresqlDb) {
+    return query<long>("SELECT CAST(EXTRACT(EPOCH FROM CURRENT_TIMESTAMP) AS bigint)");
+  }
+  return query<long>("SELECT CAST(strftime('%s', 'now') AS integer)");
+}
+
+
+/**
+ * Renews the leases held by the collector and rebalances them: each live collector targets
+ * an equal share of the views, gives back what exceeds it so that joining collectors get
+ * views, and takes over expired leases (e.g. of collectors that died) up to it. A lease is
+ * taken with a conditional update, so only one collector can win it. The rows are created
+ * with conflict-tolerant inserts, as collectors starting together may insert the same ones.
+ */
+std::pair<int, QString>
+DbSession::acquireViewLeases(const std::string& collectorId, long leaseTtl, long releaseGrace, ViewLeaseListT& leases)
+{
+  typedef boost::tuple<std::string, std::string, long> ViewLeaseRowT;
+
+  std::pair<int, QString> out {ngrt4n::RcDbError, ""};
+  leases.clear();
+  dbo::Transaction transaction(*this);
+  try {
+    long now = databaseTime();
+    execute("INSERT INTO collector_node (collector_id, last_seen) VALUES (?, ?)"
+            " ON CONFLICT (collector_id) DO UPDATE SET last_seen = excluded.last_seen;")
+        .bind(collectorId).bind(now);
+    execute("DELETE FROM collector_node WHERE last_seen < ?;").bind(now - leaseTtl);
+
+    execute("INSERT INTO collector_lease (view_name, owner, expires_at)"
+            " SELECT name, '', 0 FROM view WHERE name NOT IN (SELECT view_name FROM collector_lease)"
+            " ON CONFLICT (view_name) DO NOTHING;");
+    execute("DELETE FROM collector_lease WHERE view_name NOT IN (SELECT name FROM view);");
+
+    int collectorCount = query<int>("SELECT COUNT(1) FROM collector_node");
+    int viewCount = query<int>("SELECT COUNT(1) FROM collector_lease");
+    size_t fairShare = static_cast<size_t>((viewCount + collectorCount - 1) / std::max(collectorCount, 1));
+
+    execute("UPDATE collector_lease SET expires_at = ? WHERE owner = ?;").bind(now + leaseTtl).bind(collectorId);
+    dbo::collection<std::string> ownedResults = query<std::string>("SELECT view_name FROM collector_lease")
+                                                .where("owner = ?").bind(collectorId)
+                                                .orderBy("view_name");
+    std::vector<std::string> ownedViews(ownedResults.begin(), ownedResults.end());
+    for (size_t index = fairShare; index < ownedViews.size(); ++index) {
+      // the grace delay lets a collection in progress complete before another collector takes over
+      execute("UPDATE collector_lease SET owner = '', expires_at = ? WHERE view_name = ? AND owner = ?;")
+          .bind(now + releaseGrace).bind(ownedViews[index]).bind(collectorId);
+    }
+
+    if (ownedViews.size() < fairShare) {
+      dbo::collection<std::string> freeResults = query<std::string>("SELECT view_name FROM collector_lease")
+                                                 .where("expires_at < ?").bind(now)
+                                                 .limit(static_cast<int>(fairShare - ownedViews.size()));
+      std::vector<std::string> freeViews(freeResults.begin(), freeResults.end());
+      for (const auto& viewName : freeViews) {
+        execute("UPDATE collector_lease SET owner = ?, expires_at = ? WHERE view_name = ? AND expires_at < ?;")
+            .bind(collectorId).bind(now + leaseTtl).bind(viewName).bind(now);
+      }
+    }
+
+    dbo::collection<ViewLeaseRowT> rows = query<ViewLeaseRowT>("SELECT l.view_name, v.path, COALESCE(q.timestamp, 0)"
+                                                               " FROM collector_lease l"
+                                                               " JOIN view v ON v.name = l.view_name"
+                                                               " LEFT JOIN qosdata_last q ON q.view_name = l.view_name")
+                                          .where("l.owner = ?").bind(collectorId);
+    for (const auto& row : rows) {
+      ViewLeaseT lease;
+      boost::tie(lease.view_name, lease.view_path, lease.last_sample) = row;
+      leases.push_back(lease);
+    }
+    out.first = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    leases.clear();
+    out.second = QObject::tr("failed to acquire the view leases: %1").arg(ex.what());
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return out;
+}
+
+
+int DbSession::releaseViewLeases(const std::string& collectorId)
+{
+  int rc = ngrt4n::RcDbError;
+  dbo::Transaction transaction(*this);
+  try {
+    execute("UPDATE collector_lease SET owner = '', expires_at = 0 WHERE owner = ?;").bind(collectorId);
+    execute("DELETE FROM collector_node WHERE collector_id = ?;").bind(collectorId);
+    rc = ngrt4n::RcSuccess;
+  } catch (const dbo::Exception& ex) {
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return rc;
+}
+
+
 int DbSession::addNotification(const std::string& viewId, int viewStatus)
 {
   int retValue = ngrt4n::RcDbError;
@@ -827,6 +1732,59 @@ void DbSession::getLastNotificationInfo(NotificationT& lastNotifInfo, const std:
 }
 
 
+/**
+ * Fetches in a single query, for each of the given views having users with an email, the
+ * recipients of the notifications and the status of the last notification sent.
+ */
+int DbSession::listNotificationTargets(NotificationTargetMapT& targets, const std::set<std::string>& viewIds)
+{
+  typedef boost::tuple<std::string, std::string, int> NotificationTargetRowT;
+
+  targets.clear();
+  if (viewIds.empty()) {
+    return 0;
+  }
+
+  int retValue = -1;
+  dbo::Transaction transaction(*this);
+  try {
+    QStringList placeholders;
+    for (size_t index = 0; index < viewIds.size(); ++index) {
+      placeholders.push_back("?");
+    }
+    std::string sql = QString("SELECT uv.view_name, u.email, COALESCE(n.view_status, -1)"
+                              " FROM user_view uv"
+                              " JOIN \"user\" u ON u.name = uv.user_name"
+                              " LEFT JOIN notification n ON n.view_name = uv.view_name"
+                              "   AND n.timestamp = (SELECT MAX(m.timestamp) FROM notification m WHERE m.view_name = uv.view_name)"
+                              " WHERE u.email != ''"
+                              "   AND uv.view_name IN (%1)"
+                              ).arg(placeholders.join(", ")).toStdString();
+
+    dbo::Query<NotificationTargetRowT> targetQuery = query<NotificationTargetRowT>(sql);
+    for (const auto& viewId : viewIds) {
+      targetQuery.bind(viewId);
+    }
+
+    dbo::collection<NotificationTargetRowT> rows = targetQuery;
+    for (const auto& row : rows) {
+      NotificationTargetT& target = targets[row.get<0>()];
+      QString email = QString::fromStdString(row.get<1>());
+      if (! target.recipients.contains(email)) {
+        target.recipients.push_back(email);
+      }
+      target.last_status = row.get<2>();
+    }
+    retValue = targets.size();
+  } catch (const dbo::Exception& ex) {
+    targets.clear();
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(Q_FUNC_INFO, ex.what()).toStdString());
+  }
+  transaction.commit();
+  return retValue;
+}
+
+
 std::pair<int, QString>
 DbSession::listViewRelatedNotifications(NotificationMapT& notifications, const std::string& userId)
 {
@@ -26,11 +26,13 @@
 #define DBSESSION_HPP
 
 #include "DbObjects.hpp"
+#include "QosSegmentStore.hpp"
 #include <Wt/Auth/AuthService>
 #include <Wt/Auth/PasswordVerifier>
 #include <Wt/Dbo/Dbo>
 #include <Wt/Dbo/backend/Sqlite3>
 #include <Wt/Dbo/backend/Postgres>
+#include <Wt/Dbo/FixedSqlConnectionPool>
 #include <Wt/Auth/PasswordService>
 #include <Wt/Auth/User>
 #include <Wt/WGlobal>
@@ -38,6 +40,10 @@
 #include <Wt/Auth/Dbo/UserDatabase>
 #include <Wt/Auth/Login>
 #include <climits>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <semaphore.h>
 
 typedef Wt::Auth::Dbo::AuthInfo<DboUser> AuthInfo;
@@ -53,10 +59,136 @@ enum {
   DbInitialized = 1
 };
 
+struct DbConnectionPoolStatsT {
+  int size;
+  int inUse;
+  int peakInUse;
+  long acquireCount;
+  long waitCount;
+  long timeoutCount;
+  qint64 totalWaitMs;
+  qint64 maxWaitMs;
+
+  DbConnectionPoolStatsT(void) : size(0), inUse(0), peakInUse(0), acquireCount(0), waitCount(0), timeoutCount(0), totalWaitMs(0), maxWaitMs(0) {}
+  QString toString(void) const;
+};
+
+
+/**
+ * Process-wide pool of database connections shared by all the DbSession instances
+ * created with it, so that the number of connections no longer follows the number of
+ * browser sessions. Tracks the time spent waiting for a free connection.
+ */
+class DbConnectionPool : public dbo::FixedSqlConnectionPool
+{
+public:
+  DbConnectionPool(int dbType, dbo::SqlConnection* connection, int size, int waitTimeout);
+
+  virtual dbo::SqlConnection* getConnection();
+  virtual void returnConnection(dbo::SqlConnection* connection);
+  DbConnectionPoolStatsT stats(void) const;
+  int dbType(void) const {return m_dbType;}
+
+  static std::pair<int, QString> initShared(int dbType, const std::string& db, int size, int waitTimeout);
+  static DbConnectionPool* shared(void) {return s_sharedPool;}
+  static void releaseShared(void);
+
+private:
+  static DbConnectionPool* s_sharedPool;
+  int m_dbType;
+  mutable std::mutex m_statsMutex;
+  DbConnectionPoolStatsT m_stats;
+};
+
+
+/**
+ * Process-wide cache of the views and of their assignments to users, shared by all the
+ * DbSession instances. It is loaded at once on first use and kept in sync by the DbSession
+ * methods changing views or assignments, so that the login path and the admin screens no
+ * longer scan the user and view tables for each ACL lookup. The content is reloaded after
+ * MaxAge seconds to catch up with changes made by other processes.
+ */
+class ViewAclCache
+{
+public:
+  typedef std::map<std::string, std::set<std::string> > AssignmentMapT;
+  static const qint64 MaxAge = 60; // in seconds
+
+  static ViewAclCache& shared(void);
+  bool isValid(void) const;
+  long generation(void) const;
+  void load(long generation, const DbViewsT& views, const AssignmentMapT& assignments);
+  void invalidate(void);
+  void assignView(const std::string& username, const std::string& vname);
+  void revokeView(const std::string& username, const std::string& vname);
+  void removeView(const std::string& vname);
+  DbViewsT views(void) const;
+  DbViewsT userViews(const std::string& username) const;
+  UserViewsT userViewList(void) const;
+  bool findView(const std::string& vname, DboView& view) const;
+
+private:
+  struct ViewInfoT {
+    std::string path;
+    int serviceCount;
+  };
+
+  mutable std::mutex m_mutex;
+  bool m_loaded;
+  qint64 m_loadTime;
+  long m_generation;
+  std::map<std::string, ViewInfoT> m_views;
+  AssignmentMapT m_assignments;
+
+  ViewAclCache(void);
+  static DboView toDboView(const std::string& vname, const ViewInfoT& info);
+};
+
+
+/**
+ * Process-wide cache of the login sessions. Cookie checks are answered from memory once a
+ * session is known, and new sessions are written to the database in batches by a background
+ * writer rather than in one transaction per login. The cache is bounded and its entries
+ * expire along with the session cookie; stop() flushes the pending writes.
+ */
+class LoginSessionCache
+{
+public:
+  static const size_t Capacity = 4096;
+  static const qint64 EntryTtl = 3600; // in seconds, the lifetime of the session cookie
+  static const qint64 FlushInterval = 2000; // in milliseconds
+  static const size_t FlushBatchSize = 64;
+
+  static LoginSessionCache& shared(void);
+  ~LoginSessionCache();
+  bool find(const std::string& username, const std::string& sessionId, int& status);
+  void insert(const DboLoginSession& session, bool persist);
+  void stop(void);
+
+private:
+  struct EntryT {
+    DboLoginSession session;
+    qint64 expiry; // in milliseconds since epoch
+  };
+  typedef std::pair<std::string, std::string> KeyT;
+
+  std::mutex m_mutex;
+  std::condition_variable m_writerCondition;
+  std::map<KeyT, EntryT> m_entries;
+  LoginSessionListT m_pendingWrites;
+  std::thread m_writer;
+  bool m_stopping;
+
+  LoginSessionCache(void);
+  void evictEntries(qint64 now);
+  void runWriter(void);
+};
+
 class DbSession : public dbo::Session
 {
 public:
   DbSession(int dbType, const std::string& db);
+  DbSession(DbConnectionPool& connectionPool);
   ~DbSession();
 
   bool isConnected() const {return m_isConnected;}
@@ -69,7 +201,6 @@ public:
   Wt::Auth::Login& loginObject(void);
   bool isLogged(void) {return loginObject().loggedIn();}
   bool isLoggedAdmin(void) {return loggedUser().role == DboUser::AdmRole;}
-  void configureAuth(void);
   const DboUser& loggedUser(void) const {return m_loggedUser;}
   bool isCompleteUserDashboard(void) const {return loggedUser().dashboardDisplayMode == DboUser::CompleteDashboard;}
   bool displayOnlyTiles(void) const {return loggedUser().dashboardDisplayMode == DboUser::TileDashboard;}
@@ -79,6 +210,7 @@ public:
   QString loggedUserName(void)const {return QString::fromStdString(loggedUser().username);}
 
   std::pair<int, QString> addUser(const DboUserT& userInfo);
+  std::pair<int, QString> addUsers(const DboUserListT& userInfos, std::set<std::string>& addedUsers);
   std::pair<int, QString> updateUser(const DboUserT& userInfo);
   int deleteUser(const std::string& username);
   int deleteAuthSystemUsers(int authSystem);
@@ -97,6 +229,18 @@ public:
   std::pair<int, QString> addQosDataList(const QosDataList& qosDataList);
   int listQosData(QosDataListMapT& qosDataMap, const std::string& viewId, long fromDate = 0, long toDate = LONG_MAX);
   int getLastQosData(QosDataT& qosData, const std::string& viewId);
+  int listLastQosData(QosDataMapT& qosDataMap, const std::set<std::string>& viewIds);
+  int setLastQosData(const QosDataT& qosData);
+  int listPrecedingQosData(QosDataMapT& qosDataMap, const std::set<std::string>& viewIds, long beforeDate);
+  int setupLastQosDataTable(void);
+
+  int setupViewStatusTable(void);
+  std::pair<int, QString> saveViewStatuses(const ViewStatusRecordListT& records);
+  int listViewStatuses(ViewStatusRecordListT& records, const std::set<std::string>& viewNames);
+
+  int setupCollectorLeaseTables(void);
+  std::pair<int, QString> acquireViewLeases(const std::string& collectorId, long leaseTtl, long releaseGrace, ViewLeaseListT& leases);
+  int releaseViewLeases(const std::string& collectorId);
 
   DbViewsT listViews(void);
   DbViewsT listViewListByAssignedUser(const std::string& uname);
@@ -105,11 +249,13 @@ public:
 
   int addSession(const DboLoginSession& session);
   int checkUserCookie(const DboLoginSession& session);
+  std::pair<int, QString> saveSessions(const LoginSessionListT& sessions);
 
   int addNotification(const std::string& viewId, int viewStatus);
   int updateNotificationAckStatusForUser(const std::string& userId, const std::string& viewId, int newAckStatus);
   int updateNotificationAckStatusForView(const std::string& userId, const std::string& viewId, int newAckStatus);
   void getLastNotificationInfo(NotificationT& lastNotifInfo, const std::string& viewId);
+  int listNotificationTargets(NotificationTargetMapT& targets, const std::set<std::string>& viewIds);
   std::pair<int, QString> listViewRelatedNotifications(NotificationMapT& notifications, const std::string& userId);
 
   std::pair<int, QString> addSource(const SourceT& sinfo);
@@ -120,14 +266,20 @@ public:
 
 private:
   bool m_isConnected;
+  int m_dbType;
   dbo::SqlConnection* m_dboSqlConncetion;
   UserDatabase* m_dboUserDb;
   DboUser m_loggedUser;
   Wt::Auth::Login m_loginObj;
-  Wt::Auth::AuthService m_basicAuthService;
   Wt::Auth::PasswordService* m_passAuthService;
+  QosSegmentStore* m_qosStore;
 
+  void initialize(void);
+  long databaseTime(void);
   std::string hashPassword(const std::string& pass);
+  void registerUser(const DboUserT& userInfo);
+  void updateLastQosData(const QosDataT& qosData);
+  bool loadViewAclCache(void);
 };
 
 #endif // DBSESSION_HPP
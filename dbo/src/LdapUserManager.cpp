@@ -24,8 +24,10 @@
 #include "WebAuthSettings.hpp"
 #include "WebUtils.hpp"
 #include "LdapUserManager.hpp"
+#include <Wt/WApplication>
 #include <Wt/WStandardItemModel>
 #include <Wt/WStandardItem>
+#include <set>
 
 /**
  * @brief LdapUserTable::LdapUserTable
@@ -33,12 +35,14 @@
  */
 namespace {
   const int TABLE_COLUMN_COUNT = 5;
+  const int ENABLE_AUTH_COLUMN = 4;
 }
 LdapUserManager::LdapUserManager(DbSession* dbSession, Wt::WContainerWidget* parent)
   : Wt::WTableView(parent),
     m_userEnableStatusChanged(this),
     m_model(new Wt::WStandardItemModel(0, TABLE_COLUMN_COUNT, this)),
-    m_dbSession(dbSession)
+    m_dbSession(dbSession),
+    m_updatingRows(false)
 {
   setSortingEnabled(true);
   setLayoutSizeAware(true);
@@ -60,6 +64,7 @@ LdapUserManager::LdapUserManager(DbSession* dbSession, Wt::WContainerWidget* par
 void LdapUserManager::addEvent()
 {
   m_model->itemChanged().connect(this, &LdapUserManager::handleImportationAction);
+  m_model->headerDataChanged().connect(this, &LdapUserManager::handleHeaderCheckChanged);
 }
 
 /**
@@ -72,7 +77,8 @@ void LdapUserManager::setModelHeader(void)
   m_model->setHeaderData(1, Q_TR("Full Name"));
   m_model->setHeaderData(2, Q_TR("UID"));
   m_model->setHeaderData(3, Q_TR("Email"));
-  m_model->setHeaderData(4, Q_TR("Enable Auth"));
+  m_model->setHeaderData(ENABLE_AUTH_COLUMN, Q_TR("Enable Auth"));
+  m_model->setHeaderFlags(ENABLE_AUTH_COLUMN, Wt::Horizontal, Wt::HeaderIsUserCheckable);
 }
 
 /**
@@ -90,23 +96,38 @@ int LdapUserManager::updateUserList(void)
                         preferences.getLdapSslCertFile(),
                         preferences.getLdapSslCaFile());
 
-  std::string filter = "(objectClass=person)";
+  // the users already imported are looked up once for all the directory entries
+  std::set<std::string> importedUsers;
+  for (const auto& user : m_dbSession->listUsers()) {
+    importedUsers.insert(user.username);
+  }
+
   m_users.clear();
+  m_model->clear();
+  setModelHeader();
+
+  // the rows are shown as the pages come from the directory; the table stays disabled and the
+  // actions on rows are ignored until the list is complete, as the events are processed meanwhile
+  m_updatingRows = true;
+  std::string filter = "(objectClass=person)";
   int count = ldapHelper.listUsers(preferences.getLdapSearchBase(),
                                    preferences.getLdapBindUserDn(),
                                    preferences.getLdapBindUserPassword(),
                                    filter,
-                                   m_users);
-  m_model->clear();
-  setModelHeader();
+                                   LdapHelper::userAttributes(m_ldapUidField),
+                                   m_users,
+                                   [this, &importedUsers](const LdapUserMapT& page) {
+    for (const auto& userInfo : page) {
+      addUserRow(userInfo, importedUsers.count(userInfo[m_ldapUidField]) > 0);
+    }
+    if (wApp) {
+      wApp->processEvents();
+    }
+  });
+  m_updatingRows = false;
+
   if (count <= 0) {
     m_lastError = ldapHelper.lastError();
-  } else {
-    for (const auto& userInfo : m_users) {
-      DboUserT dbUserInfo;
-      bool imported = m_dbSession->findUser(userInfo[m_ldapUidField], dbUserInfo);
-      addUserRow(userInfo, imported);
-    }
   }
   setDisabled(false);
   return count;
@@ -127,7 +148,7 @@ void LdapUserManager::addUserRow(const LdapUserAttrsT& userInfo, bool imported)
 
 void LdapUserManager::handleImportationAction(Wt::WStandardItem* item)
 {
-  if (item->isCheckable()) {
+  if (! m_updatingRows && item->isCheckable()) {
     std::string ldapDn = ngrt4n::getItemData(item);
     LdapUserMapT::ConstIterator userInfo =  m_users.find(ldapDn);
     if (userInfo != m_users.end()) {
@@ -150,23 +171,90 @@ void LdapUserManager::handleImportationAction(Wt::WStandardItem* item)
 }
 
 
-int LdapUserManager::insertIntoDatabase(const LdapUserAttrsT& userInfo)
+void LdapUserManager::handleHeaderCheckChanged(Wt::Orientation orientation, int first, int last)
 {
-  int retCode = -1;
-  DboUserT dbUser;
-  dbUser.username = userInfo[m_ldapUidField];
+  if (m_updatingRows || orientation != Wt::Horizontal || first > ENABLE_AUTH_COLUMN || last < ENABLE_AUTH_COLUMN) {
+    return;
+  }
 
-  if (dbUser.username.empty()) {
-    m_userEnableStatusChanged.emit(GenericError, Q_TR("The ID attribute is empty: ")+m_ldapUidField);
-    return retCode;
+  boost::any checkState = m_model->headerData(ENABLE_AUTH_COLUMN, Wt::Horizontal, Wt::CheckStateRole);
+  bool checked = false;
+  if (checkState.type() == typeid(bool)) {
+    checked = boost::any_cast<bool>(checkState);
+  } else if (checkState.type() == typeid(Wt::CheckState)) {
+    checked = (boost::any_cast<Wt::CheckState>(checkState) == Wt::Checked);
+  }
+
+  // checking the header enables all the listed users, they are disabled one by one
+  if (checked) {
+    importAllUsers();
+  }
+}
+
+
+void LdapUserManager::importAllUsers(void)
+{
+  DboUserListT dbUsers;
+  QMap<std::string, Wt::WStandardItem*> userItems;
+  for (int row = 0; row < m_model->rowCount(); ++row) {
+    Wt::WStandardItem* item = m_model->item(row, ENABLE_AUTH_COLUMN);
+    if (! item || item->checkState() == Wt::Checked) {
+      continue;
+    }
+    LdapUserMapT::ConstIterator userInfo = m_users.find(ngrt4n::getItemData(item));
+    if (userInfo != m_users.end() && ! (*userInfo)[m_ldapUidField].empty()) {
+      dbUsers.push_back(toDboUser(*userInfo));
+      userItems.insert(dbUsers.back().username, item);
+    }
+  }
+
+  if (dbUsers.empty()) {
+    return;
+  }
+
+  std::set<std::string> addedUsers;
+  auto addUsersOut = m_dbSession->addUsers(dbUsers, addedUsers);
+  if (addUsersOut.first != ngrt4n::RcSuccess) {
+    m_userEnableStatusChanged.emit(GenericError, addUsersOut.second.toStdString());
+    return;
   }
 
+  // only the rows actually imported get checked, not the ones skipped or already in the database
+  m_updatingRows = true;
+  for (const auto& username : addedUsers) {
+    auto userItem = userItems.find(username);
+    if (userItem != userItems.end()) {
+      (*userItem)->setChecked(true);
+    }
+  }
+  m_updatingRows = false;
+  m_userEnableStatusChanged.emit(BatchEnableAuthSuccess, addUsersOut.second.toStdString());
+}
+
+
+DboUserT LdapUserManager::toDboUser(const LdapUserAttrsT& userInfo) const
+{
+  DboUserT dbUser;
+  dbUser.username = userInfo[m_ldapUidField];
   dbUser.password = userInfo["userpassword"];
   dbUser.email = userInfo["mail"];
-  dbUser.firstname = userInfo["gn"];
+  dbUser.firstname = userInfo["givenname"];
   dbUser.lastname = userInfo["sn"];
   dbUser.role = DboUser::OpRole;
   dbUser.authsystem = WebBaseSettings::LDAP;
+  return dbUser;
+}
+
+
+int LdapUserManager::insertIntoDatabase(const LdapUserAttrsT& userInfo)
+{
+  int retCode = -1;
+  DboUserT dbUser = toDboUser(userInfo);
+
+  if (dbUser.username.empty()) {
+    m_userEnableStatusChanged.emit(GenericError, Q_TR("The ID attribute is empty: ")+m_ldapUidField);
+    return retCode;
+  }
 
   auto addUserOut = m_dbSession->addUser(dbUser);
   if (addUserOut.first == ngrt4n::RcSuccess) {
@@ -41,11 +41,13 @@ public:
   enum EnableOperationT {
     EnableAuthSuccess,
     DisableAuthSuccess,
+    BatchEnableAuthSuccess,
     GenericError
   };
 
   LdapUserManager(DbSession* dbSession, Wt::WContainerWidget* parent = 0);
   int updateUserList(void);
+  bool isUpdating(void) const {return m_updatingRows;}
   std::string lastError(void) const {return m_lastError.toStdString();}
 
   Wt::Signal<int, std::string>& userEnableStatusChanged(void) {return m_userEnableStatusChanged;}
@@ -60,12 +62,16 @@ private:
   DbSession* m_dbSession;
   LdapUserMapT m_users;
   std::string m_ldapUidField;
+  bool m_updatingRows;
 
   void addEvent(void);
   void setModelHeader(void);
   void addUserRow(const LdapUserAttrsT& userInfo, bool imported);
   void handleImportationAction(Wt::WStandardItem* item);
+  void handleHeaderCheckChanged(Wt::Orientation orientation, int first, int last);
   int insertIntoDatabase(const LdapUserAttrsT& userInfo);
+  void importAllUsers(void);
+  DboUserT toDboUser(const LdapUserAttrsT& userInfo) const;
 };
 
 #endif // LDAPUSERMANAGER_HPP
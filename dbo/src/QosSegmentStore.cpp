@@ -0,0 +1,280 @@
+/*
+ * QosSegmentStore.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "QosSegmentStore.hpp"
+#include "WebUtils.hpp"
+#include <QDir>
+#include <QFile>
+#include <QUrl>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+  const char SegmentMagic[4] = {'Q', 'S', 'E', 'G'};
+  const quint16 SegmentVersion = 1;
+  const float RatioScale = 100.0f; // ratios are stored in hundredths of a percent
+
+  quint16 quantizeRatio(float ratio)
+  {
+    return static_cast<quint16>(qBound(0, qRound(ratio * RatioScale), 100 * static_cast<int>(RatioScale)));
+  }
+
+  float unquantizeRatio(quint16 value)
+  {
+    return static_cast<float>(value) / RatioScale;
+  }
+
+  long recordTimestamp(const uchar* records, qint64 index, long base)
+  {
+    return base + static_cast<long>(qFromLittleEndian<quint32>(records + index * QosSegmentStore::RecordSize));
+  }
+}
+
+
+QosSegmentStore::QosSegmentStore(const QString& rootDir)
+  : m_rootDir(rootDir)
+{
+}
+
+
+QString QosSegmentStore::viewDir(const std::string& viewId) const
+{
+  // dots are encoded as well so that a view name can never map to a relative path
+  QByteArray escapedName = QUrl::toPercentEncoding(QString::fromStdString(viewId), QByteArray(), ".");
+  return QString("%1/%2").arg(m_rootDir, QString::fromLatin1(escapedName));
+}
+
+
+std::list<std::string> QosSegmentStore::listViews(void) const
+{
+  std::list<std::string> views;
+  for (const auto& entry : QDir(m_rootDir).entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+    views.push_back(QUrl::fromPercentEncoding(entry.toLatin1()).toStdString());
+  }
+  return views;
+}
+
+
+QList<long> QosSegmentStore::listSegments(const QString& dir) const
+{
+  QList<long> segments;
+  for (const auto& entry : QDir(dir).entryList(QStringList() << "*.qseg", QDir::Files)) {
+    bool ok = false;
+    long base = entry.section('.', 0, 0).toLong(&ok);
+    if (ok) {
+      segments.push_back(base);
+    }
+  }
+  std::sort(segments.begin(), segments.end());
+  return segments;
+}
+
+
+int QosSegmentStore::append(const QosDataT& qosData)
+{
+  QString dir = viewDir(qosData.view_name);
+  if (! QDir().mkpath(dir)) {
+    REPORTD_LOG("error", QObject::tr("cannot create the QoS segment directory %1").arg(dir));
+    return ngrt4n::RcGenericFailure;
+  }
+
+  long base = qosData.timestamp - qosData.timestamp % SegmentSpan;
+  QFile segment(segmentPath(dir, base));
+  if (! segment.open(QIODevice::ReadWrite)) {
+    REPORTD_LOG("error", QObject::tr("cannot open the QoS segment %1: %2").arg(segment.fileName(), segment.errorString()));
+    return ngrt4n::RcGenericFailure;
+  }
+
+  qint64 size = segment.size();
+  if (size < HeaderSize) {
+    uchar header[HeaderSize];
+    memcpy(header, SegmentMagic, sizeof(SegmentMagic));
+    qToLittleEndian<quint16>(SegmentVersion, header + 4);
+    qToLittleEndian<quint16>(RecordSize, header + 6);
+    qToLittleEndian<qint64>(base, header + 8);
+    if (! segment.resize(0) || segment.write(reinterpret_cast<const char*>(header), HeaderSize) != HeaderSize) {
+      REPORTD_LOG("error", QObject::tr("cannot write the header of the QoS segment %1: %2").arg(segment.fileName(), segment.errorString()));
+      return ngrt4n::RcGenericFailure;
+    }
+    size = HeaderSize;
+  } else {
+    // a record left partial by an interrupted append would shift all the following ones
+    qint64 completeSize = HeaderSize + (size - HeaderSize) / RecordSize * RecordSize;
+    if (completeSize != size && ! segment.resize(completeSize)) {
+      REPORTD_LOG("error", QObject::tr("cannot truncate the partial record of the QoS segment %1: %2").arg(segment.fileName(), segment.errorString()));
+      return ngrt4n::RcGenericFailure;
+    }
+    size = completeSize;
+
+    // reads bisect the records by time, so they must stay in order
+    if (size > HeaderSize) {
+      uchar lastOffset[4];
+      if (! segment.seek(size - RecordSize) || segment.read(reinterpret_cast<char*>(lastOffset), sizeof(lastOffset)) != sizeof(lastOffset)) {
+        REPORTD_LOG("error", QObject::tr("cannot read the last record of the QoS segment %1: %2").arg(segment.fileName(), segment.errorString()));
+        return ngrt4n::RcGenericFailure;
+      }
+      long lastTimestamp = recordTimestamp(lastOffset, 0, base);
+      if (qosData.timestamp < lastTimestamp) {
+        REPORTD_LOG("error", QObject::tr("QoS entry of %1 at %2 is older than the last one recorded (%3), not stored")
+                    .arg(qosData.view_name.c_str()).arg(qosData.timestamp).arg(lastTimestamp));
+        return ngrt4n::RcGenericFailure;
+      }
+    }
+  }
+
+  uchar record[RecordSize];
+  qToLittleEndian<quint32>(static_cast<quint32>(qosData.timestamp - base), record);
+  record[4] = static_cast<uchar>(static_cast<qint8>(qBound(-128, qosData.status, 127))); // keeps Unset (-1)
+  record[5] = 0; // reserved
+  qToLittleEndian<quint16>(quantizeRatio(qosData.normal), record + 6);
+  qToLittleEndian<quint16>(quantizeRatio(qosData.minor), record + 8);
+  qToLittleEndian<quint16>(quantizeRatio(qosData.major), record + 10);
+  qToLittleEndian<quint16>(quantizeRatio(qosData.critical), record + 12);
+  qToLittleEndian<quint16>(quantizeRatio(qosData.unknown), record + 14);
+
+  if (! segment.seek(size) || segment.write(reinterpret_cast<const char*>(record), RecordSize) != RecordSize) {
+    REPORTD_LOG("error", QObject::tr("cannot write to the QoS segment %1: %2").arg(segment.fileName(), segment.errorString()));
+    return ngrt4n::RcGenericFailure;
+  }
+
+  return ngrt4n::RcSuccess;
+}
+
+
+int QosSegmentStore::readSegment(const QString& path, const std::string& viewId, long fromDate, long toDate, QosDataList& entries) const
+{
+  QFile segment(path);
+  if (! segment.open(QIODevice::ReadOnly) || segment.size() < HeaderSize) {
+    return 0;
+  }
+
+  qint64 size = segment.size();
+  uchar* data = segment.map(0, size);
+  if (! data) {
+    CORE_LOG("error", QObject::tr("cannot map the QoS segment %1: %2").arg(path, segment.errorString()).toStdString());
+    return -1;
+  }
+
+  if (memcmp(data, SegmentMagic, sizeof(SegmentMagic)) != 0
+      || qFromLittleEndian<quint16>(data + 4) != SegmentVersion
+      || qFromLittleEndian<quint16>(data + 6) != RecordSize) {
+    CORE_LOG("error", QObject::tr("invalid QoS segment: %1").arg(path).toStdString());
+    segment.unmap(data);
+    return -1;
+  }
+
+  int count = 0;
+  long base = static_cast<long>(qFromLittleEndian<qint64>(data + 8));
+  qint64 recordCount = (size - HeaderSize) / RecordSize; // skip a record being appended
+  const uchar* records = data + HeaderSize;
+
+  // records are in time order, the first one in range is found by bisection
+  qint64 low = 0;
+  qint64 high = recordCount;
+  while (low < high) {
+    qint64 middle = low + (high - low) / 2;
+    if (recordTimestamp(records, middle, base) < fromDate) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  const uchar* record = records + low * RecordSize;
+  for (qint64 index = low; index < recordCount; ++index, record += RecordSize) {
+    long timestamp = recordTimestamp(records, index, base);
+    if (timestamp > toDate) {
+      break;
+    }
+    QosDataT entry;
+    entry.view_name = viewId;
+    entry.timestamp = timestamp;
+    entry.status    = static_cast<qint8>(record[4]);
+    entry.normal    = unquantizeRatio(qFromLittleEndian<quint16>(record + 6));
+    entry.minor     = unquantizeRatio(qFromLittleEndian<quint16>(record + 8));
+    entry.major     = unquantizeRatio(qFromLittleEndian<quint16>(record + 10));
+    entry.critical  = unquantizeRatio(qFromLittleEndian<quint16>(record + 12));
+    entry.unknown   = unquantizeRatio(qFromLittleEndian<quint16>(record + 14));
+    entries.push_back(entry);
+    ++count;
+  }
+
+  segment.unmap(data);
+  return count;
+}
+
+
+int QosSegmentStore::list(QosDataListMapT& qosDataMap, const std::string& viewId, long fromDate, long toDate) const
+{
+  std::list<std::string> views;
+  if (viewId.empty()) {
+    views = listViews();
+  } else {
+    views.push_back(viewId);
+  }
+
+  qosDataMap.clear();
+  int count = 0;
+  for (const auto& view : views) {
+    QString dir = viewDir(view);
+    QosDataList entries;
+    for (long base : listSegments(dir)) {
+      if (base + SegmentSpan <= fromDate) {
+        continue;
+      }
+      if (base > toDate) {
+        break;
+      }
+      int readCount = readSegment(segmentPath(dir, base), view, fromDate, toDate, entries);
+      if (readCount < 0) {
+        return -1;
+      }
+      count += readCount;
+    }
+    if (! entries.empty()) {
+      qosDataMap.insert(view, entries);
+    }
+  }
+
+  return count;
+}
+
+
+bool QosSegmentStore::findPreceding(QosDataT& qosData, const std::string& viewId, long beforeDate) const
+{
+  QString dir = viewDir(viewId);
+  QList<long> segments = listSegments(dir);
+  for (auto base = segments.crbegin(); base != segments.crend(); ++base) {
+    if (*base >= beforeDate) {
+      continue;
+    }
+    QosDataList entries;
+    if (readSegment(segmentPath(dir, *base), viewId, *base, beforeDate - 1, entries) > 0) {
+      qosData = entries.back();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,67 @@
+/*
+ * QosSegmentStore.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef QOSSEGMENTSTORE_HPP
+#define QOSSEGMENTSTORE_HPP
+
+#include "DbObjects.hpp"
+#include <QString>
+#include <QList>
+
+/**
+ * Embedded storage for the QoS history, used instead of the qosdata table when a store
+ * directory is configured.
+ *
+ * Each view has its own directory of append-only segments, one per day. A segment starts
+ * with a fixed header holding its version and base timestamp, followed by fixed-size records:
+ * the timestamp as an offset to the base, the status as a signed byte, and the five ratios
+ * quantized to hundredths of a percent. Records are appended in time order, so reads
+ * memory-map the segments overlapping the requested range and bisect to its start; a record
+ * being appended is ignored until complete, and one left partial is cut on the next append.
+ */
+class QosSegmentStore
+{
+public:
+  static const long SegmentSpan = 86400;
+  static const int HeaderSize = 16;
+  static const int RecordSize = 16;
+
+  QosSegmentStore(const QString& rootDir);
+
+  QString rootDir(void) const {return m_rootDir;}
+  int append(const QosDataT& qosData);
+  int list(QosDataListMapT& qosDataMap, const std::string& viewId, long fromDate, long toDate) const;
+  bool findPreceding(QosDataT& qosData, const std::string& viewId, long beforeDate) const;
+  std::list<std::string> listViews(void) const;
+
+private:
+  QString m_rootDir;
+
+  QString viewDir(const std::string& viewId) const;
+  QList<long> listSegments(const QString& dir) const;
+  QString segmentPath(const QString& dir, long base) const {return QString("%1/%2.qseg").arg(dir).arg(base);}
+  int readSegment(const QString& path, const std::string& viewId, long fromDate, long toDate, QosDataList& entries) const;
+};
+
+#endif // QOSSEGMENTSTORE_HPP
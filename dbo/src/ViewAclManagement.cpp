@@ -272,11 +272,8 @@ void ViewAclManagement::removeViewItemInModel(Wt::WStandardItemModel* model, con
 
 void ViewAclManagement::addViewItemInModel(Wt::WStandardItemModel* model, const std::string& viewName)
 {
-  DbViewsT::const_iterator vit;
-  vit = std::find_if(m_dbSession->listViews().begin(),
-                     m_dbSession->listViews().end(),
-                     [=](DboView v){return v.name == viewName;});
-  if (vit !=m_dbSession->listViews().end()) {
-    addView(model, *vit);
+  DboView view;
+  if (m_dbSession->findView(viewName, view)) {
+    addView(model, view);
   }
 }
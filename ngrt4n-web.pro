@@ -22,6 +22,7 @@
 
 WT_ROOT = $$(WT_ROOT)
 QT	+= core xml network script
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
 
 CONFIG += no_keywords
 TEMPLATE = app
@@ -84,6 +85,9 @@ HEADERS += \
     core/src/ChartBase.hpp \
     core/src/JsonHelper.hpp \
     core/src/RawSocket.hpp \
+    core/src/CircuitBreaker.hpp \
+    core/src/HttpTransport.hpp \
+    core/src/StatusSnapshot.hpp \
     core/src/ThresholdHelper.hpp \
     core/src/StatusAggregator.hpp \
     core/src/OpManagerHelper.hpp \
@@ -101,6 +105,7 @@ HEADERS += \
     web/src/utils/smtpclient/MailSender.hpp \
     web/src/utils/Logger.hpp \
     dbo/src/DbSession.hpp \
+    dbo/src/QosSegmentStore.hpp \
     dbo/src/DbObjects.hpp \
     dbo/src/ViewAclManagement.hpp \
     dbo/src/UserManagement.hpp \
@@ -115,6 +120,7 @@ HEADERS += \
     web/src/AuthManager.hpp \
     web/src/Validators.hpp \
     web/src/LdapHelper.hpp\
+    web/src/LdapAuthenticator.hpp\
     web/src/AuthModelProxy.hpp \
     web/src/QosCollector.hpp \
     web/src/Applications.hpp \
@@ -124,6 +130,7 @@ HEADERS += \
     web/src/WebBiDashlet.hpp \
     web/src/WebBiRawChart.hpp \
     web/src/WebBiSlaDataAggregator.hpp \
+    web/src/WebBiFetchTracker.hpp \
     web/src/WebMsgDialog.hpp \
     web/src/WebEventConsole.hpp \
     web/src/WebNotificationSettings.hpp \
@@ -133,7 +140,8 @@ HEADERS += \
     web/src/WebAuthSettings.hpp \ \
     web/src/WebEditor.hpp \
     web/src/WebInputSelector.hpp \
-    core/src/K8sHelper.hpp
+    core/src/K8sHelper.hpp \
+    core/src/SourceCollector.hpp
 
 SOURCES +=  core/src/Base.cpp \
     core/src/Parser.cpp \
@@ -146,6 +154,9 @@ SOURCES +=  core/src/Base.cpp \
     core/src/ChartBase.cpp \
     core/src/JsonHelper.cpp \
     core/src/RawSocket.cpp \
+    core/src/CircuitBreaker.cpp \
+    core/src/HttpTransport.cpp \
+    core/src/StatusSnapshot.cpp \
     core/src/ThresholdHelper.cpp \
     core/src/StatusAggregator.cpp \
     core/src/OpManagerHelper.cpp  \
@@ -154,6 +165,7 @@ SOURCES +=  core/src/Base.cpp \
     dbo/src/LdapUserManager.cpp \
     dbo/src/NotificationTableView.cpp \
     dbo/src/DbSession.cpp \
+    dbo/src/QosSegmentStore.cpp \
     dbo/src/UserManagement.cpp \
     dbo/src/ViewAclManagement.cpp \
     web/src/utils/wtwithqt/DispatchThread.C \
@@ -173,12 +185,14 @@ SOURCES +=  core/src/Base.cpp \
     web/src/WebUtils.cpp \
     web/src/AuthManager.cpp \
     web/src/LdapHelper.cpp \
+    web/src/LdapAuthenticator.cpp \
     web/src/AuthModelProxy.cpp \
     web/src/Notificator.cpp \
     web/src/WebCsvReportResource.cpp \
     web/src/WebBiDashlet.cpp \
     web/src/WebBiDateFilter.cpp \
     web/src/WebBiSlaDataAggregator.cpp \
+    web/src/WebBiFetchTracker.cpp \
     web/src/WebBiRawChart.cpp \
     web/src/WebMsgDialog.cpp \
     web/src/WebEventConsole.cpp \
@@ -189,7 +203,8 @@ SOURCES +=  core/src/Base.cpp \
     web/src/WebDataSourceSettings.cpp \
     web/src/WebEditor.cpp \
     web/src/WebInputSelector.cpp \
-    core/src/K8sHelper.cpp
+    core/src/K8sHelper.cpp \
+    core/src/SourceCollector.cpp
 
 
 LIBS += -L"$(WT_ROOT)/lib" \
@@ -208,7 +223,9 @@ LIBS += -L"$(WT_ROOT)/lib" \
         -lldap
 
 reportd {
-  SOURCES += web/src/ngrt4n-reportd.cpp
+  HEADERS += web/src/QosScheduler.hpp
+  SOURCES += web/src/ngrt4n-reportd.cpp \
+             web/src/QosScheduler.cpp
   TARGET = realopinsight-reportd
 }
 
@@ -237,5 +254,11 @@ unittests-core {
   SOURCES += core/src/TestK8sHelper.cpp
 }
 
+unittests-units {
+  QT += testlib
+  TARGET = unittests-units
+  SOURCES += core/src/unittests.cpp
+}
+
 TARGET.files = $${TARGET}
 INSTALLS += TARGET
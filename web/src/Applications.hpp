@@ -74,8 +74,12 @@ protected:
 
     root()->setId("wrapper");
 
-    WebBaseSettings settings;
-    m_dbSession = new DbSession(settings.getDbType(), settings.getDbConnectionString());
+    if (DbConnectionPool::shared()) {
+      m_dbSession = new DbSession(*DbConnectionPool::shared());
+    } else {
+      WebBaseSettings settings;
+      m_dbSession = new DbSession(settings.getDbType(), settings.getDbConnectionString());
+    }
 
     if (m_dbSession->isConnected()) {
       root()->addWidget(new AuthManager(m_dbSession));
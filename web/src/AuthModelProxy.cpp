@@ -27,7 +27,7 @@
 #include "AuthModelProxy.hpp"
 #include "WebUtils.hpp"
 #include "Validators.hpp"
-#include "LdapHelper.hpp"
+#include "LdapAuthenticator.hpp"
 #include <QObject>
 #include <QDebug>
 
@@ -56,28 +56,11 @@ bool AuthModelProxy::login(Wt::Auth::Login& login)
     return Wt::Auth::AuthModel::login(login);
   }
 
-  // Get LDAP settings info
-  std::string ldapServerUri = preferences.getLdapServerUri();
-  std::string ldapIdField = preferences.getLdapIdField();
-  std::string ldapSearchBase = preferences.getLdapSearchBase();
-  std::string ldapBindUserDn =preferences.getLdapBindUserDn();
-  std::string ldapBindPassword =  preferences.getLdapBindUserPassword();
-  int ldapVersion = preferences.getLdapVersion();
-
-  LdapHelper ldapHelper(ldapServerUri, ldapVersion);
-  QString ldapFilter = QString("(&(%1=%2)(userPassword=%3))").arg(ldapIdField.c_str(),
-                                                                  username,
-                                                                  password);
-  LdapUserMapT ldapUsers;
-  int result = ldapHelper.listUsers(ldapSearchBase,
-                                    ldapBindUserDn,
-                                    ldapBindPassword,
-                                    ldapFilter.toStdString().c_str(),
-                                    ldapUsers);
-  if (result != 1) {
+  QString ldapError;
+  if (! LdapAuthenticator::instance().authenticate(preferences, username.toStdString(), password.toStdString(), ldapError)) {
     std::string erroMsg  = Q_TR("LDAP authentication failed");
     m_loginFailed.emit(erroMsg);
-    CORE_LOG("error", QString("%1: %2").arg(erroMsg.c_str(), username).toStdString());
+    CORE_LOG("error", QString("%1: %2 (%3)").arg(erroMsg.c_str(), username, ldapError).toStdString());
   } else {
     CORE_LOG("info", Q_TR("LDAP authentication succeeded: ")+username.toStdString());
     return Wt::Auth::AuthModel::login(login);
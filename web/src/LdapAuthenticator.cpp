@@ -0,0 +1,288 @@
+/*
+ * LdapAuthenticator.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "LdapAuthenticator.hpp"
+#include "WebUtils.hpp"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <random>
+
+namespace {
+  const int CredentialSaltSize = 16;
+  const qint64 MetricsReportInterval = 100; // in directory checks
+}
+
+
+bool LdapAuthenticator::ConfigT::operator==(const ConfigT& other) const
+{
+  return serverUri == other.serverUri
+      && version == other.version
+      && sslUseMyCert == other.sslUseMyCert
+      && sslCertFile == other.sslCertFile
+      && sslCaFile == other.sslCaFile
+      && bindUserDn == other.bindUserDn
+      && bindPassword == other.bindPassword
+      && searchBase == other.searchBase
+      && idField == other.idField;
+}
+
+
+LdapAuthenticator::LdapAuthenticator(void)
+  : m_checkCount(0),
+    m_cacheHitCount(0),
+    m_failureCount(0),
+    m_connectionCount(0),
+    m_totalCheckTime(0),
+    m_maxCheckTime(0)
+{
+  m_config.version = LDAP_VERSION3;
+  m_config.sslUseMyCert = false;
+}
+
+
+LdapAuthenticator& LdapAuthenticator::instance(void)
+{
+  static LdapAuthenticator authenticator;
+  return authenticator;
+}
+
+
+bool LdapAuthenticator::authenticate(const WebBaseSettings& settings,
+                                     const std::string& username,
+                                     const std::string& password,
+                                     QString& error)
+{
+  ConfigT config;
+  config.serverUri = settings.getLdapServerUri();
+  config.version = settings.getLdapVersion();
+  config.sslUseMyCert = settings.getLdapSslUseMyCert();
+  config.sslCertFile = settings.getLdapSslCertFile();
+  config.sslCaFile = settings.getLdapSslCaFile();
+  config.bindUserDn = settings.getLdapBindUserDn();
+  config.bindPassword = settings.getLdapBindUserPassword();
+  config.searchBase = settings.getLdapSearchBase();
+  config.idField = settings.getLdapIdField();
+  applyConfig(config);
+
+  int cacheTtl = settings.getLdapAuthCacheTtl();
+  if (cacheTtl > 0 && findCachedCredential(username, password)) {
+    ++m_cacheHitCount;
+    return true;
+  }
+
+  std::string escapedUsername = LdapHelper::escapeFilterValue(username);
+  std::string escapedPassword = LdapHelper::escapeFilterValue(password);
+  if (escapedUsername.empty() || escapedPassword.empty()) {
+    error = QObject::tr("LDAP: empty or invalid credentials");
+    return false;
+  }
+  std::string filter = QString("(&(%1=%2)(userPassword=%3))").arg(config.idField.c_str(),
+                                                                  escapedUsername.c_str(),
+                                                                  escapedPassword.c_str()).toStdString();
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // a failing connection is most likely broken along with the other idle ones (e.g. after a
+  // server restart), so the check is retried once on a new connection
+  int result = -1;
+  for (int attempt = 0; attempt < 2 && result < 0; ++attempt) {
+    ConnectionT connection = acquireConnection(config, error);
+    if (! connection) {
+      break;
+    }
+    result = checkCredentials(connection.get(), config, filter);
+    if (result < 0) {
+      error = connection->lastError();
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_idleConnections.clear();
+    } else {
+      releaseConnection(config, std::move(connection));
+    }
+  }
+
+  recordCheckTime(timer.nsecsElapsed() / 1000);
+  if (result != 1) {
+    ++m_failureCount;
+    dropCachedCredential(username);
+    if (result >= 0) {
+      error = QObject::tr("LDAP: invalid credentials");
+    }
+    return false;
+  }
+
+  if (cacheTtl > 0) {
+    cacheCredential(username, password, cacheTtl);
+  }
+  return true;
+}
+
+
+LdapAuthenticator::MetricsT LdapAuthenticator::metrics(void) const
+{
+  MetricsT result;
+  result.checkCount = m_checkCount.load();
+  result.cacheHitCount = m_cacheHitCount.load();
+  result.failureCount = m_failureCount.load();
+  result.connectionCount = m_connectionCount.load();
+  result.totalCheckTime = m_totalCheckTime.load();
+  result.maxCheckTime = m_maxCheckTime.load();
+  return result;
+}
+
+
+QString LdapAuthenticator::metricsSummary(void) const
+{
+  MetricsT values = metrics();
+  qint64 averageTime = (values.checkCount > 0) ? values.totalCheckTime / values.checkCount : 0;
+  return QObject::tr("LDAP authentication: %1 directory check(s), %2 cache hit(s), %3 failure(s), %4 connection(s) opened,"
+                     " check time avg %5 ms / max %6 ms")
+      .arg(values.checkCount)
+      .arg(values.cacheHitCount)
+      .arg(values.failureCount)
+      .arg(values.connectionCount)
+      .arg(averageTime / 1000.0, 0, 'f', 1)
+      .arg(values.maxCheckTime / 1000.0, 0, 'f', 1);
+}
+
+
+void LdapAuthenticator::applyConfig(const ConfigT& config)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (config != m_config) {
+    m_idleConnections.clear();
+    m_cache.clear();
+    m_config = config;
+  }
+}
+
+
+bool LdapAuthenticator::findCachedCredential(const std::string& username, const std::string& password)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto entry = m_cache.find(username);
+  if (entry == m_cache.end()) {
+    return false;
+  }
+  if (entry->expiry <= QDateTime::currentMSecsSinceEpoch()) {
+    m_cache.erase(entry);
+    return false;
+  }
+  return entry->hash == credentialHash(entry->salt, password);
+}
+
+
+void LdapAuthenticator::cacheCredential(const std::string& username, const std::string& password, int ttl)
+{
+  static thread_local std::mt19937 random(std::random_device{}());
+  std::uniform_int_distribution<int> byte(0, 255);
+
+  CachedCredentialT credential;
+  credential.salt.resize(CredentialSaltSize);
+  for (int index = 0; index < CredentialSaltSize; ++index) {
+    credential.salt[index] = static_cast<char>(byte(random));
+  }
+  credential.hash = credentialHash(credential.salt, password);
+
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  credential.expiry = now + static_cast<qint64>(ttl) * 1000;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto entry = m_cache.begin(); entry != m_cache.end();) {
+    entry = (entry->expiry <= now) ? m_cache.erase(entry) : std::next(entry);
+  }
+  m_cache.insert(username, credential);
+}
+
+
+void LdapAuthenticator::dropCachedCredential(const std::string& username)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cache.remove(username);
+}
+
+
+LdapAuthenticator::ConnectionT LdapAuthenticator::acquireConnection(const ConfigT& config, QString& error)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (! m_idleConnections.empty()) {
+      ConnectionT connection = std::move(m_idleConnections.back());
+      m_idleConnections.pop_back();
+      return connection;
+    }
+  }
+
+  ConnectionT connection(new LdapHelper(config.serverUri,
+                                        config.version,
+                                        config.sslUseMyCert,
+                                        config.sslCertFile,
+                                        config.sslCaFile));
+  ++m_connectionCount;
+  if (! connection->loginWithDistinguishName(config.bindUserDn, config.bindPassword)) {
+    error = connection->lastError();
+    return nullptr;
+  }
+  return connection;
+}
+
+
+void LdapAuthenticator::releaseConnection(const ConfigT& config, ConnectionT connection)
+{
+  // connections bound with outdated settings, or in excess, are closed on return
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (config == m_config && m_idleConnections.size() < static_cast<size_t>(ngrt4n::MaxIdleLdapConnections)) {
+    m_idleConnections.push_back(std::move(connection));
+  }
+}
+
+
+int LdapAuthenticator::checkCredentials(LdapHelper* connection, const ConfigT& config, const std::string& filter)
+{
+  LdapUserMapT users;
+  return connection->searchUsers(config.searchBase, filter, std::vector<std::string>{LDAP_NO_ATTRS}, users);
+}
+
+
+void LdapAuthenticator::recordCheckTime(qint64 elapsed)
+{
+  qint64 checkCount = ++m_checkCount;
+  m_totalCheckTime += elapsed;
+  qint64 maxTime = m_maxCheckTime.load();
+  while (elapsed > maxTime && ! m_maxCheckTime.compare_exchange_weak(maxTime, elapsed)) {}
+
+  if (checkCount % MetricsReportInterval == 0) {
+    CORE_LOG("info", metricsSummary().toStdString());
+  }
+}
+
+
+QByteArray LdapAuthenticator::credentialHash(const QByteArray& salt, const std::string& password)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  hash.addData(salt);
+  hash.addData(password.data(), static_cast<int>(password.size()));
+  return hash.result();
+}
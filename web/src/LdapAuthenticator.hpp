@@ -0,0 +1,108 @@
+/*
+ * LdapAuthenticator.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef LDAPAUTHENTICATOR_HPP
+#define LDAPAUTHENTICATOR_HPP
+
+#include "LdapHelper.hpp"
+#include "WebBaseSettings.hpp"
+#include <QByteArray>
+#include <QMap>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+/**
+ * Checks the LDAP credentials of the users logging in. The checks are run on a small pool of
+ * connections kept bound with the service account, so that a login does not pay for a new
+ * connection, TLS handshake and service bind each time. Successful checks are remembered as
+ * salted hashes for a short time, which spares the directory when users reconnect; failed
+ * checks are never cached. The pool and the cache are dropped when the LDAP settings change.
+ */
+class LdapAuthenticator
+{
+public:
+  struct MetricsT {
+    qint64 checkCount;
+    qint64 cacheHitCount;
+    qint64 failureCount;
+    qint64 connectionCount;
+    qint64 totalCheckTime; // in microseconds
+    qint64 maxCheckTime; // in microseconds
+  };
+
+  static LdapAuthenticator& instance(void);
+  bool authenticate(const WebBaseSettings& settings, const std::string& username, const std::string& password, QString& error);
+  MetricsT metrics(void) const;
+  QString metricsSummary(void) const;
+
+private:
+  struct ConfigT {
+    std::string serverUri;
+    int version;
+    bool sslUseMyCert;
+    std::string sslCertFile;
+    std::string sslCaFile;
+    std::string bindUserDn;
+    std::string bindPassword;
+    std::string searchBase;
+    std::string idField;
+
+    bool operator==(const ConfigT& other) const;
+    bool operator!=(const ConfigT& other) const {return ! (*this == other);}
+  };
+
+  struct CachedCredentialT {
+    QByteArray salt;
+    QByteArray hash;
+    qint64 expiry; // in milliseconds since epoch
+  };
+
+  typedef std::unique_ptr<LdapHelper> ConnectionT;
+
+  mutable std::mutex m_mutex;
+  ConfigT m_config;
+  std::vector<ConnectionT> m_idleConnections;
+  QMap<std::string, CachedCredentialT> m_cache;
+
+  std::atomic<qint64> m_checkCount;
+  std::atomic<qint64> m_cacheHitCount;
+  std::atomic<qint64> m_failureCount;
+  std::atomic<qint64> m_connectionCount;
+  std::atomic<qint64> m_totalCheckTime;
+  std::atomic<qint64> m_maxCheckTime;
+
+  LdapAuthenticator(void);
+  void applyConfig(const ConfigT& config);
+  bool findCachedCredential(const std::string& username, const std::string& password);
+  void cacheCredential(const std::string& username, const std::string& password, int ttl);
+  void dropCachedCredential(const std::string& username);
+  ConnectionT acquireConnection(const ConfigT& config, QString& error);
+  void releaseConnection(const ConfigT& config, ConnectionT connection);
+  int checkCredentials(LdapHelper* connection, const ConfigT& config, const std::string& filter);
+  void recordCheckTime(qint64 elapsed);
+  static QByteArray credentialHash(const QByteArray& salt, const std::string& password);
+};
+
+#endif // LDAPAUTHENTICATOR_HPP
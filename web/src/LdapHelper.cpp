@@ -30,6 +30,7 @@
 
 namespace {
   const int REQUEST_TIMEOUT = 60;
+  const int SEARCH_PAGE_SIZE = 500;
 }
 
 
@@ -125,58 +126,163 @@ bool LdapHelper::loginWithDistinguishName(const std::string& dn, const std::stri
 
 
 
+std::string LdapHelper::escapeFilterValue(const std::string& value)
+{
+  // RFC 4515 escaping, so that a user input cannot alter the structure of a search filter
+  struct berval in;
+  in.bv_val = const_cast<char*>(value.c_str());
+  in.bv_len = value.length();
+
+  struct berval out = {0, nullptr};
+  if (ldap_bv2escaped_filter_value(&in, &out) != 0) {
+    return std::string();
+  }
+
+  std::string result(out.bv_val, out.bv_len);
+  ber_memfree(out.bv_val);
+  return result;
+}
+
+
+std::vector<std::string> LdapHelper::userAttributes(const std::string& uidField)
+{
+  // only the attributes mapped to the user fields are retrieved
+  return std::vector<std::string>{"cn", "sn", "givenName", "mail", "userPassword", uidField};
+}
+
+
 int LdapHelper::listUsers(const std::string& searchBase,
                           const std::string& bindUser,
                           const std::string& bindPass,
                           const std::string& filter,
-                          LdapUserMapT& userMap)
+                          const std::vector<std::string>& attributes,
+                          LdapUserMapT& userMap,
+                          const LdapPageHandlerT& pageHandler)
 {
+  if (! loginWithDistinguishName(bindUser, bindPass)) {
+    return -1;
+  }
+
+  return searchUsers(searchBase, filter, attributes, userMap, pageHandler);
+}
+
+
+int LdapHelper::searchUsers(const std::string& searchBase,
+                            const std::string& filter,
+                            const std::vector<std::string>& attributes,
+                            LdapUserMapT& userMap,
+                            const LdapPageHandlerT& pageHandler)
+{
+  // the search runs with the identity of the last successful bind on the handler
   if (! m_handler) {
     m_lastError = QObject::tr("LDAP: Unitialized handler");
     return -1;
   }
 
-  LDAPMessage* searchResult;
   struct timeval timeout;
   timeout.tv_sec = REQUEST_TIMEOUT;
+  timeout.tv_usec = 0;
 
-  if (! loginWithDistinguishName(bindUser, bindPass)) {
-    return -1;
+  std::vector<char*> attrList;
+  for (const auto& attr : attributes) {
+    attrList.push_back(const_cast<char*>(attr.c_str()));
   }
+  attrList.push_back(nullptr);
 
-  // make request
-  int ret = ldap_search_ext_s(m_handler,
-                              searchBase.c_str(),
-                              LDAP_SCOPE_SUBTREE,
-                              filter.c_str(),
-                              nullptr,
-                              0,
-                              nullptr,
-                              nullptr,
-                              &timeout,
-                              0,
-                              &searchResult);
-  if (ret != LDAP_SUCCESS) {
-    m_lastError = QObject::tr("LDAP: Search failed: %1").arg(ldap_err2string(ret));
-    return -1;
-  }
+  // the entries are retrieved by pages (RFC 2696); the control is not critical so that servers
+  // not supporting it simply return all the entries at once
+  struct berval* cookie = nullptr;
+  do {
+    LDAPControl* pageControl = nullptr;
+    int ret = ldap_create_page_control(m_handler, SEARCH_PAGE_SIZE, cookie, 0, &pageControl);
+    if (cookie) {
+      ber_bvfree(cookie);
+      cookie = nullptr;
+    }
+    if (ret != LDAP_SUCCESS) {
+      m_lastError = QObject::tr("LDAP: Failed creating the paging control: %1").arg(ldap_err2string(ret));
+      return -1;
+    }
 
-  // parse result
-  for (LDAPMessage* currentEntry = ldap_first_entry(m_handler, searchResult);
-       currentEntry != nullptr;
-       currentEntry = ldap_next_entry(m_handler, currentEntry)) {
-    std::string dn = getObjectDistingisghName(currentEntry);
-    userMap[dn].insert("dn", dn);
-    parseObjectAttr(currentEntry, userMap[dn]);
-  }
+    LDAPControl* serverControls[] = {pageControl, nullptr};
+    LDAPMessage* searchResult = nullptr;
+    ret = ldap_search_ext_s(m_handler,
+                            searchBase.c_str(),
+                            LDAP_SCOPE_SUBTREE,
+                            filter.c_str(),
+                            attributes.empty() ? nullptr : attrList.data(),
+                            0,
+                            serverControls,
+                            nullptr,
+                            &timeout,
+                            0,
+                            &searchResult);
+    ldap_control_free(pageControl);
+    if (ret != LDAP_SUCCESS) {
+      m_lastError = QObject::tr("LDAP: Search failed: %1").arg(ldap_err2string(ret));
+      if (searchResult)
+        ldap_msgfree(searchResult);
+      return -1;
+    }
 
-  if (searchResult)
+    // parse result
+    LdapUserMapT page;
+    for (LDAPMessage* currentEntry = ldap_first_entry(m_handler, searchResult);
+         currentEntry != nullptr;
+         currentEntry = ldap_next_entry(m_handler, currentEntry)) {
+      std::string dn = getObjectDistingisghName(currentEntry);
+      page[dn].insert("dn", dn);
+      parseObjectAttr(currentEntry, page[dn]);
+    }
+
+    ret = fetchNextPageCookie(searchResult, &cookie);
     ldap_msgfree(searchResult);
+    if (ret != LDAP_SUCCESS) {
+      m_lastError = QObject::tr("LDAP: Failed reading the paged result: %1").arg(ldap_err2string(ret));
+      return -1;
+    }
+
+    for (auto entry = page.cbegin(); entry != page.cend(); ++entry) {
+      userMap.insert(entry.key(), entry.value());
+    }
+    if (pageHandler) {
+      pageHandler(page);
+    }
+  } while (cookie);
 
   return userMap.size();
 }
 
 
+int LdapHelper::fetchNextPageCookie(LDAPMessage* searchResult, struct berval** cookie)
+{
+  LDAPControl** returnedControls = nullptr;
+  int errorCode = LDAP_SUCCESS;
+  int ret = ldap_parse_result(m_handler, searchResult, &errorCode, nullptr, nullptr, nullptr, &returnedControls, 0);
+  if (ret != LDAP_SUCCESS) {
+    return ret;
+  }
+
+  // no cookie, or an empty one, means that the last page has been reached
+  *cookie = nullptr;
+  if (returnedControls) {
+    LDAPControl* pageResponse = ldap_control_find(LDAP_CONTROL_PAGEDRESULTS, returnedControls, nullptr);
+    if (pageResponse) {
+      ber_int_t estimatedCount = 0;
+      struct berval nextCookie = {0, nullptr};
+      ret = ldap_parse_pageresponse_control(m_handler, pageResponse, &estimatedCount, &nextCookie);
+      if (ret == LDAP_SUCCESS && nextCookie.bv_len > 0) {
+        *cookie = ber_bvdup(&nextCookie);
+      }
+      ldap_memfree(nextCookie.bv_val);
+    }
+    ldap_controls_free(returnedControls);
+  }
+
+  return (errorCode != LDAP_SUCCESS) ? errorCode : ret;
+}
+
+
 std::string LdapHelper::getObjectDistingisghName(LDAPMessage* objectData)
 {
   char* buffer;
@@ -28,11 +28,14 @@
 #include <QString>
 #include <QVector>
 #include <ldap.h>
+#include <functional>
+#include <vector>
 
 
 
 typedef QMap<std::string, std::string> LdapUserAttrsT;
 typedef QMap<std::string, LdapUserAttrsT> LdapUserMapT;
+typedef std::function<void(const LdapUserMapT& page)> LdapPageHandlerT;
 
 class LdapHelper
 {
@@ -49,7 +52,16 @@ public:
                 const std::string& bindUser,
                 const std::string& bindPass,
                 const std::string& filter,
-                LdapUserMapT& users);
+                const std::vector<std::string>& attributes,
+                LdapUserMapT& users,
+                const LdapPageHandlerT& pageHandler = nullptr);
+  int searchUsers(const std::string& searchBase,
+                  const std::string& filter,
+                  const std::vector<std::string>& attributes,
+                  LdapUserMapT& users,
+                  const LdapPageHandlerT& pageHandler = nullptr);
+  static std::string escapeFilterValue(const std::string& value);
+  static std::vector<std::string> userAttributes(const std::string& uidField);
   QString lastError(void) const {return m_lastError;}
 
 private:
@@ -67,6 +79,7 @@ private:
   void setSslSettings(void);
   std::string getObjectDistingisghName(LDAPMessage* objectData);
   void parseObjectAttr(LDAPMessage* objectData, LdapUserAttrsT& userInfo);
+  int fetchNextPageCookie(LDAPMessage* searchResult, struct berval** cookie);
 };
 
 #endif // LDAPHELPER_HPP
@@ -24,6 +24,7 @@
 
 #include "WebUtils.hpp"
 #include "Notificator.hpp"
+#include "StatusSnapshot.hpp"
 
 
 namespace {
@@ -41,88 +42,233 @@ namespace {
 }
 
 
-Notificator::Notificator(DbSession* dbSession)
-  : m_dbSession(dbSession)
+Notificator::Notificator(void)
+  : m_dbSession(nullptr),
+    m_coalescingTimer(nullptr),
+    m_nextSender(0)
 {
-  m_mailSender.reset(new MailSender(QString::fromStdString(m_preferences.getSmtpServerAddr()),
-                                    m_preferences.getSmtpServerPort(),
-                                    QString::fromStdString(m_preferences.getSmtpUsername()),
-                                    QString::fromStdString(m_preferences.getSmtpPassword()),
-                                    m_preferences.getSmtpUseSsl()));
 }
 
 
-void Notificator::sendEmailNotification(const NodeT& node, int lastStatus, const QosDataT& qosData, const QStringList& recipients)
+void Notificator::initialize(void)
 {
-  if (m_preferences.getNotificationType() != WebBaseSettings::EmailNotification) {
-    // do nothing and exit
-    return;
+  // called within the dispatcher thread
+  if (DbConnectionPool::shared()) {
+    m_dbSession = new DbSession(*DbConnectionPool::shared());
+  } else {
+    m_dbSession = new DbSession(m_preferences.getDbType(), m_preferences.getDbConnectionString());
   }
 
-  QString statusString = Severity(node.sev).toString().toUpper();
-  QString statusHtmlColor = QString::fromStdString(ngrt4n::severityHtmlColor(node.sev));
-  QString lastStateString = Severity(lastStatus).toString().toUpper();
-  QString lastStatusHtmlColor = QString::fromStdString(ngrt4n::severityHtmlColor(lastStatus));
+  m_coalescingTimer = new QTimer(this);
+  m_coalescingTimer->setSingleShot(true);
+  connect(m_coalescingTimer, SIGNAL(timeout()), this, SLOT(flush()));
 
-  QString emailSubject;
-  if (lastStatus != ngrt4n::Normal && node.sev == ngrt4n::Normal) {
-    emailSubject = QString("%1 - Recovered").arg(node.name);
-  } else {
-    emailSubject = QString("%1 - %2 Problem").arg(node.name, statusString);
+  QString smtpHost = QString::fromStdString(m_preferences.getSmtpServerAddr());
+  int smtpPort = m_preferences.getSmtpServerPort();
+  QString smtpUsername = QString::fromStdString(m_preferences.getSmtpUsername());
+  QString smtpPassword = QString::fromStdString(m_preferences.getSmtpPassword());
+  bool smtpUseSsl = m_preferences.getSmtpUseSsl();
+
+  for (int index = 0; index < SenderCount; ++index) {
+    // a sender owns a socket and internal objects that can't be moved along with it,
+    // so it's built within its own thread once that one is started
+    QThread* thread = new QThread();
+    std::promise<MailSender*> senderReady;
+    QMetaObject::Connection startConnection = connect(thread, &QThread::started, [&]() {
+      senderReady.set_value(new MailSender(smtpHost, smtpPort, smtpUsername, smtpPassword, smtpUseSsl));
+    });
+    thread->start();
+    MailSender* sender = senderReady.get_future().get();
+    disconnect(startConnection);
+    connect(thread, SIGNAL(finished()), sender, SLOT(deleteLater()));
+    m_senderThreads.push_back(thread);
+    m_senders.push_back(sender);
   }
+}
 
-  REPORTD_LOG("info", emailSubject);
 
-  QString emailContent = EMAIL_NOTIFICATION_CONTENT_TEMPLATE.arg(
-        emailSubject,
-        ngrt4n::timet2String(qosData.timestamp).toUTF8().c_str(),
-        statusHtmlColor,
-        statusString,
-        lastStatusHtmlColor,
-        lastStateString,
-        node.toString().replace("\n", "<br />"));
+void Notificator::cleanup(void)
+{
+  if (! m_dbSession) {
+    return;
+  }
 
+  m_coalescingTimer->stop();
+  flush();
 
-  int retCode = m_mailSender->send(m_preferences.getSmtpUsername().c_str(),
-                                   recipients,
-                                   emailSubject,
-                                   emailContent);
+  // let the senders go through the mails already queued before stopping them
+  for (size_t index = 0; index < m_senders.size(); ++index) {
+    connect(m_senders[index], SIGNAL(drained()), m_senderThreads[index], SLOT(quit()), Qt::DirectConnection);
+    QMetaObject::invokeMethod(m_senders[index], "stopWhenIdle", Qt::QueuedConnection);
+  }
+  for (auto thread : m_senderThreads) {
+    if (! thread->wait(SenderDrainTimeout)) {
+      REPORTD_LOG("warning", QObject::tr("[Notificator] mails still queued after %1 ms, giving up").arg(SenderDrainTimeout));
+      thread->quit();
+      thread->wait();
+    }
+    delete thread;
+  }
+  m_senders.clear();
+  m_senderThreads.clear();
 
-  std::string logLevel = (retCode == 0) ? "info" : "error";
-  REPORTD_LOG(logLevel, QObject::tr("[Notificator] %1").arg(m_mailSender->lastError()));
+  delete m_dbSession;
+  m_dbSession = nullptr;
 }
 
+
 void Notificator::handleNotification(const NodeT& node, const QosDataT& qosData)
 {
-  std::string viewName = node.name.toStdString();
-  QStringList recipients;
-  if (m_dbSession->listAssignedUsersEmails(recipients, viewName) <= 0) {
-    REPORTD_LOG("info", QString("No notification recipients for view %1").arg(viewName.c_str()));
+  ViewEventT event;
+  event.view_name = node.name.toStdString();
+  event.status = node.sev;
+  event.last_status = -1;
+  event.timestamp = qosData.timestamp;
+  event.details = node.toString().replace("\n", "<br />");
+
+  bool firstPending = false;
+  {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    firstPending = m_pendingEvents.isEmpty();
+    m_pendingEvents[event.view_name] = event; // only the latest status of a view matters
+  }
+
+  if (firstPending) {
+    QMetaObject::invokeMethod(this, "startCoalescing", Qt::QueuedConnection);
+  }
+}
+
+
+void Notificator::startCoalescing(void)
+{
+  if (! m_dbSession) {
+    initialize();
+  }
+  if (! m_coalescingTimer->isActive()) {
+    m_coalescingTimer->start(CoalescingDelay);
+  }
+}
+
+
+void Notificator::flush(void)
+{
+  QMap<std::string, ViewEventT> events;
+  {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    events.swap(m_pendingEvents);
+  }
+  if (events.isEmpty()) {
     return;
   }
 
-  NotificationT lastNotifData;
-  m_dbSession->getLastNotificationInfo(lastNotifData, viewName);
-  bool updateRequired = false;
-  switch (node.sev) {
-    case  ngrt4n::Normal:
-      if (lastNotifData.view_status != node.sev) {
-        updateRequired = true;
+  // the views whose status is already the last notified one, as recorded in the status
+  // snapshot, need no lookup
+  std::set<std::string> viewIds;
+  for (auto event = events.begin(); event != events.end();) {
+    if (StatusSnapshot::shared().notifiedStatus(QString::fromStdString(event->view_name)) == event->status) {
+      if (event->status != ngrt4n::Normal) {
+        REPORTD_LOG("error", QString("The service %1 is still in %2 state").arg(event->view_name.c_str(), Severity(event->status).toString()));
       }
-    break;
-  default:
-    if (lastNotifData.view_status != node.sev) {
-      updateRequired = true;
+      event = events.erase(event);
     } else {
-      REPORTD_LOG("error", QString("The service %1 is still in %2 state").arg(viewName.c_str(), Severity(node.sev).toString()));
+      viewIds.insert(event->view_name);
+      ++event;
     }
-   break;
-  }
-  
- if (updateRequired) {
-   sendEmailNotification(node, lastNotifData.view_status, qosData, recipients);
-   m_dbSession->updateNotificationAckStatusForUser("admin", viewName, DboNotification::Closed);
-   m_dbSession->addNotification(viewName, node.sev);
- }
+  }
+  if (viewIds.empty()) {
+    return;
+  }
+
+  NotificationTargetMapT targets;
+  m_dbSession->listNotificationTargets(targets, viewIds);
+
+  QMap<QString, ViewEventListT> changesByRecipient;
+  for (auto event : events) {
+    auto target = targets.find(event.view_name);
+    if (target == targets.end()) {
+      REPORTD_LOG("info", QString("No notification recipients for view %1").arg(event.view_name.c_str()));
+      continue;
+    }
+
+    if (target->last_status == event.status) {
+      StatusSnapshot::shared().setNotifiedStatus(QString::fromStdString(event.view_name), event.status);
+      if (event.status != ngrt4n::Normal) {
+        REPORTD_LOG("error", QString("The service %1 is still in %2 state").arg(event.view_name.c_str(), Severity(event.status).toString()));
+      }
+      continue;
+    }
+
+    event.last_status = target->last_status;
+    m_dbSession->updateNotificationAckStatusForUser("admin", event.view_name, DboNotification::Closed);
+    m_dbSession->addNotification(event.view_name, event.status);
+    StatusSnapshot::shared().setNotifiedStatus(QString::fromStdString(event.view_name), event.status);
+    for (const auto& recipient : target->recipients) {
+      changesByRecipient[recipient].push_back(event);
+    }
+  }
+
+  // recipients of the same changes share a mail
+  QMap<QString, QPair<ViewEventListT, QStringList> > mails;
+  for (auto changes = changesByRecipient.cbegin(); changes != changesByRecipient.cend(); ++changes) {
+    QStringList viewNames;
+    for (const auto& event : changes.value()) {
+      viewNames.push_back(QString::fromStdString(event.view_name));
+    }
+    auto& mail = mails[viewNames.join("\n")];
+    mail.first = changes.value();
+    mail.second.push_back(changes.key());
+  }
+
+  for (const auto& mail : mails) {
+    sendEmailNotification(mail.first, mail.second);
+  }
 }
 
+
+void Notificator::sendEmailNotification(const ViewEventListT& events, const QStringList& recipients)
+{
+  if (m_preferences.getNotificationType() != WebBaseSettings::EmailNotification) {
+    // do nothing and exit
+    return;
+  }
+
+  QString emailSubject;
+  QString emailContent;
+  for (const auto& event : events) {
+    QString statusString = Severity(event.status).toString().toUpper();
+    QString statusHtmlColor = QString::fromStdString(ngrt4n::severityHtmlColor(event.status));
+    QString lastStateString = Severity(event.last_status).toString().toUpper();
+    QString lastStatusHtmlColor = QString::fromStdString(ngrt4n::severityHtmlColor(event.last_status));
+
+    QString changeSubject;
+    if (event.last_status != ngrt4n::Normal && event.status == ngrt4n::Normal) {
+      changeSubject = QString("%1 - Recovered").arg(event.view_name.c_str());
+    } else {
+      changeSubject = QString("%1 - %2 Problem").arg(event.view_name.c_str(), statusString);
+    }
+
+    REPORTD_LOG("info", changeSubject);
+
+    emailSubject = changeSubject;
+    emailContent += EMAIL_NOTIFICATION_CONTENT_TEMPLATE.arg(
+                      changeSubject,
+                      ngrt4n::timet2String(event.timestamp).toUTF8().c_str(),
+                      statusHtmlColor,
+                      statusString,
+                      lastStatusHtmlColor,
+                      lastStateString,
+                      event.details);
+  }
+
+  if (events.size() > 1) {
+    emailSubject = QString("%1 service status changes").arg(events.size());
+  }
+
+  MailSender* sender = m_senders[m_nextSender];
+  m_nextSender = (m_nextSender + 1) % m_senders.size();
+  QMetaObject::invokeMethod(sender, "sendQueued", Qt::QueuedConnection,
+                            Q_ARG(QString, QString::fromStdString(m_preferences.getSmtpUsername())),
+                            Q_ARG(QStringList, recipients),
+                            Q_ARG(QString, emailSubject),
+                            Q_ARG(QString, emailContent));
+}
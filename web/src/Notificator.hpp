@@ -30,21 +30,60 @@
 #include "utils/smtpclient/MailSender.hpp"
 #include <QObject>
 #include <QString>
+#include <QThread>
+#include <QTimer>
+#include <future>
+#include <mutex>
 
+/**
+ * Background notification dispatcher of ngrt4n-reportd.
+ *
+ * Collectors post the view statuses from any thread and move on. The dispatcher lives in
+ * its own thread: it gathers the statuses posted during a short window, keeps the latest
+ * one per view, looks up the recipients and the last notifications of all of them with a
+ * single query, then sends one mail per set of recipients sharing the same changes. Mails
+ * are sent in parallel by a few senders that keep their SMTP connection open, each one
+ * working through its own queue in its own thread.
+ */
 class Notificator : public QObject
 {
   Q_OBJECT
 
 public:
-  Notificator(DbSession* dbSession);
-  void sendEmailNotification(const NodeT& node, int lastState, const QosDataT& qosData, const QStringList& recipients);
+  static const int CoalescingDelay = 2000; // in milliseconds
+  static const int SenderCount = 2;
+  static const int SenderDrainTimeout = 30000; // in milliseconds
+
+  Notificator(void);
   void handleNotification(const NodeT& node, const QosDataT& qosData);
 
+public Q_SLOTS:
+  void cleanup(void);
+
+private Q_SLOTS:
+  void startCoalescing(void);
+  void flush(void);
 
 private:
-  std::unique_ptr<MailSender> m_mailSender;
+  struct ViewEventT {
+    std::string view_name;
+    int status;
+    int last_status;
+    long timestamp;
+    QString details;
+  };
+  typedef QList<ViewEventT> ViewEventListT;
+
   WebBaseSettings m_preferences;
   DbSession* m_dbSession;
-  QEventLoop m_eventSynchonizer;
+  QTimer* m_coalescingTimer;
+  std::vector<QThread*> m_senderThreads;
+  std::vector<MailSender*> m_senders;
+  size_t m_nextSender;
+  std::mutex m_pendingMutex;
+  QMap<std::string, ViewEventT> m_pendingEvents;
+
+  void initialize(void);
+  void sendEmailNotification(const ViewEventListT& events, const QStringList& recipients);
 };
 #endif // NOTIFICATOR_H
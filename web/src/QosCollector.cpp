@@ -47,3 +47,35 @@ void QosCollector::updateChart(void)
   m_qosInfo.critical  = static_cast<float>(m_chartBase.statusRatio(ngrt4n::Critical));
   m_qosInfo.unknown   = static_cast<float>(m_chartBase.statusRatio(ngrt4n::Unknown));
 }
+
+
+QosRecordingFilter::QosRecordingFilter(bool enabled, double epsilon, long heartbeat)
+  : m_enabled(enabled),
+    m_epsilon(epsilon),
+    m_heartbeat(heartbeat)
+{
+}
+
+
+bool QosRecordingFilter::accept(const QosDataT& qosData)
+{
+  if (! m_enabled) {
+    return true;
+  }
+
+  QMutexLocker locker(&m_mutex);
+  auto lastRecorded = m_lastRecorded.find(qosData.view_name);
+  bool changed = (lastRecorded == m_lastRecorded.end())
+                 || lastRecorded->status != qosData.status
+                 || qosData.timestamp - lastRecorded->timestamp >= m_heartbeat
+                 || hasMoved(lastRecorded->normal, qosData.normal)
+                 || hasMoved(lastRecorded->minor, qosData.minor)
+                 || hasMoved(lastRecorded->major, qosData.major)
+                 || hasMoved(lastRecorded->critical, qosData.critical)
+                 || hasMoved(lastRecorded->unknown, qosData.unknown);
+  if (changed) {
+    m_lastRecorded[qosData.view_name] = qosData;
+  }
+
+  return changed;
+}
@@ -28,6 +28,7 @@
 #include "dbo/src/DbObjects.hpp"
 #include "dbo/src/DbSession.hpp"
 #include "ChartBase.hpp"
+#include <QMutex>
 
 class QosCollector : public DashboardBase
 {
@@ -49,4 +50,27 @@ private:
   QosDataT m_qosInfo;
 };
 
+
+/**
+ * Selects the QoS samples to store when change-only recording is enabled: a sample is
+ * kept if the status or any ratio moved beyond epsilon since the last stored one, or if
+ * no sample has been stored for the view during the heartbeat period. It can be shared by
+ * the collector workers.
+ */
+class QosRecordingFilter
+{
+public:
+  QosRecordingFilter(bool enabled, double epsilon, long heartbeat);
+  bool accept(const QosDataT& qosData);
+
+private:
+  bool m_enabled;
+  double m_epsilon;
+  long m_heartbeat;
+  QMap<std::string, QosDataT> m_lastRecorded;
+  QMutex m_mutex;
+
+  bool hasMoved(float lastValue, float newValue) const { return qAbs(static_cast<double>(newValue - lastValue)) > m_epsilon; }
+};
+
 #endif // REPORTCOLLECTOR_HPP
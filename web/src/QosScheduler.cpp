@@ -0,0 +1,415 @@
+/*
+ * QosScheduler.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "QosScheduler.hpp"
+#include "WebUtils.hpp"
+#include "HttpTransport.hpp"
+#include "StatusSnapshot.hpp"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <chrono>
+#include <ctime>
+#include <regex>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+  const qint64 MaxIdleWait = 1000; // in milliseconds, bounds the wait between two dispatches
+}
+
+
+QosWorker::QosWorker(QosScheduler* scheduler)
+  : m_scheduler(scheduler),
+    m_pendingCount(0),
+    m_settings(nullptr),
+    m_dbSession(nullptr)
+{
+}
+
+
+void QosWorker::post(const std::string& viewName, const std::string& viewPath)
+{
+  ++m_pendingCount;
+  QMetaObject::invokeMethod(this, "collect", Qt::QueuedConnection,
+                            Q_ARG(QString, QString::fromStdString(viewName)),
+                            Q_ARG(QString, QString::fromStdString(viewPath)));
+}
+
+
+void QosWorker::collect(QString viewName, QString viewPath)
+{
+  // the worker resources are created within the worker thread
+  if (! m_dbSession) {
+    m_settings = new WebBaseSettings();
+    if (DbConnectionPool::shared()) {
+      m_dbSession = new DbSession(*DbConnectionPool::shared());
+    } else {
+      m_dbSession = new DbSession(m_settings->getDbType(), m_settings->getDbConnectionString());
+    }
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  std::string viewId = viewName.toStdString();
+  QosCollector collector;
+  collector.setDbSession(m_dbSession);
+  auto initilizeOut = collector.initialize(m_settings, viewPath);
+  if (initilizeOut.first != ngrt4n::RcSuccess) {
+    REPORTD_LOG("error", QObject::tr("%1: %2").arg(viewName, initilizeOut.second).toStdString());
+  } else {
+    collector.loadDataSources();
+    // the last collected status is the base of the update, only the changes are rendered again
+    collector.applyStatusSnapshot();
+    auto updateOut = collector.updateAllNodesStatus();
+    if (updateOut.first != ngrt4n::RcSuccess) {
+      REPORTD_LOG("error", updateOut.second.toStdString());
+    } else {
+      QosDataT qosData = collector.qosInfo();
+      if (qosData.view_name != viewId && std::regex_match(viewId, std::regex("Source[0-9]:.+"))) {
+        qosData.view_name = viewId;
+      }
+      qosData.timestamp = time(nullptr); // now
+      StatusSnapshot::ViewStatusT status = collector.statusSnapshot();
+      status.period = m_scheduler->period();
+      StatusSnapshot::shared().updateView(collector.rootNode().name, status);
+      try {
+        if (m_scheduler->recordingFilter()->accept(qosData)) {
+          m_dbSession->addQosData(qosData);
+        } else {
+          // the dashboards summaries and the SLA tail still rely on the latest sample
+          m_dbSession->setLastQosData(qosData);
+        }
+      } catch(const std::exception& ex) {
+        REPORTD_LOG("error", std::string(ex.what()));
+      }
+
+      // handle notifications if applicable
+      if (m_settings->getNotificationType() != WebBaseSettings::NoNotification) {
+        m_scheduler->notificator()->handleNotification(collector.rootNode(), qosData);
+      }
+    }
+  }
+
+  --m_pendingCount;
+  m_scheduler->reportCompletion(viewId, timer.elapsed());
+}
+
+
+void QosWorker::cleanup(void)
+{
+  delete m_dbSession;
+  delete m_settings;
+  m_dbSession = nullptr;
+  m_settings = nullptr;
+}
+
+
+std::atomic<bool> QosScheduler::s_stopRequested(false);
+
+
+QosScheduler::QosScheduler(int period, int workerCount)
+  : m_period(period),
+    m_periodMs(static_cast<qint64>(period) * 1000),
+    m_recordingFilter(m_settings.getQosCompression(), m_settings.getQosEpsilon(), m_settings.getQosHeartbeat()),
+    m_lastLeaseRenewal(0),
+    m_lastTransportReport(QDateTime::currentMSecsSinceEpoch()),
+    m_lastStatusSnapshot(QDateTime::currentMSecsSinceEpoch()),
+    m_statusSnapshotPath(m_settings.getStatusSnapshotPath()),
+    m_random(std::random_device()()),
+    m_shutDown(false)
+{
+  char hostname[256] = {0};
+  gethostname(hostname, sizeof(hostname) - 1);
+  m_collectorId = QString("%1:%2").arg(hostname).arg(getpid()).toStdString();
+
+  if (DbConnectionPool::shared()) {
+    m_dbSession = new DbSession(*DbConnectionPool::shared());
+  } else {
+    m_dbSession = new DbSession(m_settings.getDbType(), m_settings.getDbConnectionString());
+  }
+  m_dbSession->setupLastQosDataTable();
+  m_dbSession->setupCollectorLeaseTables();
+  m_dbSession->setupViewStatusTable();
+
+  auto loadSnapshotOut = StatusSnapshot::shared().load(m_statusSnapshotPath);
+  REPORTD_LOG(loadSnapshotOut.first == ngrt4n::RcSuccess ? "notice" : "error", loadSnapshotOut.second);
+
+  if (m_settings.getQosCompression()) {
+    REPORTD_LOG("notice", QObject::tr("Change-only QoS recording enabled (epsilon: %1%, heartbeat: %2s)")
+                .arg(m_settings.getQosEpsilon())
+                .arg(m_settings.getQosHeartbeat()));
+  }
+
+  m_notificationThread = new QThread();
+  m_notificator = new Notificator();
+  m_notificator->moveToThread(m_notificationThread);
+  m_notificationThread->start();
+
+  for (int index = 0; index < workerCount; ++index) {
+    QThread* thread = new QThread();
+    QosWorker* worker = new QosWorker(this);
+    worker->moveToThread(thread);
+    thread->start();
+    m_threads.push_back(thread);
+    m_workers.push_back(worker);
+  }
+  REPORTD_LOG("notice", QObject::tr(" => Workers: %1").arg(workerCount));
+  REPORTD_LOG("notice", QObject::tr(" => Collector: %1").arg(m_collectorId.c_str()));
+}
+
+
+QosScheduler::~QosScheduler()
+{
+  shutdown();
+  delete m_dbSession;
+}
+
+
+void QosScheduler::shutdown(void)
+{
+  if (m_shutDown) {
+    return;
+  }
+  m_shutDown = true;
+
+  // the cleanup is queued behind the collections already posted, so the workers finish them first
+  for (size_t index = 0; index < m_workers.size(); ++index) {
+    QMetaObject::invokeMethod(m_workers[index], "cleanup", Qt::BlockingQueuedConnection);
+    m_threads[index]->quit();
+    m_threads[index]->wait();
+    delete m_workers[index];
+    delete m_threads[index];
+  }
+  m_workers.clear();
+  m_threads.clear();
+
+  // no more notification can come from the workers at this point
+  QMetaObject::invokeMethod(m_notificator, "cleanup", Qt::BlockingQueuedConnection);
+  m_notificationThread->quit();
+  m_notificationThread->wait();
+  delete m_notificator;
+  delete m_notificationThread;
+  m_notificator = nullptr;
+  m_notificationThread = nullptr;
+
+  // the last statuses are published before another collector can take the views over
+  publishViewStatuses();
+
+  // the other collectors can take the views over on their next renewal rather than after the lease ttl
+  if (m_dbSession->releaseViewLeases(m_collectorId) == ngrt4n::RcSuccess) {
+    REPORTD_LOG("notice", QObject::tr("collector %1 released its view leases").arg(m_collectorId.c_str()));
+  }
+
+  // the statuses collected since the last periodic save are kept for the next start
+  saveStatusSnapshot();
+}
+
+
+void QosScheduler::run(void)
+{
+  qint64 nextRefresh = 0;
+  while (! s_stopRequested.load()) {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now >= nextRefresh) {
+      refreshViews(now);
+      nextRefresh = now + LeaseRenewInterval * 1000;
+    }
+
+    if (now - m_lastTransportReport >= TransportReportInterval * 1000) {
+      REPORTD_LOG("info", HttpTransport::metricsSummary().toStdString());
+      m_lastTransportReport = now;
+    }
+
+    if (now - m_lastStatusSnapshot >= StatusSnapshotInterval * 1000) {
+      publishViewStatuses();
+      saveStatusSnapshot();
+      m_lastStatusSnapshot = now;
+    }
+
+    qint64 nextWakeUp = std::min(nextRefresh, now + MaxIdleWait);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      dispatchDueViews(now);
+      if (! m_deadlines.empty()) {
+        nextWakeUp = std::min(nextWakeUp, m_deadlines.top().first);
+      }
+    }
+
+    qint64 waitTime = nextWakeUp - QDateTime::currentMSecsSinceEpoch();
+    if (waitTime > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(waitTime));
+    }
+  }
+
+  REPORTD_LOG("notice", QObject::tr("stop requested, waiting for the running collections to complete"));
+  shutdown();
+}
+
+
+void QosScheduler::refreshViews(qint64 now)
+{
+  long nowSecs = static_cast<long>(now / 1000);
+  ViewLeaseListT leases;
+  auto acquireOut = m_dbSession->acquireViewLeases(m_collectorId, LeaseTtl, LeaseRenewInterval, leases);
+  if (acquireOut.first != ngrt4n::RcSuccess) {
+    // unrenewed leases are about to lapse, stop collecting before another collector takes over
+    if (nowSecs - m_lastLeaseRenewal >= LeaseTtl - LeaseRenewInterval) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (! m_views.isEmpty()) {
+        REPORTD_LOG("error", QObject::tr("view leases not renewed, suspending the collection"));
+        m_views.clear();
+      }
+    }
+    return;
+  }
+  m_lastLeaseRenewal = nowSecs;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  QMap<std::string, ViewScheduleT> views;
+  std::uniform_int_distribution<qint64> jitter(0, m_periodMs - 1);
+  for (const auto& lease : leases) {
+    auto current = m_views.find(lease.view_name);
+    if (current != m_views.end()) {
+      current->path = lease.view_path;
+      views.insert(lease.view_name, *current);
+      continue;
+    }
+    // a view taken over from another collector goes on from its last sample, a view never
+    // sampled starts at a random point of the period to spread the load
+    ViewScheduleT schedule;
+    schedule.path = lease.view_path;
+    // another collector may have notified a change in the meantime
+    StatusSnapshot::shared().setNotifiedStatus(QString::fromStdString(lease.view_name), -1);
+    if (lease.last_sample > 0) {
+      schedule.deadline = std::max(now, (static_cast<qint64>(lease.last_sample) + m_period) * 1000);
+    } else {
+      schedule.deadline = now + jitter(m_random);
+    }
+    schedule.running = false;
+    schedule.overrunCount = 0;
+    views.insert(lease.view_name, schedule);
+    m_deadlines.push(DeadlineT(schedule.deadline, lease.view_name));
+  }
+
+  if (views.size() != m_views.size()) {
+    REPORTD_LOG("notice", QObject::tr("collector %1 now in charge of %2 view(s)").arg(m_collectorId.c_str()).arg(views.size()));
+  }
+  // the deadlines of released views are dropped when they come up
+  m_views.swap(views);
+}
+
+
+void QosScheduler::dispatchDueViews(qint64 now)
+{
+  while (! m_deadlines.empty() && m_deadlines.top().first <= now) {
+    DeadlineT due = m_deadlines.top();
+    m_deadlines.pop();
+
+    auto view = m_views.find(due.second);
+    if (view == m_views.end() || view->deadline != due.first) {
+      continue;
+    }
+
+    if (view->running) {
+      ++view->overrunCount;
+      REPORTD_LOG("warning", QObject::tr("%1: previous collection still running, skipping this cycle (overruns: %2)")
+                  .arg(due.second.c_str()).arg(view->overrunCount));
+    } else {
+      view->running = true;
+      leastLoadedWorker()->post(due.second, view->path);
+    }
+
+    // next deadlines stay aligned on the initial one; cycles missed while overloaded are skipped
+    qint64 missedCycles = (now - due.first) / m_periodMs;
+    if (missedCycles > 0) {
+      REPORTD_LOG("warning", QObject::tr("%1: %2 collection cycle(s) missed, the workers are overloaded")
+                  .arg(due.second.c_str()).arg(missedCycles));
+    }
+    view->deadline = due.first + (missedCycles + 1) * m_periodMs;
+    m_deadlines.push(DeadlineT(view->deadline, due.second));
+  }
+}
+
+
+QosWorker* QosScheduler::leastLoadedWorker(void) const
+{
+  QosWorker* selected = m_workers.front();
+  for (auto worker : m_workers) {
+    if (worker->pendingCount() < selected->pendingCount()) {
+      selected = worker;
+    }
+  }
+  return selected;
+}
+
+
+void QosScheduler::saveStatusSnapshot(void)
+{
+  if (! StatusSnapshot::shared().isDirty()) {
+    return;
+  }
+  auto saveOut = StatusSnapshot::shared().save(m_statusSnapshotPath);
+  if (saveOut.first != ngrt4n::RcSuccess) {
+    REPORTD_LOG("error", saveOut.second.toStdString());
+  }
+}
+
+
+void QosScheduler::publishViewStatuses(void)
+{
+  StatusSnapshot::RecordMapT records = StatusSnapshot::shared().takeUnpublishedRecords();
+  if (records.isEmpty()) {
+    return;
+  }
+
+  ViewStatusRecordListT dbRecords;
+  for (auto record = records.cbegin(); record != records.cend(); ++record) {
+    ViewStatusRecordT dbRecord;
+    dbRecord.view_name = record.key().toStdString();
+    dbRecord.timestamp = static_cast<long>(record->timestamp);
+    dbRecord.record.assign(record->content.cbegin(), record->content.cend());
+    dbRecords.push_back(dbRecord);
+  }
+  auto saveOut = m_dbSession->saveViewStatuses(dbRecords);
+  if (saveOut.first != ngrt4n::RcSuccess) {
+    // retried on the next round, with the records as they are by then
+    StatusSnapshot::shared().markUnpublished(records);
+    REPORTD_LOG("error", saveOut.second.toStdString());
+  }
+}
+
+
+void QosScheduler::reportCompletion(const std::string& viewName, qint64 elapsed)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto view = m_views.find(viewName);
+  if (view != m_views.end()) {
+    view->running = false;
+  }
+  if (elapsed > m_periodMs) {
+    REPORTD_LOG("warning", QObject::tr("%1: collection took %2 ms, longer than the period (%3 s)")
+                .arg(viewName.c_str()).arg(elapsed).arg(m_period));
+  }
+}
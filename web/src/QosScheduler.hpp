@@ -0,0 +1,138 @@
+/*
+ * QosScheduler.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@gmail.com)    #
+# Last Update: 18-10-2026                                                  #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef QOSSCHEDULER_HPP
+#define QOSSCHEDULER_HPP
+
+#include "dbo/src/DbSession.hpp"
+#include "WebBaseSettings.hpp"
+#include "QosCollector.hpp"
+#include "Notificator.hpp"
+#include <QObject>
+#include <QThread>
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <random>
+
+class QosScheduler;
+
+/**
+ * Collects views on behalf of the scheduler. Each worker lives in its own thread with its
+ * own event loop, settings and database session.
+ */
+class QosWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  QosWorker(QosScheduler* scheduler);
+  int pendingCount(void) const {return m_pendingCount.load();}
+  void post(const std::string& viewName, const std::string& viewPath);
+
+public Q_SLOTS:
+  void collect(QString viewName, QString viewPath);
+  void cleanup(void);
+
+private:
+  QosScheduler* m_scheduler;
+  std::atomic<int> m_pendingCount;
+  WebBaseSettings* m_settings;
+  DbSession* m_dbSession;
+};
+
+
+/**
+ * Runs the QoS collection of ngrt4n-reportd. Each view has its own deadline, first drawn at
+ * random within the period so that the views are spread over time, then advanced by exactly
+ * one period so that the sampling does not drift with the collection time. Due views are
+ * handed over to the least loaded worker; a view still running when its next deadline comes
+ * is skipped and reported as an overrun.
+ *
+ * Several reportd instances can share the views: each one only collects the views it holds
+ * a lease on in the database, and renews and rebalances its leases periodically. The status of
+ * the views is published in the database as well, the status snapshot file being local to a host.
+ *
+ * run() returns once a stop is requested, after the collections already handed over to the
+ * workers and the pending notifications are done.
+ */
+class QosScheduler
+{
+public:
+  static const long LeaseRenewInterval = 30; // in seconds
+  static const long LeaseTtl = 3 * LeaseRenewInterval;
+  static const long TransportReportInterval = 600; // in seconds
+  static const long StatusSnapshotInterval = 5; // in seconds, also the latency of the status published to the web sessions
+
+  QosScheduler(int period, int workerCount);
+  ~QosScheduler();
+
+  void run(void);
+  static void requestStop(void) {s_stopRequested.store(true);}
+  int period(void) const {return m_period;}
+  QosRecordingFilter* recordingFilter(void) {return &m_recordingFilter;}
+  Notificator* notificator(void) {return m_notificator;}
+  void reportCompletion(const std::string& viewName, qint64 elapsed);
+
+private:
+  static std::atomic<bool> s_stopRequested;
+
+  struct ViewScheduleT {
+    std::string path;
+    qint64 deadline;
+    bool running;
+    int overrunCount;
+  };
+  typedef std::pair<qint64, std::string> DeadlineT;
+  typedef std::priority_queue<DeadlineT, std::vector<DeadlineT>, std::greater<DeadlineT> > DeadlineQueueT;
+
+  int m_period;
+  qint64 m_periodMs;
+  WebBaseSettings m_settings;
+  QosRecordingFilter m_recordingFilter;
+  std::string m_collectorId;
+  long m_lastLeaseRenewal;
+  qint64 m_lastTransportReport;
+  qint64 m_lastStatusSnapshot;
+  QString m_statusSnapshotPath;
+  DbSession* m_dbSession;
+  std::vector<QThread*> m_threads;
+  std::vector<QosWorker*> m_workers;
+  QThread* m_notificationThread;
+  Notificator* m_notificator;
+  std::mutex m_mutex;
+  QMap<std::string, ViewScheduleT> m_views;
+  DeadlineQueueT m_deadlines;
+  std::mt19937 m_random;
+  bool m_shutDown;
+
+  void shutdown(void);
+  void refreshViews(qint64 now);
+  void dispatchDueViews(qint64 now);
+  QosWorker* leastLoadedWorker(void) const;
+  void saveStatusSnapshot(void);
+  void publishViewStatuses(void);
+};
+
+#endif // QOSSCHEDULER_HPP
@@ -42,6 +42,18 @@ int WebBaseSettings::getLdapVersion(void) const
 }
 
 
+int WebBaseSettings::getLdapAuthCacheTtl(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_LDAP_AUTH_CACHE_TTL") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::AUTH_LDAP_CACHE_TTL);
+  }
+  bool ok = false;
+  int ttl = configValueStr.toInt(&ok);
+  return (ok && ttl >= 0) ? ttl : ngrt4n::DefaultLdapAuthCacheTtl;
+}
+
+
 int WebBaseSettings::getAuthenticationMode(void) const
 {
   int val = m_settingFactory->keyValue(SettingFactory::AUTH_MODE_KEY).toInt();
@@ -121,6 +133,95 @@ std::string WebBaseSettings::getDbPassword(void) const
   return m_settingFactory->keyValue(SettingFactory::DB_PASSWORD).toStdString();
 }
 
+int WebBaseSettings::getDbPoolSize(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_DB_POOL_SIZE") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::DB_POOL_SIZE);
+  }
+  int poolSize = configValueStr.toInt();
+  return (poolSize > 0) ? poolSize : ngrt4n::DefaultDbPoolSize;
+}
+
+
+int WebBaseSettings::getDbPoolWaitTimeout(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_DB_POOL_WAIT_TIMEOUT") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::DB_POOL_WAIT_TIMEOUT);
+  }
+  int waitTimeout = configValueStr.toInt();
+  return (waitTimeout > 0) ? waitTimeout : ngrt4n::DefaultDbPoolWaitTimeout;
+}
+
+int WebBaseSettings::getMaxLoadedDashboards(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_MAX_LOADED_VIEWS") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::DASHBOARD_MAX_LOADED_VIEWS);
+  }
+  int maxDashboards = configValueStr.toInt();
+  return (maxDashboards > 0) ? maxDashboards : ngrt4n::DefaultMaxLoadedDashboards;
+}
+
+bool WebBaseSettings::getQosCompression(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_QOS_COMPRESSION") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::REPORTING_QOS_COMPRESSION);
+  }
+  return configValueStr.toInt() != 0;
+}
+
+double WebBaseSettings::getQosEpsilon(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_QOS_EPSILON") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::REPORTING_QOS_EPSILON);
+  }
+  bool ok = false;
+  double epsilon = configValueStr.toDouble(&ok);
+  return (ok && epsilon >= 0) ? epsilon : ngrt4n::DefaultQosEpsilon;
+}
+
+int WebBaseSettings::getQosHeartbeat(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_QOS_HEARTBEAT") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::REPORTING_QOS_HEARTBEAT);
+  }
+  int heartbeat = configValueStr.toInt();
+  return (heartbeat > 0) ? heartbeat : ngrt4n::DefaultQosHeartbeat;
+}
+
+QString WebBaseSettings::getQosStoreDir(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_QOS_STORE_DIR") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::REPORTING_QOS_STORE_DIR);
+  }
+  return configValueStr;
+}
+
+QString WebBaseSettings::getStatusSnapshotPath(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_STATUS_SNAPSHOT") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::REPORTING_STATUS_SNAPSHOT);
+  }
+  return configValueStr.isEmpty() ? QString(ngrt4n::DefaultStatusSnapshotPath) : configValueStr;
+}
+
+bool WebBaseSettings::getSharedStatus(void) const
+{
+  QString configValueStr = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_SHARED_STATUS") );
+  if (configValueStr.isEmpty()) {
+    configValueStr = m_settingFactory->keyValue(SettingFactory::REPORTING_SHARED_STATUS);
+  }
+  // enabled unless explicitly turned off
+  return configValueStr.isEmpty() || (configValueStr != "0" && configValueStr.toLower() != "false");
+}
+
 std::string WebBaseSettings::getDbConnectionString(void) const
 {
   std::string connectionString = "";
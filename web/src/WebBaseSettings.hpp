@@ -53,6 +53,15 @@ public:
   std::string getDbUser(void) const;
   std::string getDbPassword(void) const;
   std::string getDbConnectionString(void) const;
+  int getDbPoolSize(void) const;
+  int getDbPoolWaitTimeout(void) const;
+  int getMaxLoadedDashboards(void) const;
+  bool getQosCompression(void) const;
+  double getQosEpsilon(void) const;
+  int getQosHeartbeat(void) const;
+  QString getQosStoreDir(void) const;
+  QString getStatusSnapshotPath(void) const;
+  bool getSharedStatus(void) const;
 
   std::string getLdapServerUri(void) const { return m_settingFactory->keyValue(SettingFactory::AUTH_LDAP_SERVER_URI).toStdString();}
   std::string getLdapBindUserDn(void) const { return m_settingFactory->keyValue(SettingFactory::AUTH_LDAP_BIND_USER_DN).toStdString();}
@@ -60,6 +69,7 @@ public:
   std::string getLdapBindUserPassword(void) const { return m_settingFactory->keyValue(SettingFactory::AUTH_LDAP_BIND_USER_PASSWORD).toStdString();}
   std::string getLdapIdField(void) const;
   int getLdapVersion(void) const;
+  int getLdapAuthCacheTtl(void) const;
   bool getLdapSslUseMyCert(void) const {return m_settingFactory->keyValue(SettingFactory::AUTH_LDAP_SSL_USE_CERT).toInt() == Wt::Checked;}
   std::string getLdapSslCertFile(void) const {return m_settingFactory->keyValue(SettingFactory::AUTH_LDAP_SSL_CERT_FILE).toStdString();}
   std::string getLdapSslCaFile(void) const {return m_settingFactory->keyValue(SettingFactory::AUTH_LDAP_SSL_CA_FILE).toStdString();}
@@ -32,7 +32,7 @@ WebBiDashlet::WebBiDashlet()
 {
   setLayout(m_layout = new Wt::WGridLayout());
   addEvent();
-
+  resetData();
 }
 
 WebBiDashlet::~WebBiDashlet()
@@ -86,18 +86,72 @@ Wt::WText* WebBiDashlet::createTitleWidget(const std::string& viewName)
 }
 
 
-void WebBiDashlet::updateChartsByViewName(const std::string& viewName, const QosDataListMapT& qosDataMap)
+long WebBiDashlet::nextFetchTime(void)
+{
+  if (m_fetchTracker.startTime() != startTime() || m_fetchTracker.endTime() != endTime()) {
+    resetData();
+    m_fetchTracker.setWindow(startTime(), endTime());
+  }
+  return m_fetchTracker.nextFetchTime(m_viewDashboardAliasNames.keys());
+}
+
+
+void WebBiDashlet::resetData(void)
+{
+  m_fetchTracker.clear();
+  m_slaData.clear();
+}
+
+
+std::set<std::string> WebBiDashlet::viewNames(void) const
+{
+  std::set<std::string> names;
+  for (const auto& name : m_viewDashboardAliasNames) {
+    names.insert(name);
+  }
+  return names;
+}
+
+
+void WebBiDashlet::appendData(const QosDataListMapT& qosDataMap, const QosDataMapT& lastQosData, long fetchEndTime)
 {
-  auto viewDashboardAliasName = m_viewDashboardAliasNames[viewName];
-  QosDataListMapT::ConstIterator iterQosDataSet = qosDataMap.find(viewDashboardAliasName);
-  if (iterQosDataSet ==  qosDataMap.end()) {
-    return; /** return if view not found **/
+  for (auto aliasItem = m_viewDashboardAliasNames.cbegin(); aliasItem != m_viewDashboardAliasNames.cend(); ++aliasItem) {
+    const std::string& viewName = aliasItem.key();
+    bool reload = ! m_fetchTracker.isLoaded(viewName);
+    long loadedTime = m_fetchTracker.loadedTime(viewName);
+    QosDataList freshEntries;
+    QosDataListMapT::ConstIterator iterQosDataSet = qosDataMap.find(aliasItem.value());
+    if (iterQosDataSet != qosDataMap.end()) {
+      freshEntries = m_fetchTracker.freshEntries(viewName, *iterQosDataSet);
+    }
+    m_fetchTracker.markFetched(viewName, freshEntries, fetchEndTime);
+    if (reload && freshEntries.empty()) {
+      continue;
+    }
+
+    // entries are only stored on change with compressed recording, the latest sample
+    // tells until when the last recorded status is known to hold
+    long endTime = freshEntries.empty() ? loadedTime : freshEntries.back().timestamp;
+    auto lastQosItem = lastQosData.find(aliasItem.value());
+    if (lastQosItem != lastQosData.end()) {
+      endTime = qMax(endTime, lastQosItem->timestamp);
+    }
+    if (m_fetchTracker.endTime() > 0) {
+      endTime = qMin(endTime, m_fetchTracker.endTime());
+    }
+
+    updateChartsByViewName(viewName, freshEntries, reload, endTime);
   }
+}
+
 
-  // process update since view found
+void WebBiDashlet::updateChartsByViewName(const std::string& viewName, const QosDataList& entries, bool reload, long endTime)
+{
   QMap<std::string, WebPieChart*>::iterator iterSlaPiechart = m_slaPieCharts.find(viewName);
   if (iterSlaPiechart != m_slaPieCharts.end()) {
-    WebBiSlaDataAggregator slaData(*iterQosDataSet);
+    WebBiSlaDataAggregator& slaData = m_slaData[viewName];
+    slaData.addData(entries);
+    slaData.setEndTime(endTime);
     (*iterSlaPiechart)->setSeverityData(slaData.normalDuration(),
                                         slaData.minorDuration(),
                                         slaData.majorDuration(),
@@ -108,14 +162,23 @@ void WebBiDashlet::updateChartsByViewName(const std::string& viewName, const Qos
 
   // update IT problem chart when applicable
   QMap<std::string, WebBiRawChart*>::iterator iterProblemTrendsChart = m_itProblemCharts.find(viewName);
-  if (iterProblemTrendsChart != m_itProblemCharts.end()) {
-    (*iterProblemTrendsChart)->updateData(*iterQosDataSet);
+  if (iterProblemTrendsChart != m_itProblemCharts.end() && ! entries.empty()) {
+    if (reload) {
+      (*iterProblemTrendsChart)->updateData(entries);
+    } else {
+      (*iterProblemTrendsChart)->appendData(entries);
+    }
   }
 
   // update QoS data for export
   QMap<std::string, WebCsvExportIcon*>::iterator iterCsvExportItem = m_csvExportLinks.find(viewName);
   if (iterCsvExportItem != m_csvExportLinks.end()) {
-    (*iterCsvExportItem)->updateData(viewName, *iterQosDataSet);
+    if (reload) {
+      (*iterCsvExportItem)->updateData(viewName, entries);
+    } else {
+      (*iterCsvExportItem)->appendData(entries);
+    }
+    (*iterCsvExportItem)->setEndTime(endTime);
   }
 }
 
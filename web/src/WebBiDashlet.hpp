@@ -26,6 +26,7 @@
 #define WEBBIDASHLET_HPP
 
 #include "WebBiSlaDataAggregator.hpp"
+#include "WebBiFetchTracker.hpp"
 #include "WebBiRawChart.hpp"
 #include "WebPieChart.hpp"
 #include "WebBiDateFilter.hpp"
@@ -44,9 +45,12 @@ public:
   WebBiDashlet();
   ~WebBiDashlet();
   void initialize(const DbViewsT& viewList);
-  void updateChartsByViewName (const std::string& viewName, const QosDataListMapT& qosDataMap);
   long startTime(void) {return m_filterHeader.epochStartTime();}
   long endTime(void) {return m_filterHeader.epochEndTime();}
+  long nextFetchTime(void);
+  void resetData(void);
+  void appendData(const QosDataListMapT& qosDataMap, const QosDataMapT& lastQosData, long fetchEndTime);
+  std::set<std::string> viewNames(void) const;
 
 public Q_SLOTS:
   void handleReportPeriodChanged(long start, long end) { Q_EMIT reportPeriodChanged(start, end);}
@@ -64,8 +68,13 @@ private:
   QMap<std::string, WebCsvExportIcon*> m_csvExportLinks;
   QMap<std::string, std::string> m_viewDashboardAliasNames;
 
+  /** Loaded report window, only entries newer than what is held are fetched on refresh */
+  WebBiFetchTracker m_fetchTracker;
+  QMap<std::string, WebBiSlaDataAggregator> m_slaData;
+
   void addEvent(void);
   Wt::WText* createTitleWidget(const std::string& viewName);
+  void updateChartsByViewName(const std::string& viewName, const QosDataList& entries, bool reload, long endTime);
 };
 
 #endif // WEBBIDASHLET_HPP
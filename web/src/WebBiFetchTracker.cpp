@@ -0,0 +1,93 @@
+/*
+ * WebBiFetchTracker.cpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@ngrt4n.com)   #
+# Creation: 18-10-2026                                                     #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#include "WebBiFetchTracker.hpp"
+
+
+WebBiFetchTracker::WebBiFetchTracker(void)
+{
+  clear();
+}
+
+
+void WebBiFetchTracker::clear(void)
+{
+  m_startTime = -1;
+  m_endTime = -1;
+  m_loadedTimes.clear();
+}
+
+
+void WebBiFetchTracker::setWindow(long startTime, long endTime)
+{
+  if (startTime != m_startTime || endTime != m_endTime) {
+    clear();
+    m_startTime = startTime;
+    m_endTime = endTime;
+  }
+}
+
+
+QosDataList WebBiFetchTracker::freshEntries(const std::string& viewName, const QosDataList& entries) const
+{
+  auto loadedTimeItem = m_loadedTimes.constFind(viewName);
+  if (loadedTimeItem == m_loadedTimes.cend()) {
+    return entries;
+  }
+  QosDataList result;
+  for (const auto& entry : entries) {
+    if (entry.timestamp > *loadedTimeItem) {
+      result.push_back(entry);
+    }
+  }
+  return result;
+}
+
+
+void WebBiFetchTracker::markFetched(const std::string& viewName, const QosDataList& fetchedEntries, long fetchEndTime)
+{
+  if (! fetchedEntries.empty()) {
+    m_loadedTimes[viewName] = fetchedEntries.back().timestamp;
+  } else if (! m_loadedTimes.contains(viewName)) {
+    // a view without entries yet is held as loaded until the end of the fetch, so that
+    // it doesn't make the next refreshes fetch the whole window again for all the views
+    m_loadedTimes.insert(viewName, fetchEndTime);
+  }
+}
+
+
+long WebBiFetchTracker::nextFetchTime(const QList<std::string>& viewNames) const
+{
+  // rows are filtered per view, so the fetch restarts from the view lagging the most behind;
+  // the entries a view already holds are skipped when appending
+  long fetchTime = -1;
+  for (const auto& viewName : viewNames) {
+    auto loadedTimeItem = m_loadedTimes.constFind(viewName);
+    if (loadedTimeItem == m_loadedTimes.cend()) {
+      return m_startTime;
+    }
+    fetchTime = (fetchTime < 0) ? *loadedTimeItem : qMin(fetchTime, *loadedTimeItem);
+  }
+  return (fetchTime >= 0) ? fetchTime : m_startTime;
+}
@@ -0,0 +1,56 @@
+/*
+ * WebBiFetchTracker.hpp
+# ------------------------------------------------------------------------ #
+# Copyright (c) 2010-2015 Rodrigue Chakode (rodrigue.chakode@ngrt4n.com)   #
+# Creation: 18-10-2026                                                     #
+#                                                                          #
+# This file is part of RealOpInsight (http://RealOpInsight.com) authored   #
+# by Rodrigue Chakode <rodrigue.chakode@gmail.com>                         #
+#                                                                          #
+# RealOpInsight is free software: you can redistribute it and/or modify    #
+# it under the terms of the GNU General Public License as published by     #
+# the Free Software Foundation, either version 3 of the License, or        #
+# (at your option) any later version.                                      #
+#                                                                          #
+# The Software is distributed in the hope that it will be useful,          #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+# GNU General Public License for more details.                             #
+#                                                                          #
+# You should have received a copy of the GNU General Public License        #
+# along with RealOpInsight.  If not, see <http://www.gnu.org/licenses/>.   #
+#--------------------------------------------------------------------------#
+ */
+
+#ifndef WEBBIFETCHTRACKER_HPP
+#define WEBBIFETCHTRACKER_HPP
+
+#include "dbo/src/DbObjects.hpp"
+#include <QList>
+#include <QMap>
+
+/**
+ * Tracks the report window loaded by the BI dashlet and, for each view, the time until which its
+ * QoS entries are held, so that a refresh only fetches the entries recorded in the meantime.
+ */
+class WebBiFetchTracker
+{
+public:
+  WebBiFetchTracker(void);
+  void clear(void);
+  void setWindow(long startTime, long endTime);
+  long startTime(void) const {return m_startTime;}
+  long endTime(void) const {return m_endTime;}
+  bool isLoaded(const std::string& viewName) const {return m_loadedTimes.contains(viewName);}
+  long loadedTime(const std::string& viewName) const {return m_loadedTimes.value(viewName, -1);}
+  QosDataList freshEntries(const std::string& viewName, const QosDataList& entries) const;
+  void markFetched(const std::string& viewName, const QosDataList& fetchedEntries, long fetchEndTime);
+  long nextFetchTime(const QList<std::string>& viewNames) const;
+
+private:
+  long m_startTime;
+  long m_endTime;
+  QMap<std::string, long> m_loadedTimes;
+};
+
+#endif // WEBBIFETCHTRACKER_HPP
@@ -60,30 +60,7 @@ void WebBiRawChart::updateData(const QosDataList& data)
 
   int row = 0;
   for (const auto& entry : data) {
-    Wt::WDateTime date;
-    date.setTime_t(entry.timestamp);
-
-    model->setData(row, 0, date);
-    model->setData(row, 1, entry.status);
-
-    float sev = entry.normal;
-    model->setData(row, 2, sev);
-
-    sev += entry.minor;
-    model->setData(row, 3, sev);
-
-    sev += entry.major;
-    model->setData(row, 4, sev);
-
-    sev += entry.critical;
-    model->setData(row, 5, sev);
-
-    sev += entry.unknown;
-    model->setData(row, 6, sev);
-
-    // placeholders
-    model->setData(row, 7, 0.0);
-    model->setData(row, 8, 100.0);
+    setRowData(model, row, entry);
     ++row;
   }
 
@@ -116,6 +93,51 @@ void WebBiRawChart::updateData(const QosDataList& data)
 }
 
 
+void WebBiRawChart::appendData(const QosDataList& data)
+{
+  if (! m_dataModel) {
+    updateData(data);
+    return;
+  }
+
+  int row = m_dataModel->rowCount();
+  m_dataModel->insertRows(row, static_cast<int>(data.size()));
+  for (const auto& entry : data) {
+    setRowData(m_dataModel, row, entry);
+    ++row;
+  }
+}
+
+
+void WebBiRawChart::setRowData(Wt::WStandardItemModel* model, int row, const QosDataT& entry)
+{
+  Wt::WDateTime date;
+  date.setTime_t(entry.timestamp);
+
+  model->setData(row, 0, date);
+  model->setData(row, 1, entry.status);
+
+  float sev = entry.normal;
+  model->setData(row, 2, sev);
+
+  sev += entry.minor;
+  model->setData(row, 3, sev);
+
+  sev += entry.major;
+  model->setData(row, 4, sev);
+
+  sev += entry.critical;
+  model->setData(row, 5, sev);
+
+  sev += entry.unknown;
+  model->setData(row, 6, sev);
+
+  // placeholders
+  model->setData(row, 7, 0.0);
+  model->setData(row, 8, 100.0);
+}
+
+
 void WebBiRawChart::resetDataModel(Wt::WStandardItemModel* model)
 {
   setModel(model);
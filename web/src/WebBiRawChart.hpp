@@ -35,6 +35,7 @@ public:
   void setViewName(const std::string& viewName) {m_viewName = viewName;}
   std::string viewName() const {return m_viewName;}
   void updateData(const QosDataList& data);
+  void appendData(const QosDataList& data);
 
 
 private:
@@ -42,6 +43,7 @@ private:
   Wt::WStandardItemModel* m_dataModel;
 
   void setChartTitle(void);
+  void setRowData(Wt::WStandardItemModel* model, int row, const QosDataT& entry);
   void resetDataModel(Wt::WStandardItemModel* model);
 };
 
@@ -29,53 +29,68 @@
 #include <Wt/WRectArea>
 
 
-WebBiSlaDataAggregator::WebBiSlaDataAggregator(const std::list<QosDataT>& data)
-  : m_normalDuration(0),
-    m_minorDuration(0),
-    m_majorDuration(0),
-    m_criticalDuration(0),
-    m_unknownDuration(0)
+WebBiSlaDataAggregator::WebBiSlaDataAggregator(void)
 {
-  processData(data);
+  clear();
 }
 
-void WebBiSlaDataAggregator::processData(const QosDataList& data)
+WebBiSlaDataAggregator::WebBiSlaDataAggregator(const QosDataList& data)
 {
-  QosDataList::const_iterator iterData = data.begin();
-  m_plottingData.clear();
+  clear();
+  addData(data);
+}
+
+void WebBiSlaDataAggregator::clear(void)
+{
+  m_hasData = false;
+  m_first = m_last = {0, ngrt4n::Unknown};
   m_normalDuration   = 0;
   m_minorDuration    = 0;
   m_majorDuration    = 0;
   m_criticalDuration = 0;
   m_unknownDuration  = 0;
   m_totalDuration    = 1;
+  m_endTime          = 0;
+}
+
+/**
+ * Extends the running durations with entries newer than the ones already aggregated,
+ * so that a refresh only costs the new entries.
+ */
+void WebBiSlaDataAggregator::addData(const QosDataList& data)
+{
+  QosDataList::const_iterator iterData = data.begin();
+  if (iterData == data.end()) {
+    return;
+  }
+
+  if (! m_hasData) {
+    m_first = m_last = {iterData->timestamp, iterData->status};
+    m_hasData = true;
+    ++iterData;
+  }
 
-  if (! data.empty()) {
-    TimeStatusT last = {iterData->timestamp, iterData->status};
-    m_plottingData.push_back(last);
-    while (++iterData, iterData != data.end()) {
-      TimeStatusT current = {iterData->timestamp, iterData->status};
-      m_plottingData.push_back(current);
-      switch(last.status) {
-        case ngrt4n::Normal:
-          m_normalDuration += current.timestamp - last.timestamp;
-          break;
-        case ngrt4n::Minor:
-          m_minorDuration += current.timestamp - last.timestamp;
-          break;
-        case ngrt4n::Major:
-          m_majorDuration += current.timestamp - last.timestamp;
-          break;
-        case ngrt4n::Critical:
-          m_criticalDuration += current.timestamp - last.timestamp;
-          break;
-        case ngrt4n::Unknown:
-          m_unknownDuration += current.timestamp - last.timestamp;
-        default:
-          break;
-      }
-      last = m_plottingData.back();
+  for (; iterData != data.end(); ++iterData) {
+    TimeStatusT current = {iterData->timestamp, iterData->status};
+    switch(m_last.status) {
+      case ngrt4n::Normal:
+        m_normalDuration += current.timestamp - m_last.timestamp;
+        break;
+      case ngrt4n::Minor:
+        m_minorDuration += current.timestamp - m_last.timestamp;
+        break;
+      case ngrt4n::Major:
+        m_majorDuration += current.timestamp - m_last.timestamp;
+        break;
+      case ngrt4n::Critical:
+        m_criticalDuration += current.timestamp - m_last.timestamp;
+        break;
+      case ngrt4n::Unknown:
+        m_unknownDuration += current.timestamp - m_last.timestamp;
+      default:
+        break;
     }
-    m_totalDuration = (m_plottingData.back().timestamp - m_plottingData.front().timestamp);
+    m_last = current;
   }
+  m_totalDuration = (m_last.timestamp - m_first.timestamp);
 }
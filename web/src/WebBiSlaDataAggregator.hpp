@@ -30,14 +30,18 @@
 class WebBiSlaDataAggregator
 {
 public:
+  WebBiSlaDataAggregator(void);
   WebBiSlaDataAggregator(const QosDataList& data);
+  void clear(void);
+  void addData(const QosDataList& data);
+  void setEndTime(long endTime) {m_endTime = endTime;}
 
-  double normalDuration(void) const {return m_normalDuration;}
-  double minorDuration(void) const {return m_minorDuration;}
-  double majorDuration(void) const {return m_majorDuration;}
-  double criticalDuration(void) const {return m_criticalDuration;}
-  double unknownDuration(void) const {return m_unknownDuration;}
-  double totalDuration(void) const {return m_totalDuration;}
+  double normalDuration(void) const {return m_normalDuration + tailDuration(ngrt4n::Normal);}
+  double minorDuration(void) const {return m_minorDuration + tailDuration(ngrt4n::Minor);}
+  double majorDuration(void) const {return m_majorDuration + tailDuration(ngrt4n::Major);}
+  double criticalDuration(void) const {return m_criticalDuration + tailDuration(ngrt4n::Critical);}
+  double unknownDuration(void) const {return m_unknownDuration + tailDuration(ngrt4n::Unknown);}
+  double totalDuration(void) const {return m_totalDuration + tailDuration(m_last.status);}
 
 
 private:
@@ -45,16 +49,21 @@ private:
     long timestamp;
     int status;
   };
-  typedef QList<TimeStatusT> TimeStatusesT;
-  TimeStatusesT m_plottingData;
+  bool m_hasData;
+  TimeStatusT m_first;
+  TimeStatusT m_last;
   long m_normalDuration;
   long m_minorDuration;
   long m_majorDuration;
   long m_criticalDuration;
   long m_unknownDuration;
   long m_totalDuration;
+  long m_endTime;
 
-  void processData(const QosDataList& data);
+  /** the last status holds until the end time, entries are only stored on change with compressed recording */
+  long tailDuration(int status) const {
+    return (m_hasData && m_last.status == status && m_endTime > m_last.timestamp) ? m_endTime - m_last.timestamp : 0;
+  }
 };
 
 #endif // WEBBISLACHART_HPP
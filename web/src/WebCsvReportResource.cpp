@@ -6,7 +6,8 @@
 
 
 WebCsvExportResource::WebCsvExportResource(void)
-  : Wt::WResource()
+  : Wt::WResource(),
+    m_endTime(0)
 {
   m_qosData.clear();
 }
@@ -31,12 +32,24 @@ void WebCsvExportResource::updateData(const std::string& viewName, const QosData
 }
 
 
+void WebCsvExportResource::appendData(const QosDataList& qosData)
+{
+  m_qosData.insert(m_qosData.end(), qosData.begin(), qosData.end());
+}
+
+
 void WebCsvExportResource::handleRequest(const Wt::Http::Request&, Wt::Http::Response& response)
 {
   setExportFileName();
   response.setMimeType("text/csv");
-  response.out() << "Timestamp,View Name,Status,Normal (%),Minor (%),Major (%),Critical (%),Unknown (%)\n";
-  for (const auto& entry: m_qosData) response.out() << entry.toString() << std::endl;
+  response.out() << "Timestamp,View Name,Status,Normal (%),Minor (%),Major (%),Critical (%),Unknown (%),Duration (s)\n";
+
+  // each entry holds until the next one, entries are only stored on change with compressed recording
+  for (auto entry = m_qosData.cbegin(); entry != m_qosData.cend(); ++entry) {
+    auto next = entry + 1;
+    long until = (next != m_qosData.cend()) ? next->timestamp : qMax(m_endTime, entry->timestamp);
+    response.out() << entry->toString() << "," << (until - entry->timestamp) << std::endl;
+  }
 }
 
 
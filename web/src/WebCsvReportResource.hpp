@@ -11,6 +11,8 @@ public:
   WebCsvExportResource(void);
   ~WebCsvExportResource(){ beingDeleted(); }
   void updateData(const std::string& viewName, const QosDataList& qosData);
+  void appendData(const QosDataList& qosData);
+  void setEndTime(long endTime) {m_endTime = endTime;}
   void setExportFileName(void);
 
   virtual void handleRequest(const Wt::Http::Request&, Wt::Http::Response& response);
@@ -19,6 +21,7 @@ public:
 private:
   QosDataList m_qosData;
   std::string m_viewName;
+  long m_endTime;
 };
 
 
@@ -28,6 +31,8 @@ class WebCsvExportIcon : public Wt::WAnchor
 public:
   WebCsvExportIcon(void);
   void updateData(const std::string& viewName, const QosDataList& qosData);
+  void appendData(const QosDataList& qosData) {m_csvResource.appendData(qosData);}
+  void setEndTime(long endTime) {m_csvResource.setEndTime(endTime);}
 
 private:
   WebCsvExportResource m_csvResource;
@@ -24,7 +24,7 @@
 #include "dbo/src/DbSession.hpp"
 #include "utilsCore.hpp"
 #include "WebUtils.hpp"
-#include "K8sHelper.hpp"
+#include "SourceCollector.hpp"
 #include "WebDataSourceSettings.hpp"
 #include <Wt/WSpinBox>
 #include <Wt/WApplication>
@@ -180,13 +180,12 @@ void WebDataSourceSettings::applyChangesGivenSourceId(int index)
   SourceT sinfo = extractSourceSettingsGivenIndex(index);
   QHash<QString, bool> monitoredGroups;
   if (sinfo.mon_type == MonitorT::Kubernetes) {
-    K8sHelper k8sHelper(sinfo.mon_url, sinfo.verify_ssl_peer);
-    auto outListNamespaces = k8sHelper.listNamespaces();
-    if (outListNamespaces.second != ngrt4n::RcSuccess) {
-      m_operationCompleted.emit(ngrt4n::OperationFailed, QObject::tr("failed connecting to source (%1)").arg(outListNamespaces.first.at(0)).toStdString());
+    auto outListNamespaces = SourceCollector::shared().listNamespaces(sinfo).get();
+    if (outListNamespaces.rc != ngrt4n::RcSuccess) {
+      m_operationCompleted.emit(ngrt4n::OperationFailed, QObject::tr("failed connecting to source (%1)").arg(outListNamespaces.error).toStdString());
       return ;
     }
-    for (const auto& mgroup: outListNamespaces.first) {
+    for (const auto& mgroup: outListNamespaces.namespaces) {
       monitoredGroups[mgroup] = true;
     }
   } else {
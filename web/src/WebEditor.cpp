@@ -29,8 +29,7 @@
 #include "Parser.hpp"
 #include "WebBaseSettings.hpp"
 #include "WebInputSelector.hpp"
-#include "ZbxHelper.hpp"
-#include "K8sHelper.hpp"
+#include "SourceCollector.hpp"
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -1187,14 +1186,13 @@ void WebEditor::importZabbixITServices(const std::string& srcId)
     return;
   }
 
-  CoreDataT cdata;
-
   auto allZbxSources = m_dbSession->listSources(MonitorT::Zabbix);
-  auto outLoadItServices = ZbxHelper().loadITServices(allZbxSources[srcId.c_str()], cdata);
-  if (outLoadItServices.first != ngrt4n::RcSuccess) {
-    m_operationCompleted.emit(ngrt4n::OperationFailed, QObject::tr("Importation failed: %1").arg(outLoadItServices.second).toStdString());
+  auto outLoadItServices = SourceCollector::shared().loadITServices(allZbxSources[srcId.c_str()]).get();
+  if (outLoadItServices.rc != ngrt4n::RcSuccess) {
+    m_operationCompleted.emit(ngrt4n::OperationFailed, QObject::tr("Importation failed: %1").arg(outLoadItServices.error).toStdString());
     return ;
   }
+  CoreDataT cdata = outLoadItServices.cdata;
 
   m_currentFilePath.clear();
 
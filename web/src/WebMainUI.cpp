@@ -42,6 +42,8 @@
 #include <Wt/WTemplate>
 #include <Wt/WHBoxLayout>
 #include <Wt/WEvent>
+#include <QFileInfo>
+#include <ctime>
 
 #define RESIZE_PANES \
   "var top = $(\"#ngrt4n-content-pane\").offset().top;" \
@@ -49,6 +51,10 @@
   "$(\"#ngrt4n-content-pane\").height(windowHeight - top);" \
   "$(\"#ngrt4n-side-pane\").height(windowHeight - top);"
 
+namespace {
+  const int DeferredRefreshDelay = 100; // in milliseconds, lets the restored dashboard show up first
+}
+
 
 WebMainUI::WebMainUI(AuthManager* authManager)
   : Wt::WContainerWidget(),
@@ -58,6 +64,7 @@ WebMainUI::WebMainUI(AuthManager* authManager)
     m_authManager(authManager),
     m_dbSession(m_authManager->session()),
     m_currentDashboard(nullptr),
+    m_maxLoadedDashboards(m_settings.getMaxLoadedDashboards()),
     m_fileUploader(nullptr),
     m_thumbsLayout(nullptr),
     m_notificationManager(nullptr),
@@ -138,8 +145,8 @@ void WebMainUI::unbindWidgets(void)
 void WebMainUI::unbindExecutiveViewWidgets(void)
 {
   for (ThumbnailMapT::Iterator thumb = m_thumbsWidgets.begin(); thumb != m_thumbsWidgets.end(); ++thumb) {
-    clearThumbnailTemplate(*thumb);
-    m_thumbsLayout->removeWidget(*thumb);
+    clearThumbnailTemplate(thumb->widget);
+    m_thumbsLayout->removeWidget(thumb->widget);
   }
 
   if (m_thumbsLayout && m_thumbsLayout->children().size() > 0) {
@@ -406,20 +413,56 @@ void WebMainUI::handleRefresh(void)
     m_notificationManager->clearAllServicesData();
   }
 
-  QosDataListMapT qosDataMap;
-  m_dbSession->listQosData(qosDataMap,"" /* empty view name means all views */, m_biDashlet.startTime(), m_biDashlet.endTime());
-  int currentView = 1;
-  for (auto& dashboard : m_dashboardMap) {
-    dashboard->setDbSession(m_dbSession);
-    auto loadDsOut = dashboard->loadDataSources();
-    if (loadDsOut.first != ngrt4n::RcSuccess) {
-      CORE_LOG("error", loadDsOut.second.toStdString());
+  // views without a loaded dashboard are summarized from the last QoS snapshot recorded by reportd
+  std::set<std::string> summarizedViews;
+  for (ThumbnailMapT::ConstIterator thumb = m_thumbsWidgets.cbegin(); thumb != m_thumbsWidgets.cend(); ++thumb) {
+    if (! m_dashboardMap.contains(thumb.key().c_str())) {
+      summarizedViews.insert(thumb.key());
+    }
+  }
+  QosDataMapT lastQosData;
+  if (! summarizedViews.empty()) {
+    m_dbSession->listLastQosData(lastQosData, summarizedViews);
+  }
+
+  QList<NodeT> rootNodes;
+  for (auto dashboardItem = m_dashboardMap.begin(); dashboardItem != m_dashboardMap.end(); ++dashboardItem) {
+    WebDashboard* dashboard = *dashboardItem;
+    NodeT currentRootNode = refreshDashboard(dashboard);
+    if (currentRootNode.id.isEmpty()) {
       continue;
     }
-    dashboard->updateAllNodesStatus();
-    dashboard->updateMap();
-    dashboard->updateThumbnailInfo();
-    NodeT currentRootNode = dashboard->rootNode();
+    ThumbnailMapT::Iterator thumbnailItem = m_thumbsWidgets.find(dashboardItem.key().toStdString());
+    if (thumbnailItem != m_thumbsWidgets.end()) {
+      thumbnailItem->widget->setStyleClass(dashboard->thumbnailCssClass());
+      thumbnailItem->widget->setToolTip(dashboard->tooltip());
+      thumbnailItem->problemDetailsBar->setText(dashboard->thumbnailProblemDetailBar()->text());
+    }
+    rootNodes.push_back(currentRootNode);
+  }
+
+  for (const auto& viewName : summarizedViews) {
+    NodeT summaryNode;
+    summaryNode.name = viewName.c_str();
+    summaryNode.sev = ngrt4n::Unknown;
+    std::string problemDetails = Q_TR("No data available yet");
+    auto lastQosDataIter = lastQosData.find(viewName);
+    if (lastQosDataIter != lastQosData.end()) {
+      summaryNode.sev = lastQosDataIter->status;
+      float problemRatio = lastQosDataIter->minor + lastQosDataIter->major + lastQosDataIter->critical + lastQosDataIter->unknown;
+      problemDetails = QObject::tr("%1% normal - %2% in problem")
+                       .arg(QString::number(static_cast<double>(lastQosDataIter->normal), 'f', 0))
+                       .arg(QString::number(static_cast<double>(problemRatio), 'f', 0))
+                       .toStdString();
+    }
+    ViewThumbnailT& thumbnail = m_thumbsWidgets[viewName];
+    thumbnail.widget->setStyleClass(ngrt4n::thumbnailCssClass(summaryNode.sev));
+    thumbnail.widget->setToolTip(problemDetails);
+    thumbnail.problemDetailsBar->setText(problemDetails);
+    rootNodes.push_back(summaryNode);
+  }
+
+  for (const auto& currentRootNode : rootNodes) {
     int platformSeverity = qMin(currentRootNode.sev, static_cast<int>(ngrt4n::Unknown));
     if (platformSeverity != ngrt4n::Normal) {
       ++problemTypeCount[platformSeverity];
@@ -427,16 +470,10 @@ void WebMainUI::handleRefresh(void)
         m_notificationManager->updateServiceData(currentRootNode);
       }
     }
-    std::string viewName = currentRootNode.name.toStdString();
-    ThumbnailMapT::Iterator thumbnailItem = m_thumbsWidgets.find(viewName);
-    if (thumbnailItem != m_thumbsWidgets.end()) {
-      (*thumbnailItem)->setStyleClass(dashboard->thumbnailCssClass());
-      (*thumbnailItem)->setToolTip(dashboard->tooltip());
-      if (m_dbSession->isCompleteUserDashboard()) {
-        m_biDashlet.updateChartsByViewName(viewName, qosDataMap);
-      }
-    }
-    ++currentView;
+  }
+
+  if (m_dbSession->isCompleteUserDashboard() && ! m_thumbsWidgets.isEmpty()) {
+    updateBiCharts();
   }
 
   // Display notifications only on operator console
@@ -530,17 +567,38 @@ void WebMainUI::handleChangePassword(const std::string& login, const std::string
 
 void WebMainUI::handleReportPeriodChanged(long start, long end)
 {
-  QosDataListMapT qosDataMap;
-  m_dbSession->listQosData(qosDataMap, "" /** empty view name means all views **/, start, end);
-  for (const auto& viewName : qosDataMap.keys()) {
-    m_biDashlet.updateChartsByViewName(viewName, qosDataMap);
-  }
+  m_biDashlet.resetData();
+  updateBiCharts();
   showMessage(ngrt4n::OperationSucceeded, Q_TR("Reports updated: ")
               .append(ngrt4n::wHumanTimeText(start).toUTF8())
               .append(" - ")
               .append(ngrt4n::wHumanTimeText(end).toUTF8()));
 }
 
+void WebMainUI::updateBiCharts(void)
+{
+  long fetchTime = m_biDashlet.nextFetchTime();
+  long fetchEndTime = qMin(m_biDashlet.endTime(), static_cast<long>(time(nullptr)));
+  QosDataListMapT qosDataMap;
+  m_dbSession->listQosData(qosDataMap, "" /** empty view name means all views **/, fetchTime, m_biDashlet.endTime());
+
+  // entries are only stored on change with compressed recording, so the status at the start
+  // of the window is given by the last entry recorded before it
+  if (fetchTime == m_biDashlet.startTime()) {
+    QosDataMapT precedingEntries;
+    m_dbSession->listPrecedingQosData(precedingEntries, m_biDashlet.viewNames(), fetchTime);
+    for (auto entry = precedingEntries.begin(); entry != precedingEntries.end(); ++entry) {
+      entry->timestamp = fetchTime;
+      QosDataList& viewEntries = qosDataMap[entry.key()];
+      viewEntries.insert(viewEntries.begin(), *entry);
+    }
+  }
+
+  QosDataMapT lastQosData;
+  m_dbSession->listLastQosData(lastQosData, m_biDashlet.viewNames());
+  m_biDashlet.appendData(qosDataMap, lastQosData, fetchEndTime);
+}
+
 void WebMainUI::handleDataSourceSettings(void)
 {
   m_adminPanelTitle.setText(Q_TR("Monitoring Sources"));
@@ -551,10 +609,12 @@ void WebMainUI::handleDataSourceSettings(void)
 
 void WebMainUI::handleNewViewSelected(void)
 {
-  std::string selectedEntry = m_selectViewBox->currentText().toUTF8();
-  auto dashboardIter = m_dashboardMap.find(selectedEntry.c_str());
-  if (dashboardIter != m_dashboardMap.end()) {
-    setDashboardAsFrontStackedWidget(*dashboardIter);
+  WebDashboard* dashboard = nullptr;
+  if (m_selectViewBox->currentIndex() > 0) {
+    dashboard = openDashboard(m_selectViewBox->currentText().toUTF8());
+  }
+  if (dashboard) {
+    setDashboardAsFrontStackedWidget(dashboard);
     m_showOnlyProblemMsgsField->setHidden(false);
   } else {
     m_currentDashboard = nullptr;
@@ -649,7 +709,7 @@ void WebMainUI::setupUploadForm(void)
 
 
 std::pair<WebDashboard*, QString>
-WebMainUI::loadView(const std::string& path)
+WebMainUI::loadView(const std::string& path, const QString& viewName)
 {
   if (path.empty()) {
     return {nullptr, QObject::tr("Cannot open empty path")};
@@ -668,24 +728,43 @@ WebMainUI::loadView(const std::string& path)
       return {nullptr, outInitDashboard.second};
     }
 
-    QString viewName = dashboard->rootNode().name;
-    auto loadedDashboardItem = m_dashboardMap.find(viewName);
-    if (loadedDashboardItem != m_dashboardMap.end()) {
-      // cleanup the existing dashboard before to reload it later
-      m_dashboardStackedContents.removeWidget(*loadedDashboardItem);
-      m_dashboardMap.remove(viewName);
-      delete *loadedDashboardItem;
+    // show the last status collected by reportd until the sources are polled
+    fetchViewStatus(dashboard);
+    if (dashboard->applyStatusSnapshot()) {
+      dashboard->updateMap();
+      dashboard->updateThumbnailInfo();
     }
 
-    m_dashboardMap.insert(viewName, dashboard);
+    // the dashboards are keyed like the thumbnails, by the name of the view in the database,
+    // which may differ from the name of the root service of the description file
+    QString dashboardName = viewName.isEmpty() ? dashboard->rootNode().name : viewName;
+
+    // cleanup the existing dashboard before to reload it later
+    unloadDashboard(dashboardName);
+
+    m_dashboardMap.insert(dashboardName, dashboard);
     m_dashboardStackedContents.addWidget(dashboard);
-    m_selectViewBox->addItem(viewName.toStdString());
+    if (m_selectViewBox->findText(dashboardName.toStdString()) < 0) {
+      m_selectViewBox->addItem(dashboardName.toStdString());
+    }
 
     // the inner layout is explicitely removed when the object is destroyed
     if (m_eventFeedLayout) {
       m_eventFeedLayout->addItem(dashboard->eventFeedLayout());
     }
 
+    ThumbnailMapT::Iterator thumbnailItem = m_thumbsWidgets.find(dashboardName.toStdString());
+    if (thumbnailItem != m_thumbsWidgets.end()) {
+      std::string selectedName = dashboardName.toStdString();
+      QObject::connect(dashboard, &WebDashboard::dashboardSelected, this, [this, selectedName](std::string) {
+        handleDashboardSelected(selectedName);
+      });
+      thumbnailItem->widget->bindWidget("thumb-image", dashboard->thumbnail());
+    }
+
+    touchDashboard(dashboardName);
+    evictDashboards();
+
   } catch (const std::bad_alloc&) {
     std::string errorMsg = tr("Dashboard initialization failed with bad_alloc").toStdString();
     CORE_LOG("error", errorMsg);
@@ -695,6 +774,147 @@ WebMainUI::loadView(const std::string& path)
   return {dashboard, ""};
 }
 
+WebDashboard* WebMainUI::openDashboard(const std::string& viewName)
+{
+  auto loadedDashboardItem = m_dashboardMap.find(viewName.c_str());
+  if (loadedDashboardItem != m_dashboardMap.end()) {
+    touchDashboard(viewName.c_str());
+    return *loadedDashboardItem;
+  }
+
+  std::string path;
+  ThumbnailMapT::ConstIterator thumbnailItem = m_thumbsWidgets.constFind(viewName);
+  if (thumbnailItem != m_thumbsWidgets.cend()) {
+    path = thumbnailItem->path;
+  } else {
+    DboView view;
+    if (! m_dbSession->findView(viewName, view)) {
+      return nullptr;
+    }
+    path = view.path;
+  }
+
+  CORE_LOG("info", QObject::tr("loading dashboard on demand: %1").arg(viewName.c_str()).toStdString());
+  auto loadViewOut = loadView(path, viewName.c_str());
+  if (! loadViewOut.first) {
+    CORE_LOG("error", QObject::tr("%1: %2").arg(viewName.c_str(), loadViewOut.second).toStdString());
+    showMessage(ngrt4n::OperationFailed, loadViewOut.second.toStdString());
+    return nullptr;
+  }
+
+  // a dashboard restored from the status snapshot is rendered first and polled right after,
+  // otherwise it is filled right away instead of waiting for the next console update
+  if (StatusSnapshot::shared().contains(loadViewOut.first->rootNode().name)) {
+    scheduleDashboardRefresh(viewName.c_str());
+  } else {
+    refreshDashboard(loadViewOut.first);
+  }
+
+  return loadViewOut.first;
+}
+
+
+void WebMainUI::touchDashboard(const QString& viewName)
+{
+  m_dashboardLru.removeOne(viewName);
+  m_dashboardLru.prepend(viewName);
+}
+
+
+void WebMainUI::evictDashboards(void)
+{
+  for (int index = m_dashboardLru.size() - 1; index >= 0 && m_dashboardMap.size() > m_maxLoadedDashboards; --index) {
+    const QString viewName = m_dashboardLru.at(index);
+    auto loadedDashboardItem = m_dashboardMap.find(viewName);
+    if (loadedDashboardItem != m_dashboardMap.end() && *loadedDashboardItem == m_currentDashboard) {
+      continue;
+    }
+    CORE_LOG("debug", QObject::tr("evicting least recently used dashboard: %1").arg(viewName).toStdString());
+    unloadDashboard(viewName);
+  }
+}
+
+
+void WebMainUI::unloadDashboard(const QString& viewName)
+{
+  m_dashboardLru.removeOne(viewName);
+  auto loadedDashboardItem = m_dashboardMap.find(viewName);
+  if (loadedDashboardItem == m_dashboardMap.end()) {
+    return;
+  }
+
+  WebDashboard* dashboard = *loadedDashboardItem;
+  ThumbnailMapT::Iterator thumbnailItem = m_thumbsWidgets.find(viewName.toStdString());
+  if (thumbnailItem != m_thumbsWidgets.end()) {
+    // the thumbnail image belongs to the dashboard
+    thumbnailItem->widget->takeWidget("thumb-image");
+    thumbnailItem->widget->bindEmpty("thumb-image");
+  }
+  if (m_eventFeedLayout) {
+    m_eventFeedLayout->removeItem(dashboard->eventFeedLayout());
+  }
+  if (m_currentDashboard == dashboard) {
+    m_currentDashboard = nullptr;
+  }
+  m_dashboardStackedContents.removeWidget(dashboard);
+  m_dashboardMap.erase(loadedDashboardItem);
+  delete dashboard;
+}
+
+
+NodeT WebMainUI::refreshDashboard(WebDashboard* dashboard)
+{
+  dashboard->setDbSession(m_dbSession);
+  if (! applySharedStatus(dashboard)) {
+    auto loadDsOut = dashboard->loadDataSources();
+    if (loadDsOut.first != ngrt4n::RcSuccess) {
+      CORE_LOG("error", loadDsOut.second.toStdString());
+      return NodeT();
+    }
+    dashboard->updateAllNodesStatus();
+  }
+  dashboard->updateMap();
+  dashboard->updateThumbnailInfo();
+  return dashboard->rootNode();
+}
+
+bool WebMainUI::applySharedStatus(WebDashboard* dashboard)
+{
+  if (! m_settings.getSharedStatus()) {
+    return false;
+  }
+
+  // the status published by reportd is used as long as it's not older than its collection period,
+  // so that the monitors are polled once by reportd rather than once per session
+  if (! fetchViewStatus(dashboard)) {
+    return false;
+  }
+  return dashboard->updateFromStatusSnapshot(m_settings.updateInterval(), ngrt4n::SharedStatusGrace);
+}
+
+/** takes the status of the view published by reportd in the database, whatever its host */
+bool WebMainUI::fetchViewStatus(WebDashboard* dashboard)
+{
+  ViewStatusRecordListT dbRecords;
+  if (m_dbSession->listViewStatuses(dbRecords, {dashboard->rootNode().name.toStdString()}) < 0) {
+    return false;
+  }
+
+  StatusSnapshot::RecordMapT records;
+  for (const auto& dbRecord : dbRecords) {
+    StatusSnapshot::RecordT record;
+    record.timestamp = dbRecord.timestamp;
+    record.content = QByteArray(reinterpret_cast<const char*>(dbRecord.record.data()), static_cast<int>(dbRecord.record.size()));
+    records.insert(QString::fromStdString(dbRecord.view_name), record);
+  }
+  auto mergeOut = StatusSnapshot::shared().mergeRecords(records);
+  if (mergeOut.first != ngrt4n::RcSuccess) {
+    CORE_LOG("error", mergeOut.second.toStdString());
+    return false;
+  }
+  return true;
+}
+
 void WebMainUI::scaleMap(double factor)
 {
   if (m_currentDashboard) {
@@ -969,28 +1189,27 @@ void WebMainUI::initOperatorDashboard(void)
     return ;
   }
 
-  // Generate view thumbnails
+  // Generate view thumbnails, dashboards are only loaded once opened
   int thumbIndex = 0;
   int thumbPerRow = m_dbSession->dashboardTilesPerRow();
   std::string failedViews = "";
   for (const auto& view : userViews) {
-    auto loadViewOut = loadView(view.path);
-    if (! loadViewOut.first) {
-      CORE_LOG("error", tr("%1: %2").arg(QString(view.name.c_str()), loadViewOut.second).toStdString());
+    // only the description file is checked here, it's parsed once the dashboard is opened
+    QFileInfo viewFile(view.path.c_str());
+    if (! viewFile.isFile() || ! viewFile.isReadable()) {
+      CORE_LOG("error", tr("%1: cannot read the description file %2").arg(view.name.c_str(), view.path.c_str()).toStdString());
       failedViews.append(failedViews.empty()? "": ", ").append(view.name);
       continue;
     }
 
-    QObject::connect(loadViewOut.first, SIGNAL(dashboardSelected(std::string)), this, SLOT(handleDashboardSelected(std::string)));
-
-    const auto DashboardName = loadViewOut.first->rootNode().name.toStdString();
-    Wt::WTemplate* thumbWidget = createThumbnailWidget(loadViewOut.first->thumbnailTitleBar(),
-                                                       loadViewOut.first->thumbnailProblemDetailBar(),
-                                                       loadViewOut.first->thumbnail());
-    thumbWidget->clicked().connect(std::bind(&WebMainUI::handleDashboardSelected, this, DashboardName));
-    m_thumbsLayout->addWidget(thumbWidget, thumbIndex / thumbPerRow, thumbIndex % thumbPerRow); // take the ownership of the widget
-    m_thumbsWidgets.insert(DashboardName, thumbWidget);
-
+    ViewThumbnailT thumbnail;
+    thumbnail.path = view.path;
+    thumbnail.problemDetailsBar = new Wt::WLabel();
+    thumbnail.widget = createThumbnailWidget(new Wt::WLabel(view.name), thumbnail.problemDetailsBar);
+    thumbnail.widget->clicked().connect(std::bind(&WebMainUI::handleDashboardSelected, this, view.name));
+    m_thumbsLayout->addWidget(thumbnail.widget, thumbIndex / thumbPerRow, thumbIndex % thumbPerRow); // take the ownership of the widget
+    m_thumbsWidgets.insert(view.name, thumbnail);
+    m_selectViewBox->addItem(view.name);
     ++thumbIndex;
   }
 
@@ -1006,20 +1225,19 @@ void WebMainUI::initOperatorDashboard(void)
 }
 
 
-Wt::WTemplate* WebMainUI::createThumbnailWidget(Wt::WLabel* titleWidget, Wt::WLabel* problemWidget, Wt::WImage* imageWidget)
+Wt::WTemplate* WebMainUI::createThumbnailWidget(Wt::WLabel* titleWidget, Wt::WLabel* problemWidget)
 {
   Wt::WTemplate* tpl = new Wt::WTemplate(Wt::WString::tr("dashboard-thumbnail.tpl"));
   tpl->setStyleClass("btn btn-unknown");
   tpl->bindWidget("thumb-titlebar", titleWidget);
   tpl->bindWidget("thumb-problem-details", problemWidget);
-  tpl->bindWidget("thumb-image", imageWidget);
+  tpl->bindEmpty("thumb-image");
   return tpl;
 }
 
 void WebMainUI::clearThumbnailTemplate(Wt::WTemplate* tpl)
 {
-  tpl->takeWidget("thumb-titlebar");
-  tpl->takeWidget("thumb-problem-details");
+  // only the image belongs to the dashboard, the labels are owned by the template
   tpl->takeWidget("thumb-image");
 }
 
@@ -1100,6 +1318,23 @@ void WebMainUI::startDashbaordUpdate(void)
 }
 
 
+void WebMainUI::scheduleDashboardRefresh(const QString& viewName)
+{
+  // owned by the UI, so that it can't fire once the session is gone
+  Wt::WTimer* tmpTimer(new Wt::WTimer(this));
+  tmpTimer->setInterval(DeferredRefreshDelay);
+  tmpTimer->start();
+  tmpTimer->timeout().connect(std::bind([=](){tmpTimer->stop();
+    delete tmpTimer;
+    // the dashboard may have been evicted in the meantime
+    auto loadedDashboardItem = m_dashboardMap.find(viewName);
+    if (loadedDashboardItem != m_dashboardMap.end()) {
+      refreshDashboard(*loadedDashboardItem);
+    }
+  }));
+}
+
+
 void WebMainUI::handleAuthSystemChanged(int authSystem)
 {
   switch (authSystem) {
@@ -1120,7 +1355,14 @@ void WebMainUI::handleLdapUsersMenu(void)
     showMessage(ngrt4n::OperationFailed, Q_TR("Denied, please enable LDAP authentication first"));
   } else {
     m_adminStackedContents.setCurrentWidget(m_ldapUserManager);
-    if (m_ldapUserManager->updateUserList() <= 0) {
+    if (m_ldapUserManager->isUpdating()) {
+      return;
+    }
+    // the pages are shown as they come, the list must not be reloaded meanwhile
+    m_menuLinks[MenuLdapUsers]->setDisabled(true);
+    int userCount = m_ldapUserManager->updateUserList();
+    m_menuLinks[MenuLdapUsers]->setDisabled(false);
+    if (userCount <= 0) {
       showMessage(ngrt4n::OperationFailed, m_ldapUserManager->lastError());
     }
     m_adminPanelTitle.setText(Q_TR("LDAP Users"));
@@ -1154,13 +1396,7 @@ void  WebMainUI::handleViewAclMenu(void)
 
 void WebMainUI::handleDeleteView(const std::string& viewName)
 {
-  auto loadedDashboardItem = m_dashboardMap.find(viewName.c_str());
-  if (loadedDashboardItem != m_dashboardMap.end()) {
-    WebDashboard* dashboard = *loadedDashboardItem;
-    m_dashboardStackedContents.removeWidget(dashboard);
-    delete (*loadedDashboardItem);
-    m_dashboardMap.remove(viewName.c_str());
-  }
+  unloadDashboard(viewName.c_str());
 }
 
 
@@ -1175,6 +1411,10 @@ void WebMainUI::handleUserEnableStatusChanged(int status, std::string data)
       showMessage(ngrt4n::OperationSucceeded,
                   Q_TR("LDAP authentication disabled for user ") + data);
       break;
+    case LdapUserManager::BatchEnableAuthSuccess:
+      showMessage(ngrt4n::OperationSucceeded,
+                  Q_TR("LDAP authentication enabled: ") + data);
+      break;
     case LdapUserManager::GenericError:
       showMessage(ngrt4n::OperationFailed, data);
       break;
@@ -1197,7 +1437,7 @@ void WebMainUI::setDashboardAsFrontStackedWidget(WebDashboard* dashboard)
   if (dashboard) {
     swicthFrontStackedWidgetTo(dashboard);
     dashboard->doJavascriptAutoResize();
-    m_selectViewBox->setCurrentIndex( m_selectViewBox->findText(dashboard->rootNode().name.toStdString()) );
+    m_selectViewBox->setCurrentIndex( m_selectViewBox->findText(m_dashboardMap.key(dashboard, dashboard->rootNode().name).toStdString()) );
     m_showOnlyProblemMsgsField->setHidden(false);
     m_currentDashboard = dashboard;
   }
@@ -1205,9 +1445,9 @@ void WebMainUI::setDashboardAsFrontStackedWidget(WebDashboard* dashboard)
 
 void WebMainUI::handleDashboardSelected(std::string viewName)
 {
-  auto loadedDashboardItem = m_dashboardMap.find(viewName.c_str());
-  if (loadedDashboardItem != m_dashboardMap.end()) {
-    setDashboardAsFrontStackedWidget(*loadedDashboardItem);
+  WebDashboard* dashboard = openDashboard(viewName);
+  if (dashboard) {
+    setDashboardAsFrontStackedWidget(dashboard);
   }
 }
 
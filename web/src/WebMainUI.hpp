@@ -115,7 +115,14 @@ private:
   };
   /** Signals */
   Wt::Signal<void> sessionTerminated;
-  typedef QMap<std::string, Wt::WTemplate*> ThumbnailMapT;
+
+  /** Lightweight tile of an operations view, available whether or not its dashboard is loaded */
+  struct ViewThumbnailT {
+    std::string path;
+    Wt::WTemplate* widget;
+    Wt::WLabel* problemDetailsBar;
+  };
+  typedef QMap<std::string, ViewThumbnailT> ThumbnailMapT;
 
 
   /** Private members **/
@@ -155,6 +162,8 @@ private:
   Wt::WStackedWidget m_dashboardStackedContents;
 
   QMap<QString, WebDashboard*> m_dashboardMap;
+  QStringList m_dashboardLru; // most recently used first
+  int m_maxLoadedDashboards;
   Wt::WText m_adminPanelTitle;
   InputSelector m_previewSelectorDialog;
 
@@ -212,6 +221,8 @@ private:
   void initOperatorDashboard(void);
   void setInternalPath(const std::string& path);
   void startDashbaordUpdate(void);
+  void scheduleDashboardRefresh(const QString& viewName);
+  void updateBiCharts(void);
   void hideAdminSettingsMenu(void);
   void showConditionalUiWidgets(const DbViewsT& views);
   void setupSettingsPage(void);
@@ -232,7 +243,14 @@ private:
   void clearThumbnailTemplate(Wt::WTemplate* tpl);
   bool createDirectory(const std::string& path, bool cleanContent);
   void resetFileUploader(void);
-  std::pair<WebDashboard*, QString> loadView(const std::string& path);
+  std::pair<WebDashboard*, QString> loadView(const std::string& path, const QString& viewName = QString());
+  WebDashboard* openDashboard(const std::string& viewName);
+  void unloadDashboard(const QString& viewName);
+  void touchDashboard(const QString& viewName);
+  void evictDashboards(void);
+  NodeT refreshDashboard(WebDashboard* dashboard);
+  bool applySharedStatus(WebDashboard* dashboard);
+  bool fetchViewStatus(WebDashboard* dashboard);
   Wt::WTemplate* createBreadCrumbsBarTpl(void);
   WebMsgDialog* createNotificationManager(void);
   UserFormView* createAccountPanel(void);
@@ -240,7 +258,7 @@ private:
   Wt::WDialog* createAboutDialog(void);
   Wt::WAnchor* createLogoLink(void);
   Wt::WWidget* createNotificationSection(void);
-  Wt::WTemplate* createThumbnailWidget(Wt::WLabel* titleWidget, Wt::WLabel* problemWidget, Wt::WImage* imageWidget);
+  Wt::WTemplate* createThumbnailWidget(Wt::WLabel* titleWidget, Wt::WLabel* problemWidget);
 };
 
 #endif // MAINWEBWINDOW_HPP
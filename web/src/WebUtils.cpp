@@ -40,11 +40,17 @@
 namespace {
   Logger* coreLogger = nullptr;
   Logger* reportdLogger = nullptr;
+
+  int minLogLevel(void)
+  {
+    std::string level = QString::fromLocal8Bit( qgetenv("REALOPINSIGHT_LOG_LEVEL") ).toLower().toStdString();
+    return level.empty() ? Logger::Info : Logger::parseLevel(level);
+  }
 }
 
 void ngrt4n::initCoreLogger(void)
 {
-  coreLogger = new Logger(Logger::CoreLogger, "/opt/realopinsight/log/");
+  coreLogger = new Logger(Logger::CoreLogger, "/opt/realopinsight/log/", minLogLevel());
 }
 
 void ngrt4n::freeCoreLogger(void)
@@ -55,7 +61,7 @@ void ngrt4n::freeCoreLogger(void)
 
 void ngrt4n::initReportdLogger(void)
 {
-  reportdLogger = new Logger(Logger::ReportdLogger, "/opt/realopinsight/log/");
+  reportdLogger = new Logger(Logger::ReportdLogger, "/opt/realopinsight/log/", minLogLevel());
 }
 
 void ngrt4n::freeReportdLogger(void)
@@ -239,6 +245,16 @@ Wt::WText* ngrt4n::createFontAwesomeTextButton(const std::string& iconClasses, c
   return link;
 }
 
+bool ngrt4n::isCoreLogEnabled(const std::string& level)
+{
+  return ! coreLogger || coreLogger->isEnabled(level);
+}
+
+bool ngrt4n::isReportdLogEnabled(const std::string& level)
+{
+  return ! reportdLogger || reportdLogger->isEnabled(level);
+}
+
 void ngrt4n::logCore(const std::string& level, const std::string& msg)
 {
   if (coreLogger) {
@@ -32,12 +32,24 @@
 
 
 #define Q_TR(s) QObject::tr(s).toStdString()
-#define CORE_LOG(level, msg) ngrt4n::logCore(level, msg)
-#define REPORTD_LOG(level, msg) ngrt4n::logReportd(level, msg)
+// the level is checked first so that filtered out messages are never built
+#define CORE_LOG(level, msg) do { if (ngrt4n::isCoreLogEnabled(level)) ngrt4n::logCore(level, msg); } while (0)
+#define REPORTD_LOG(level, msg) do { if (ngrt4n::isReportdLogEnabled(level)) ngrt4n::logReportd(level, msg); } while (0)
 
 
 namespace ngrt4n {
 
+  const int DefaultDbPoolSize = 10;
+  const int DefaultDbPoolWaitTimeout = 30; // in seconds
+  const int DefaultMaxLoadedDashboards = 16;
+  const double DefaultQosEpsilon = 0.5; // in percent
+  const int DefaultQosHeartbeat = 3600; // in seconds
+  const int DefaultReportdWorkers = 4;
+  const int DefaultLdapAuthCacheTtl = 300; // in seconds, 0 disables the cache
+  const int MaxIdleLdapConnections = 4;
+  const char DefaultStatusSnapshotPath[] = "/opt/realopinsight/data/status.snapshot";
+  const int SharedStatusGrace = 30; // in seconds, tolerated lag of the status shared by reportd
+
   enum OperationStatusT {
     OperationSucceeded,
     OperationFailed,
@@ -64,6 +76,8 @@ namespace ngrt4n {
   void initReportdLogger(void);
   void freeCoreLogger(void);
   void freeReportdLogger(void);
+  bool isCoreLogEnabled(const std::string& level);
+  bool isReportdLogEnabled(const std::string& level);
   void logCore(const std::string& level, const std::string& msg);
   void logReportd(const std::string& level, const std::string& msg);
   void logReportd(const std::string& level, const QString& msg);
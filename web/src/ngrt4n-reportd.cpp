@@ -24,11 +24,9 @@
 
 #include "dbo/src/DbSession.hpp"
 #include "WebBaseSettings.hpp"
-#include "QosCollector.hpp"
+#include "QosScheduler.hpp"
 #include "WebUtils.hpp"
 #include "Applications.hpp"
-#include "Notificator.hpp"
-#include "utils/smtpclient/MailSender.hpp"
 #include <unistd.h>
 #include <cstdio>
 #include <cstdlib>
@@ -36,73 +34,38 @@
 #include <QString>
 #include <getopt.h>
 #include <unistd.h>
-#include <regex>
+#include <csignal>
 
 
-void wait_for_interval(int interval)
+void handleStopSignal(int)
 {
-  unsigned int remaining = static_cast<unsigned int>(interval);
-  while ((remaining = sleep(remaining)) > 0);
+  QosScheduler::requestStop();
 }
 
-void runCollector(int period)
+
+void runCollector(int period, int workerCount)
 {
   ngrt4n::initReportdLogger();
 
-  WebBaseSettings settings;
-  DbSession dbSession(settings.getDbType(), settings.getDbConnectionString());
-  Notificator notificator(&dbSession);
-  while(1) {
-    QosDataList qosDataList;
-    NodeListT rootNodes;
-    qosDataList.clear();
-    rootNodes.clear();
-    DbViewsT vlist;
-    try {
-      vlist = dbSession.listViews();
-    } catch(const std::exception& ex) {
-      std::cerr << ex.what() <<"\n";
-    }
-
-    for (const auto& view: vlist) {
-      QosCollector collector;
-      collector.setDbSession(&dbSession);
-
-      auto initilizeOut = collector.initialize(&settings, view.path.c_str());
-      if (initilizeOut.first != ngrt4n::RcSuccess) {
-        REPORTD_LOG("error", QObject::tr("%1: %2").arg(view.name.c_str(), initilizeOut.second).toStdString());
-        continue;
-      }
-
-      collector.loadDataSources();
-      auto updateOut = collector.updateAllNodesStatus();
-      if (updateOut.first != ngrt4n::RcSuccess) {
-        REPORTD_LOG("error", updateOut.second.toStdString());
-        continue;
-      }
+  struct sigaction stopAction;
+  memset(&stopAction, 0, sizeof(stopAction));
+  stopAction.sa_handler = handleStopSignal;
+  sigemptyset(&stopAction.sa_mask);
+  sigaction(SIGTERM, &stopAction, nullptr);
+  sigaction(SIGINT, &stopAction, nullptr);
 
-      QosDataT qosData = collector.qosInfo();
-      if (qosData.view_name != view.name && std::regex_match(view.name, std::regex("Source[0-9]:.+"))) {
-        qosData.view_name = view.name;
-      }
-      qosData.timestamp = time(nullptr); // now
-      qosDataList.push_back(qosData);
-      rootNodes[qosData.view_name.c_str()] = collector.rootNode();
-      try {
-        dbSession.addQosData(qosData);
-      } catch(const std::exception& ex) {
-        REPORTD_LOG("error", std::string(ex.what()));
-      }
-    }
-
-    // handle notifications if applicable
-    if (settings.getNotificationType() != WebBaseSettings::NoNotification) {
-      for (const auto& qosEntry : qosDataList) {
-        notificator.handleNotification(rootNodes[qosEntry.view_name.c_str()], qosEntry);
-      }
-    }
-    wait_for_interval(period);
+  // one connection per worker, plus one for the scheduler and one for the notificator
+  WebBaseSettings settings;
+  DbConnectionPool::initShared(settings.getDbType(),
+                               settings.getDbConnectionString(),
+                               workerCount + 2,
+                               settings.getDbPoolWaitTimeout());
+  {
+    QosScheduler scheduler(period, workerCount);
+    scheduler.run();
   }
+  REPORTD_LOG("notice", QObject::tr("Reporting collector stopped"));
+  DbConnectionPool::releaseShared();
 
   ngrt4n::freeReportdLogger();
 }
@@ -112,15 +75,21 @@ int main(int argc, char **argv)
   RoiQApp qtApp(argc, argv);
 
   int period = 5;
+  int workerCount = ngrt4n::DefaultReportdWorkers;
   bool ok;
   int opt;
-  if ((opt = getopt(argc, argv, "t:dh")) != -1) {
+  while ((opt = getopt(argc, argv, "t:w:h")) != -1) {
     switch (opt) {
       case 't':
         period = QString(optarg).toInt(&ok);
         if (! ok || period < 1)
           period = 1;
         break;
+      case 'w':
+        workerCount = QString(optarg).toInt(&ok);
+        if (! ok || workerCount < 1)
+          workerCount = 1;
+        break;
       case 'h':
         break;
       default:
@@ -132,7 +101,7 @@ int main(int argc, char **argv)
 
   REPORTD_LOG("notice", QObject::tr("Reporting collector started"));
   REPORTD_LOG("notice", QObject::tr(" => Interval: %1 second(s)").arg(QString::number(period)));
-  runCollector(period); // convert period in seconds
+  runCollector(period, workerCount);
 
-  return qtApp.exec();
+  return EXIT_SUCCESS;
 }
@@ -49,10 +49,20 @@ int main(int argc, char **argv)
     server.setServerConfiguration(argc, argv);
     server.addEntryPoint(Wt::Application, &createRoiApplication, "", "favicon.ico");
 
+    // all the browser sessions draw their database connections from a single pool
+    WebBaseSettings settings;
+    DbConnectionPool::initShared(settings.getDbType(),
+                                 settings.getDbConnectionString(),
+                                 settings.getDbPoolSize(),
+                                 settings.getDbPoolWaitTimeout());
+
     if (server.start()) {
       Wt::WServer::waitForShutdown();
       server.stop();
     }
+    // the pending login sessions are written out while the connections are still available
+    LoginSessionCache::shared().stop();
+    DbConnectionPool::releaseShared();
   } catch (dbo::Exception& ex){
     std::cerr << QObject::tr("[FATAL] %1").arg(ex.what()).toStdString();
     exit(1);
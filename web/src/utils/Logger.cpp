@@ -1,44 +1,179 @@
 #include "Logger.hpp"
 #include <QDateTime>
+#include <QObject>
 #include "WebUtils.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
-const std::string Logger::m_coreSemaphoreName = "realopinsight_core_log_sem";
-const std::string Logger::m_reportdSemaphoreName = "realopinsight_reportd_log_sem";
-
-Logger::Logger(int module, const std::string& logdir)
-  : m_module(module)
+Logger::Logger(int module, const std::string& logdir, int minLevel)
+  : m_module(module),
+    m_minLevel(minLevel),
+    m_entries(new EntryT[QueueCapacity]),
+    m_enqueuePos(0),
+    m_dequeuePos(0),
+    m_droppedCount(0),
+    m_stopping(false)
 {
-  m_coreSemaphore = ngrt4n::createSemaphoreOrDie(m_coreSemaphoreName);
-  m_reportdSemaphore = ngrt4n::createSemaphoreOrDie(m_reportdSemaphoreName);
-  m_coreLogPath = QString("%1/realopinsight.log").arg(logdir.c_str()).toStdString();
-  m_monitorLogPath = QString("%1/realopinsight-reportd.log").arg(logdir.c_str()).toStdString();
-  m_coreLoggingStream.open(m_coreLogPath.c_str(), std::ios::out|std::ios::app);
-  monitorLoggingStream.open(m_monitorLogPath.c_str(), std::ios::out|std::ios::app);
+  QString logFile = (m_module == ReportdLogger) ? "realopinsight-reportd.log" : "realopinsight.log";
+  m_logPath = QString("%1/%2").arg(logdir.c_str(), logFile).toStdString();
+  m_logFd = open(m_logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP);
+  if (m_logFd < 0) {
+    std::cerr << "cannot open the log file " << m_logPath << ": " << strerror(errno) << ", logging to stderr" << std::endl;
+    m_logFd = STDERR_FILENO;
+  }
+
+  for (size_t index = 0; index < QueueCapacity; ++index) {
+    m_entries[index].sequence.store(index, std::memory_order_relaxed);
+  }
+
+  m_writer = std::thread(&Logger::runWriter, this);
 }
 
 
 Logger::~Logger()
 {
-  ngrt4n::releaseSemaphore(m_coreSemaphore);
-  ngrt4n::releaseSemaphore(m_reportdSemaphore);
-  m_coreLoggingStream.close();
-  monitorLoggingStream.close();
+  m_stopping.store(true);
+  m_writerCondition.notify_one();
+  m_writer.join();
+  if (m_logFd != STDERR_FILENO) {
+    close(m_logFd);
+  }
+}
+
+
+int Logger::parseLevel(const std::string& level)
+{
+  // the first letter is enough to tell the levels used across the code apart
+  switch (level.empty() ? 'i' : level[0]) {
+    case 'd': return Debug;
+    case 'n': return Notice;
+    case 'w': return Warning;
+    case 'e': return Error;
+    case 'f': return Fatal;
+    default: break;
+  }
+  return Info;
 }
 
 
 void Logger::log(const std::string& logLevel, const std::string& msg)
 {
-  std::string logEntry = QString("%1 [%2] %3")
-      .arg(QDateTime::currentDateTime().toString("yyyy-MM-ddThh:mm:s"),
-           logLevel.c_str(),msg.c_str()).toStdString();
-  if(m_module == ReportdLogger) {
-    sem_wait(m_reportdSemaphore);
-    monitorLoggingStream << logEntry << std::endl;
-    sem_post(m_reportdSemaphore);
-  } else {
-    sem_wait(m_coreSemaphore);
-    m_coreLoggingStream << logEntry << std::endl;
-    sem_post(m_coreSemaphore);
+  if (! isEnabled(logLevel)) {
+    return;
+  }
+
+  if (! push(logLevel, msg)) {
+    m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // wake the writer up early only when the ring is filling up
+  size_t pending = m_enqueuePos.load(std::memory_order_relaxed) - m_dequeuePos.load(std::memory_order_relaxed);
+  if (pending >= QueueCapacity / 4) {
+    m_writerCondition.notify_one();
+  }
+}
+
+
+bool Logger::push(const std::string& logLevel, const std::string& msg)
+{
+  // bounded multi-producer queue: a producer claims a slot by advancing the enqueue position,
+  // and publishes it by bumping the slot sequence once the entry is filled
+  EntryT* entry = nullptr;
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  for (;;) {
+    entry = &m_entries[pos & (QueueCapacity - 1)];
+    size_t sequence = entry->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  entry->timestamp = QDateTime::currentMSecsSinceEpoch();
+  entry->level = logLevel;
+  entry->msg = msg;
+  entry->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+
+void Logger::runWriter(void)
+{
+  while (! m_stopping.load()) {
+    {
+      std::unique_lock<std::mutex> lock(m_writerMutex);
+      m_writerCondition.wait_for(lock, std::chrono::milliseconds(FlushInterval));
+    }
+    drain();
   }
+  drain();
 }
 
+
+void Logger::drain(void)
+{
+  std::string buffer;
+  qint64 lastSecond = -1;
+  std::string timePrefix;
+
+  size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+  for (;;) {
+    EntryT& entry = m_entries[pos & (QueueCapacity - 1)];
+    if (entry.sequence.load(std::memory_order_acquire) != pos + 1) {
+      break;
+    }
+
+    // entries are mostly in the same second within a batch, format the date once for them
+    qint64 second = entry.timestamp / 1000;
+    if (second != lastSecond) {
+      lastSecond = second;
+      timePrefix = QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("yyyy-MM-ddThh:mm:ss").toStdString();
+    }
+    buffer.append(timePrefix).append(" [").append(entry.level).append("] ").append(entry.msg).append("\n");
+
+    entry.msg.clear();
+    entry.sequence.store(pos + QueueCapacity, std::memory_order_release);
+    m_dequeuePos.store(++pos, std::memory_order_relaxed);
+  }
+
+  size_t droppedCount = m_droppedCount.exchange(0, std::memory_order_relaxed);
+  if (droppedCount > 0) {
+    buffer.append(QDateTime::currentDateTime().toString("yyyy-MM-ddThh:mm:ss").toStdString())
+        .append(" [warning] ")
+        .append(QObject::tr("%1 log entries dropped, the log queue was full").arg(droppedCount).toStdString())
+        .append("\n");
+  }
+
+  if (! buffer.empty()) {
+    writeBuffer(buffer);
+  }
+}
+
+
+void Logger::writeBuffer(const std::string& buffer)
+{
+  const char* data = buffer.data();
+  size_t remaining = buffer.size();
+  while (remaining > 0) {
+    ssize_t written = write(m_logFd, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::cerr << "failed writing to the log file " << m_logPath << ": " << strerror(errno) << std::endl;
+      return;
+    }
+    data += written;
+    remaining -= static_cast<size_t>(written);
+  }
+}
@@ -3,9 +3,20 @@
 
 #include "WebUtils.hpp"
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
+/**
+ * Asynchronous file logger.
+ *
+ * Producers push entries into a bounded lock-free ring and return immediately; a background
+ * thread drains the ring, formats the entries and appends them to the log file with one write
+ * per batch. The file is opened with O_APPEND so that batches from several processes sharing
+ * the same file never interleave. When the ring is full, new entries are dropped and counted.
+ */
 class Logger
 {
 public:
@@ -13,23 +24,55 @@ public:
     CoreLogger = 0,
     ReportdLogger = 1
   };
-  static const std::string m_coreSemaphoreName;
-  static const std::string m_reportdSemaphoreName;
-  Logger(int module, const std::string& logdir);
+
+  enum LevelT {
+    Debug = 0,
+    Info = 1,
+    Notice = 2,
+    Warning = 3,
+    Error = 4,
+    Fatal = 5
+  };
+
+  static const size_t QueueCapacity = 8192; // must be a power of two
+  static const int FlushInterval = 200; // in milliseconds
+
+  Logger(int module, const std::string& logdir, int minLevel = Info);
   virtual ~Logger();
 
+  static int parseLevel(const std::string& level);
+  bool isEnabled(const std::string& level) const { return parseLevel(level) >= m_minLevel; }
   void log(const std::string& logLevel, const std::string& msg);
-  std::string getCoreLogPath(void) const {return m_coreLogPath; }
+  std::string getLogPath(void) const {return m_logPath; }
 
 
 private:
+  struct EntryT {
+    std::atomic<size_t> sequence;
+    qint64 timestamp;
+    std::string level;
+    std::string msg;
+  };
+
   int m_module;
-  std::ofstream m_coreLoggingStream;
-  std::ofstream monitorLoggingStream;
-  std::string m_coreLogPath;
-  std::string m_monitorLogPath;
-  sem_t* m_coreSemaphore;
-  sem_t* m_reportdSemaphore;
+  int m_minLevel;
+  int m_logFd;
+  std::string m_logPath;
+
+  std::unique_ptr<EntryT[]> m_entries;
+  std::atomic<size_t> m_enqueuePos;
+  std::atomic<size_t> m_dequeuePos;
+  std::atomic<size_t> m_droppedCount;
+
+  std::atomic<bool> m_stopping;
+  std::mutex m_writerMutex;
+  std::condition_variable m_writerCondition;
+  std::thread m_writer;
+
+  bool push(const std::string& logLevel, const std::string& msg);
+  void runWriter(void);
+  void drain(void);
+  void writeBuffer(const std::string& buffer);
 };
 
 
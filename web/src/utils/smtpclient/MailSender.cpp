@@ -9,7 +9,9 @@ MailSender::MailSender(const QString& smtpHost,
   : QxtSmtp(),
     m_host(smtpHost),
     m_port(port),
-    m_connected(false)
+    m_sessionState(Disconnected),
+    m_stopping(false),
+    m_currentMailId(0)
 {
   addEvents();
   setUsername(username.toLatin1());
@@ -17,17 +19,9 @@ MailSender::MailSender(const QString& smtpHost,
   setStartTlsDisabled(! useStartSsl);
 }
 
-int MailSender::send(const QString& sender,
-                     const QStringList& recipients,
-                     const QString& subject,
-                     const QString& body)
-{
-  if (! m_connected) {
-    connectToHost(m_host, m_port);
-    if (m_eventSynchonizer.exec() != 0)
-      return -1;
-  }
 
+void MailSender::sendQueued(QString sender, QStringList recipients, QString subject, QString body)
+{
   QxtMailMessage message;
 
   message.setExtraHeader("From", QString("%1 <%2>").arg(APP_NAME, sender));
@@ -42,64 +36,133 @@ int MailSender::send(const QString& sender,
   message.setSubject(subject);
   message.setBody(body);
 
-  int messageId = QxtSmtp::send(message);
-  m_spool.insert(messageId, message);
-  int exitCode = m_eventSynchonizer.exec();
+  m_outbox.enqueue(message);
+  sendNext();
+}
+
+
+void MailSender::stopWhenIdle(void)
+{
+  m_stopping = true;
+  sendNext();
+}
+
+
+void MailSender::sendNext(void)
+{
+  if (isIdle()) {
+    if (m_stopping) {
+      Q_EMIT drained();
+    }
+    return;
+  }
+
+  // a single mail is in progress at a time, so that each outcome is told apart
+  if (m_currentMailId != 0) {
+    return;
+  }
+
+  switch (m_sessionState) {
+    case Disconnected:
+      m_sessionState = Connecting;
+      connectToHost(m_host, m_port);
+      break;
+    case Ready:
+      m_currentMail = m_outbox.dequeue();
+      m_currentMailId = QxtSmtp::send(m_currentMail);
+      break;
+    default:
+      break;
+  }
+}
+
 
-  return exitCode;
+void MailSender::completeCurrentMail(void)
+{
+  m_currentMailId = 0;
+  m_currentMail = QxtMailMessage();
+  // the next mail is handed over once the SMTP client is done with the current one
+  QMetaObject::invokeMethod(this, "sendNext", Qt::QueuedConnection);
 }
 
 
-void MailSender::handleConnected(void)
+void MailSender::handleAuthenticated(void)
 {
-  m_connected = true;
-  m_eventSynchonizer.exit(0);
+  m_sessionState = Ready;
+  sendNext();
 }
 
+
 void MailSender::handleConnectionFailed(const QByteArray& msg)
 {
-  m_connected = false;
-  m_lastError = tr("SMTP connection failed: %1").arg(QString(msg));
-  m_eventSynchonizer.exit(-1);
+  m_sessionState = Disconnected;
+
+  // the mail waiting for the session is given up, the next ones try a new connection
+  QStringList recipients;
+  if (m_currentMailId != 0) {
+    recipients = m_currentMail.recipients();
+  } else if (! m_outbox.isEmpty()) {
+    recipients = m_outbox.dequeue().recipients();
+  }
+  REPORTD_LOG("error", tr("[Notificator] SMTP connection failed: %1. Mail to %2 not sent").arg(QString(msg), recipients.join(",")));
+
+  completeCurrentMail();
+  socket()->abort();
 }
 
+
 void MailSender::handleMailFailed(int mailID, int errorCode, const QByteArray& msg)
 {
-  m_spool.remove(mailID);
-  m_lastError = tr("SMTP sending failed (code: %1): %2. Mail Id: %3"
-                   ).arg(QString::number(errorCode),
-                         msg,
-                         QString::number(mailID));
-  m_eventSynchonizer.exit(-1);
+  if (mailID != m_currentMailId) {
+    return;
+  }
+  REPORTD_LOG("error", tr("[Notificator] SMTP sending failed (code: %1): %2. Mail to %3 not sent"
+                          ).arg(QString::number(errorCode),
+                                QString(msg),
+                                m_currentMail.recipients().join(",")));
+  completeCurrentMail();
 }
 
-void MailSender::handleSenderRejected(int mailID, const QString& address, const QByteArray & msg)
+
+void MailSender::handleMailRejected(int mailID, const QString& address, const QByteArray& msg)
 {
-  m_spool.remove(mailID);
-  m_lastError = tr("SMTP rejected mail sender."
-                   " Message: %1. Address: %2."
-                   ).arg(QString(msg), address);
-  m_eventSynchonizer.exit(-1);
+  // the mail goes on with the other recipients, and fails if none of them is accepted
+  if (mailID == m_currentMailId) {
+    REPORTD_LOG("warning", tr("[Notificator] SMTP rejected address %1: %2").arg(address, QString(msg)));
+  }
 }
 
+
 void MailSender::handleMailSent(int mailID)
 {
-  m_lastError = tr("Email successfuly sent to %1"
-                   ).arg(m_spool[mailID].recipients().join(","));
+  if (mailID != m_currentMailId) {
+    return;
+  }
+  REPORTD_LOG("info", tr("[Notificator] Email successfuly sent to %1").arg(m_currentMail.recipients().join(",")));
+  completeCurrentMail();
+}
+
 
-  m_spool.remove(mailID);
-  m_eventSynchonizer.exit(0);
+void MailSender::handleDisconnected(void)
+{
+  // the connection is kept open between mails, reopen it on the next one if the server closed it
+  m_sessionState = Disconnected;
+  if (m_currentMailId != 0) {
+    REPORTD_LOG("error", tr("[Notificator] SMTP connection closed while sending to %1").arg(m_currentMail.recipients().join(",")));
+    completeCurrentMail();
+  }
 }
 
 
 void MailSender::addEvents(void)
 {
-  connect(this, SIGNAL(connected()), this, SLOT(handleConnected()));
+  connect(this, SIGNAL(authenticated()), this, SLOT(handleAuthenticated()));
   connect(this, SIGNAL(connectionFailed(const QByteArray&)), this, SLOT(handleConnectionFailed(const QByteArray&)));
   connect(this, SIGNAL(authenticationFailed(const QByteArray&)), this, SLOT(handleConnectionFailed(const QByteArray&)));
   connect(this, SIGNAL(encryptionFailed(const QByteArray&)), this, SLOT(handleConnectionFailed(const QByteArray&)));
   connect(this, SIGNAL(mailFailed(int, int, const QByteArray&)), this, SLOT(handleMailFailed(int, int, const QByteArray&)));
-  connect(this, SIGNAL(senderRejected(int, const QString&, const QByteArray&)), this, SLOT(handleSenderRejected(int, const QString&, const QByteArray&)));
-  connect(this, SIGNAL(recipientRejected(int, const QString&, const QByteArray&)), this, SLOT(handleSenderRejected(int, const QString&, const QByteArray&)));
+  connect(this, SIGNAL(senderRejected(int, const QString&, const QByteArray&)), this, SLOT(handleMailRejected(int, const QString&, const QByteArray&)));
+  connect(this, SIGNAL(recipientRejected(int, const QString&, const QByteArray&)), this, SLOT(handleMailRejected(int, const QString&, const QByteArray&)));
   connect(this, SIGNAL(mailSent(int)), this, SLOT(handleMailSent(int)));
+  connect(this, SIGNAL(disconnected()), this, SLOT(handleDisconnected()));
 }
@@ -1,8 +1,13 @@
 #ifndef MAILSENDER_HPP
 #define MAILSENDER_HPP
 #include "qxtsmtp.h"
-#include <QEventLoop>
+#include <QQueue>
 
+/**
+ * SMTP sender keeping its connection open between mails. Queued mails are handed to the
+ * server one at a time once the session is authenticated, and the outcome of each one is
+ * logged. The sender, its socket included, must be created in the thread it's used from.
+ */
 class MailSender : public QxtSmtp
 {
   Q_OBJECT
@@ -13,28 +18,40 @@ public:
              const QString& username,
              const QString& password,
              bool disableSsl);
-  int send(const QString& sender,
-           const QStringList& recipients,
-           const QString& subject,
-           const QString& body);
-  QString lastError(void) const {return m_lastError;}
+  bool isIdle(void) const {return m_currentMailId == 0 && m_outbox.isEmpty();}
+
+public Q_SLOTS:
+  void sendQueued(QString sender, QStringList recipients, QString subject, QString body);
+  void stopWhenIdle(void);
+
+Q_SIGNALS:
+  void drained(void);
 
 protected Q_SLOTS:
-  void handleConnected(void);
+  void sendNext(void);
+  void handleAuthenticated(void);
   void handleConnectionFailed(const QByteArray& msg);
   void handleMailFailed(int mailID, int errorCode, const QByteArray& msg);
-  void handleSenderRejected(int mailID, const QString& address, const QByteArray & msg);
+  void handleMailRejected(int mailID, const QString& address, const QByteArray& msg);
   void handleMailSent(int mailID);
+  void handleDisconnected(void);
 
 private:
+  enum SessionStateT {
+    Disconnected,
+    Connecting,
+    Ready
+  };
+
   QString m_host;
   int m_port;
-  bool m_connected;
-  QString m_lastError;
-  QEventLoop m_eventSynchonizer;
-  QMap<int, QxtMailMessage> m_spool;
+  SessionStateT m_sessionState;
+  bool m_stopping;
+  QQueue<QxtMailMessage> m_outbox;
+  QxtMailMessage m_currentMail;
+  int m_currentMailId;
 
   void addEvents(void);
-
+  void completeCurrentMail(void);
 };
 #endif // MAILSENDER_HPP